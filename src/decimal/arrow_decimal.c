@@ -0,0 +1,199 @@
+#include "decimal/arrow_decimal.h"
+#include "decimal/bit_util.h"
+#include "decimal/logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// "d:" and two int32 with their separators
+#define kMaxFormatLength 32
+
+/* schema */
+typedef struct SchemaPrivate {
+  char format[kMaxFormatLength];
+} SchemaPrivate;
+
+static void ReleaseSchema(struct ArrowSchema *schema) {
+  free(schema->private_data);
+  schema->release = NULL;
+}
+
+decimal_status_t dec128_export_arrow_schema(int32_t precision, int32_t scale,
+                                            struct ArrowSchema *schema) {
+  DCHECK_NE(schema, NULL);
+  if (precision < 1 || precision > DEC128_MAX_PRECISION) {
+    return DEC128_STATUS_ERROR;
+  }
+  SchemaPrivate *priv = malloc(sizeof(SchemaPrivate));
+  if (!priv) {
+    return DEC128_STATUS_ERROR;
+  }
+  snprintf(priv->format, sizeof(priv->format), "d:%d,%d", precision, scale);
+
+  schema->format = priv->format;
+  schema->name = "";
+  schema->metadata = NULL;
+  schema->flags = ARROW_FLAG_NULLABLE;
+  schema->n_children = 0;
+  schema->children = NULL;
+  schema->dictionary = NULL;
+  schema->release = ReleaseSchema;
+  schema->private_data = priv;
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* array */
+typedef struct ArrayPrivate {
+  const void *buffers[2];
+  void (*release_buffers)(void *);
+  void *owner;
+} ArrayPrivate;
+
+static void ReleaseArray(struct ArrowArray *array) {
+  ArrayPrivate *priv = array->private_data;
+  if (priv->release_buffers) {
+    priv->release_buffers(priv->owner);
+  }
+  free(priv);
+  array->release = NULL;
+}
+
+static int64_t CountNulls(const uint8_t *validity, size_t n) {
+  size_t valid = 0;
+  size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    uint64_t word;
+    memcpy(&word, validity + i / 8, sizeof(word));
+    valid += DEC128_POPCOUNT64(word);
+  }
+  for (; i + 8 <= n; i += 8) {
+    valid += DEC128_POPCOUNT32(validity[i / 8]);
+  }
+  if (i < n) {
+    valid += DEC128_POPCOUNT32(validity[i / 8] & ((1U << (n - i)) - 1));
+  }
+  return (int64_t)(n - valid);
+}
+
+decimal_status_t dec128_export_arrow_array(const decimal128_t *values,
+                                           const uint8_t *validity, size_t n,
+                                           void (*release_buffers)(void *),
+                                           void *owner,
+                                           struct ArrowArray *array) {
+  DCHECK_NE(array, NULL);
+  ArrayPrivate *priv = malloc(sizeof(ArrayPrivate));
+  if (!priv) {
+    return DEC128_STATUS_ERROR;
+  }
+  const int64_t null_count = validity ? CountNulls(validity, n) : 0;
+  priv->buffers[0] = null_count ? validity : NULL;
+  priv->buffers[1] = values;
+  priv->release_buffers = release_buffers;
+  priv->owner = owner;
+
+  array->length = (int64_t)n;
+  array->null_count = null_count;
+  array->offset = 0;
+  array->n_buffers = 2;
+  array->n_children = 0;
+  array->buffers = priv->buffers;
+  array->children = NULL;
+  array->dictionary = NULL;
+  array->release = ReleaseArray;
+  array->private_data = priv;
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* import */
+// Parse an int32 in decimal, returns the end or NULL
+static const char *ParseFormatInt32(const char *p, int32_t *out) {
+  const bool negative = *p == '-';
+  if (negative) {
+    p++;
+  }
+  if (*p < '0' || *p > '9') {
+    return NULL;
+  }
+  int64_t v = 0;
+  for (; *p >= '0' && *p <= '9'; p++) {
+    v = v * 10 + (*p - '0');
+    if (v > INT32_MAX) {
+      return NULL;
+    }
+  }
+  *out = (int32_t)(negative ? -v : v);
+  return p;
+}
+
+// Parse "d:precision,scale" with an optional ",128" bit width
+static bool ParseDecimalFormat(const char *format, int32_t *precision,
+                               int32_t *scale) {
+  const char *p = format;
+  if (p[0] != 'd' || p[1] != ':') {
+    return false;
+  }
+  p = ParseFormatInt32(p + 2, precision);
+  if (!p || *p != ',') {
+    return false;
+  }
+  p = ParseFormatInt32(p + 1, scale);
+  if (!p) {
+    return false;
+  }
+  if (*p == ',') {
+    int32_t bit_width;
+    p = ParseFormatInt32(p + 1, &bit_width);
+    if (!p || bit_width != 128) {
+      return false;
+    }
+  }
+  return *p == 0 && *precision >= 1 && *precision <= DEC128_MAX_PRECISION;
+}
+
+decimal_status_t dec128_import_arrow(const struct ArrowSchema *schema,
+                                     const struct ArrowArray *array,
+                                     const decimal128_t **values,
+                                     const uint8_t **validity, size_t *n,
+                                     int32_t *precision, int32_t *scale) {
+  int32_t parsed_precision, parsed_scale;
+  if (!schema || !schema->release || !schema->format ||
+      !ParseDecimalFormat(schema->format, &parsed_precision, &parsed_scale)) {
+    return DEC128_STATUS_ERROR;
+  }
+  if (!array || !array->release || array->n_buffers != 2 ||
+      array->n_children != 0 || array->dictionary || array->length < 0 ||
+      array->offset < 0) {
+    return DEC128_STATUS_ERROR;
+  }
+
+  const decimal128_t *data = array->buffers[1];
+  if (array->length > 0 &&
+      (!data || (uintptr_t)data % sizeof(uint64_t) != 0)) {
+    return DEC128_STATUS_ERROR;
+  }
+  const uint8_t *bitmap = array->buffers[0];
+  if (array->null_count == 0) {
+    bitmap = NULL;
+  }
+  if (bitmap) {
+    if (array->offset % 8 != 0) {
+      return DEC128_STATUS_ERROR;
+    }
+    bitmap += array->offset / 8;
+  }
+
+  *values = data ? data + array->offset : NULL;
+  if (validity) {
+    *validity = bitmap;
+  } else if (bitmap) {
+    // the caller would silently read nulls as values
+    return DEC128_STATUS_ERROR;
+  }
+  *n = (size_t)array->length;
+  if (precision) {
+    *precision = parsed_precision;
+  }
+  if (scale) {
+    *scale = parsed_scale;
+  }
+  return DEC128_STATUS_SUCCESS;
+}
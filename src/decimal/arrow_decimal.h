@@ -0,0 +1,89 @@
+#ifndef _ARROW_DECIMAL_H_
+#define _ARROW_DECIMAL_H_
+
+#include "decimal/basic_decimal.h"
+
+DEC128_EXTERN_BEGIN
+
+/*
+ * Arrow C Data Interface for decimal128 columns.
+ *
+ * decimal128_t has the memory layout of an Arrow decimal128 value (16 bytes,
+ * native word order), so columns are exchanged without copying: exported
+ * arrays point at the caller's buffers and imported arrays are read in
+ * place. The structs below are the ABI-stable definitions from the Arrow
+ * specification, guarded so they can coexist with Arrow's own headers.
+ */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray *);
+  // Opaque producer-specific data
+  void *private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+/* Describe DECIMAL(precision, scale) as a nullable field with format
+ * "d:precision,scale". The schema must be released with schema->release. */
+decimal_status_t dec128_export_arrow_schema(int32_t precision, int32_t scale,
+                                            struct ArrowSchema *schema);
+
+/* Wrap n values and their validity bitmap (may be NULL) as an ArrowArray
+ * without copying. The buffers must stay valid until array->release is
+ * called, which then calls release_buffers(owner) if it is not NULL, so
+ * ownership can be handed to the consumer. */
+decimal_status_t dec128_export_arrow_array(const decimal128_t *values,
+                                           const uint8_t *validity, size_t n,
+                                           void (*release_buffers)(void *),
+                                           void *owner,
+                                           struct ArrowArray *array);
+
+/* View an imported decimal128 array in place. precision and scale come from
+ * the schema format, values and validity (NULL when there are no nulls)
+ * point into the array buffers, already adjusted for array->offset; pass a
+ * NULL validity to only accept arrays without nulls. The array still belongs
+ * to the caller, who releases it once done with the values. Returns
+ * DEC128_STATUS_ERROR for another type, a released array, a misaligned
+ * values buffer or a validity bitmap whose offset is not a multiple of 8. */
+decimal_status_t dec128_import_arrow(const struct ArrowSchema *schema,
+                                     const struct ArrowArray *array,
+                                     const decimal128_t **values,
+                                     const uint8_t **validity, size_t *n,
+                                     int32_t *precision, int32_t *scale);
+
+DEC128_EXTERN_END
+
+#endif
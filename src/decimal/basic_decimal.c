@@ -1,3 +1,9 @@
+// This file exports the definitions of inline_decimal.h (comparison, negate,
+// abs, sum, subtract, multiply and bitwise operations), which are only
+// static inline in the callers built with DEC128_INLINE
+#undef DEC128_INLINE
+#define DEC128_INLINE_FN
+
 #include "decimal/basic_decimal.h"
 #include "decimal/bit_util.h"
 #include "decimal/decimal_internal.h"
@@ -29,156 +35,54 @@ static const decimal128_t kDecimal128Zero = {0};
 #define UINT128_HIGH_BITS(v) (v >> 64)
 #define UINT128_LOW_BITS(v) (v & kInt64Mask)
 
-static __uint128_t dec128_to_uint128(decimal128_t v) {
-  return (((__uint128_t)dec128_high_bits(v)) << 64) | dec128_low_bits(v);
-}
-
-/* comparison */
-bool dec128_cmpeq(decimal128_t left, decimal128_t right) {
-  return dec128_high_bits(left) == dec128_high_bits(right) &&
-         dec128_low_bits(left) == dec128_low_bits(right);
-}
-
-bool dec128_cmpne(decimal128_t left, decimal128_t right) {
-  return !dec128_cmpeq(left, right);
-}
-
-bool dec128_cmplt(decimal128_t left, decimal128_t right) {
-  return dec128_high_bits(left) < dec128_high_bits(right) ||
-         (dec128_high_bits(left) == dec128_high_bits(right) &&
-          dec128_low_bits(left) < dec128_low_bits(right));
-}
-
-bool dec128_cmpgt(decimal128_t left, decimal128_t right) {
-  return dec128_cmplt(right, left);
+/* checked arithmetic */
+static inline decimal_status_t OverflowStatus(bool overflow) {
+  return overflow ? DEC128_STATUS_OVERFLOW : DEC128_STATUS_SUCCESS;
 }
 
-bool dec128_cmpge(decimal128_t left, decimal128_t right) {
-  return !dec128_cmplt(left, right);
-}
-
-bool dec128_cmple(decimal128_t left, decimal128_t right) {
-  return !dec128_cmpgt(left, right);
-}
-
-/* negate */
-decimal128_t dec128_negate(decimal128_t v) {
-  uint64_t result_lo = ~dec128_low_bits(v) + 1;
-  int64_t result_hi = ~dec128_high_bits(v);
-  if (result_lo == 0) {
-    result_hi = SafeSignedAdd(result_hi, 1);
-  }
-
-  decimal128_t res = dec128_from_hilo(result_hi, result_lo);
-  return res;
-}
-
-/* absolute */
-decimal128_t *dec128_abs_inplace(decimal128_t *v) {
-  decimal128_t zero = {};
-  if (dec128_cmplt(*v, zero)) {
-    *v = dec128_negate(*v);
-  }
-  return v;
+decimal_status_t dec128_sum_checked(decimal128_t left, decimal128_t right,
+                                    decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+  __int128_t r;
+  const bool overflow =
+      Int128AddOverflow(dec128_to_int128(left), dec128_to_int128(right), &r);
+  *out = dec128_from_int128(r);
+  return OverflowStatus(overflow);
 }
 
-decimal128_t dec128_abs(decimal128_t v) {
-  decimal128_t res = v;
-  dec128_abs_inplace(&res);
-  return res;
+decimal_status_t dec128_subtract_checked(decimal128_t left,
+                                         decimal128_t right,
+                                         decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+  __int128_t r;
+  const bool overflow = Int128SubtractOverflow(dec128_to_int128(left),
+                                               dec128_to_int128(right), &r);
+  *out = dec128_from_int128(r);
+  return OverflowStatus(overflow);
 }
 
-/* sum */
-decimal128_t dec128_sum(decimal128_t left, decimal128_t right) {
-  int64_t result_hi =
-      SafeSignedAdd(dec128_high_bits(left), dec128_high_bits(right));
-  uint64_t result_lo = dec128_low_bits(left) + dec128_low_bits(right);
-  result_hi = SafeSignedAdd(result_hi, result_lo < dec128_low_bits(left));
-  return dec128_from_hilo(result_hi, result_lo);
+decimal_status_t dec128_multiply_checked(decimal128_t left,
+                                         decimal128_t right,
+                                         decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+  __int128_t r;
+  const bool overflow = Int128MultiplyOverflow(dec128_to_int128(left),
+                                               dec128_to_int128(right), &r);
+  *out = dec128_from_int128(r);
+  return OverflowStatus(overflow);
 }
 
-/* subtract */
-decimal128_t dec128_subtract(decimal128_t left, decimal128_t right) {
-  int64_t result_hi =
-      SafeSignedSubtract(dec128_high_bits(left), dec128_high_bits(right));
-  uint64_t result_lo = dec128_low_bits(left) - dec128_low_bits(right);
-  result_hi = SafeSignedSubtract(result_hi, result_lo > dec128_low_bits(left));
-  return dec128_from_hilo(result_hi, result_lo);
+decimal_status_t dec128_negate_checked(decimal128_t v, decimal128_t *out) {
+  return dec128_subtract_checked(kDecimal128Zero, v, out);
 }
 
-/* multiply */
-decimal128_t dec128_multiply(decimal128_t left, decimal128_t right) {
-  const bool negate = dec128_sign(left) != dec128_sign(right);
-  decimal128_t x = dec128_abs(left);
-  decimal128_t y = dec128_abs(right);
-  __uint128_t r = dec128_to_uint128(x);
-  r *= dec128_to_uint128(y);
-  decimal128_t res =
-      dec128_from_hilo((int64_t)UINT128_HIGH_BITS(r), UINT128_LOW_BITS(r));
-  if (negate) {
-    res = dec128_negate(res);
-  }
-  return res;
-}
-
-/* bitwise and */
-decimal128_t dec128_bitwise_and(decimal128_t left, decimal128_t right) {
-  decimal128_t res;
-  res.array[0] = left.array[0] & right.array[0];
-  res.array[1] = left.array[1] & right.array[1];
-  return res;
-}
-
-/* bitwise or */
-decimal128_t dec128_bitwise_or(decimal128_t left, decimal128_t right) {
-  decimal128_t res;
-  res.array[0] = left.array[0] | right.array[0];
-  res.array[1] = left.array[1] | right.array[1];
-  return res;
-}
-
-/* bitwise shift left */
-decimal128_t dec128_bitwise_shift_left(decimal128_t v, uint32_t bits) {
-  decimal128_t res = v;
-  if (bits != 0) {
-    uint64_t result_lo;
-    int64_t result_hi;
-    if (bits < 64) {
-      result_hi = SafeLeftShift(dec128_high_bits(v), bits);
-      result_hi |= (dec128_low_bits(v) >> (64 - bits));
-      result_lo = dec128_low_bits(v) << bits;
-    } else if (bits < 128) {
-      result_hi = (int64_t)(dec128_low_bits(v) << (bits - 64));
-      result_lo = 0;
-    } else {
-      result_hi = 0;
-      result_lo = 0;
-    }
-    res = dec128_from_hilo(result_hi, result_lo);
-  }
-  return res;
-}
-
-/* bitwise shift right */
-decimal128_t dec128_bitwise_shift_right(decimal128_t v, uint32_t bits) {
-  decimal128_t res = v;
-  if (bits != 0) {
-    uint64_t result_lo;
-    int64_t result_hi;
-    if (bits < 64) {
-      result_lo = dec128_low_bits(v) >> bits;
-      result_lo |= (uint64_t)(dec128_high_bits(v)) << (64 - bits);
-      result_hi = dec128_high_bits(v) >> bits;
-    } else if (bits < 128) {
-      result_lo = (uint64_t)(dec128_high_bits(v) >> (bits - 64));
-      result_hi = dec128_high_bits(v) >> 63;
-    } else {
-      result_hi = dec128_high_bits(v) >> 63;
-      result_lo = (uint64_t)(result_hi);
-    }
-    res = dec128_from_hilo(result_hi, result_lo);
+decimal_status_t dec128_abs_checked(decimal128_t v, decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+  if (dec128_is_negative(v)) {
+    return dec128_negate_checked(v, out);
   }
-  return res;
+  *out = v;
+  return DEC128_STATUS_SUCCESS;
 }
 
 /* get scale multiplier */
@@ -210,10 +114,15 @@ decimal128_t dec128_max(int32_t precision) {
 
 /* fits in precision */
 bool dec128_fits_in_precision(decimal128_t v, int32_t precision) {
-  if (!(precision > 0 && precision < 38)) {
+  if (!(precision > 0 && precision <= DEC128_MAX_PRECISION)) {
     return false;
   }
-  return dec128_cmplt(dec128_abs(v), kDecimal128PowersOfTen[precision]);
+  // compare the magnitude unsigned, dec128_abs(INT128_MIN) is still negative
+  __uint128_t m = (__uint128_t)dec128_to_int128(v);
+  if (dec128_is_negative(v)) {
+    m = -m;
+  }
+  return m < UInt128PowerOfTen(precision);
 }
 
 int32_t dec128_count_leading_binary_zeros(decimal128_t v) {
@@ -356,73 +265,15 @@ static decimal_status_t BuildFromArray(decimal128_t *value,
   return DEC128_STATUS_SUCCESS;
 }
 
-/// \brief Do a division where the divisor fits into a single 32 bit value.
-static inline decimal_status_t
-SingleDivide(const uint32_t *dividend, int64_t dividend_length,
-             uint32_t divisor, decimal128_t *remainder,
-             bool dividend_was_negative, bool divisor_was_negative,
-             decimal128_t *result) {
-  uint64_t r = 0;
-  const int64_t kDecimalArrayLength = DEC128_BIT_WIDTH / sizeof(uint32_t) + 1;
-  uint32_t result_array[kDecimalArrayLength];
-  for (int64_t j = 0; j < dividend_length; j++) {
-    r <<= 32;
-    r += dividend[j];
-    result_array[j] = (uint32_t)(r / divisor);
-    r %= divisor;
-  }
-
-  decimal_status_t status =
-      BuildFromArray(result, result_array, dividend_length);
-  if (status != DEC128_STATUS_SUCCESS) {
-    return status;
-  }
-
-  *remainder = dec128_from_int64((int64_t)(r));
-  FixDivisionSigns(result, remainder, dividend_was_negative,
-                   divisor_was_negative);
-
-  return DEC128_STATUS_SUCCESS;
-}
-
-static inline decimal_status_t DecimalDivide(decimal128_t dividend,
-                                             decimal128_t divisor,
-                                             decimal128_t *result,
-                                             decimal128_t *remainder) {
-  const int64_t kDecimalArrayLength = DEC128_BIT_WIDTH / sizeof(uint32_t);
-  // Split the dividend and divisor into integer pieces so that we can
-  // work on them.
-  uint32_t dividend_array[kDecimalArrayLength + 1];
-  uint32_t divisor_array[kDecimalArrayLength];
-  bool dividend_was_negative;
-  bool divisor_was_negative;
-  // leave an extra zero before the dividend
-  dividend_array[0] = 0;
-  int64_t dividend_length =
-      FillInArray(dividend, dividend_array + 1, &dividend_was_negative) + 1;
-  int64_t divisor_length =
-      FillInArray(divisor, divisor_array, &divisor_was_negative);
-
-  // Handle some of the easy cases.
-  if (dividend_length <= divisor_length) {
-    *remainder = dividend;
-    *result = (decimal128_t){0};
-    return DEC128_STATUS_SUCCESS;
-  }
-
-  if (divisor_length == 0) {
-    return DEC128_STATUS_DIVIDEDBYZERO;
-  }
-
-  if (divisor_length == 1) {
-    return SingleDivide(dividend_array, dividend_length, divisor_array[0],
-                        remainder, dividend_was_negative, divisor_was_negative,
-                        result);
-  }
-
+/// \brief Knuth long division of big endian uint32 arrays.
+///
+/// dividend_array must have a leading zero and divisor_length >= 2. The
+/// quotient (dividend_length - divisor_length digits) is written to
+/// result_array and the remainder is left in dividend_array.
+static void LongDivideArray(uint32_t *dividend_array, int64_t dividend_length,
+                            uint32_t *divisor_array, int64_t divisor_length,
+                            uint32_t *result_array) {
   int64_t result_length = dividend_length - divisor_length;
-  uint32_t result_array[kDecimalArrayLength];
-  DCHECK_LE(result_length, kDecimalArrayLength);
 
   // Normalize by shifting both by a multiple of 2 so that
   // the digit guessing is better. The requirement is that
@@ -442,16 +293,14 @@ static inline decimal_status_t DecimalDivide(decimal128_t dividend,
     }
 
     // catch all of the cases where guess is two too large and most of the
-    // cases where it is one too large
-    uint32_t rhat =
-        (uint32_t)(high_dividend - guess * ((uint64_t)divisor_array[0]));
-    while (((uint64_t)divisor_array[1]) * guess >
-           (((uint64_t)rhat) << 32) + dividend_array[j + 2]) {
+    // cases where it is one too large. rhat needs more than 32 bits when
+    // the guess was clamped to UINT_MAX, and then the guess is already
+    // close enough.
+    uint64_t rhat = high_dividend - guess * ((uint64_t)divisor_array[0]);
+    while (rhat <= UINT_MAX && ((uint64_t)divisor_array[1]) * guess >
+                                   (rhat << 32) + dividend_array[j + 2]) {
       --guess;
       rhat += divisor_array[0];
-      if (((uint64_t)rhat) < divisor_array[0]) {
-        break;
-      }
     }
 
     // subtract off the guess * divisor from the dividend
@@ -486,6 +335,84 @@ static inline decimal_status_t DecimalDivide(decimal128_t dividend,
 
   // denormalize the remainder
   ShiftArrayRight(dividend_array, dividend_length, normalize_bits);
+}
+
+static inline decimal_status_t DecimalDivide(decimal128_t dividend,
+                                             decimal128_t divisor,
+                                             decimal128_t *result,
+                                             decimal128_t *remainder) {
+  // Fast path for a divisor that fits in 64 bits, which covers most real
+  // world divisors: a native 64-bit division when the dividend fits too,
+  // otherwise two 128-by-64 divisions.
+  const bool dividend_negative = dec128_is_negative(dividend);
+  const bool divisor_negative = dec128_is_negative(divisor);
+  const __uint128_t divisor_bits = (__uint128_t)dec128_to_int128(divisor);
+  const __uint128_t divisor_magnitude =
+      divisor_negative ? -divisor_bits : divisor_bits;
+  if (UINT128_HIGH_BITS(divisor_magnitude) == 0) {
+    const uint64_t d = (uint64_t)divisor_magnitude;
+    if (DEC128_PREDICT_FALSE(d == 0)) {
+      return DEC128_STATUS_DIVIDEDBYZERO;
+    }
+    const __uint128_t dividend_bits = (__uint128_t)dec128_to_int128(dividend);
+    const __uint128_t n = dividend_negative ? -dividend_bits : dividend_bits;
+    const uint64_t n1 = (uint64_t)UINT128_HIGH_BITS(n);
+    const uint64_t n0 = (uint64_t)UINT128_LOW_BITS(n);
+    __uint128_t q;
+    __uint128_t r;
+    if (n1 == 0) {
+      q = n0 / d;
+      r = n0 % d;
+    } else {
+      uint64_t r0;
+      const uint64_t q1 = n1 / d;
+      const uint64_t q0 = Div2By1Native(n1 % d, n0, d, &r0);
+      q = ((__uint128_t)q1 << 64) | q0;
+      r = r0;
+    }
+    if (dividend_negative != divisor_negative) {
+      q = -q;
+    }
+    if (dividend_negative) {
+      r = -r;
+    }
+    *result = dec128_from_hilo((int64_t)UINT128_HIGH_BITS(q),
+                               (uint64_t)UINT128_LOW_BITS(q));
+    *remainder = dec128_from_hilo((int64_t)UINT128_HIGH_BITS(r),
+                                  (uint64_t)UINT128_LOW_BITS(r));
+    return DEC128_STATUS_SUCCESS;
+  }
+
+  const int64_t kDecimalArrayLength = DEC128_BIT_WIDTH / sizeof(uint32_t);
+  // Split the dividend and divisor into integer pieces so that we can
+  // work on them.
+  uint32_t dividend_array[kDecimalArrayLength + 1];
+  uint32_t divisor_array[kDecimalArrayLength];
+  bool dividend_was_negative;
+  bool divisor_was_negative;
+  // leave an extra zero before the dividend
+  dividend_array[0] = 0;
+  int64_t dividend_length =
+      FillInArray(dividend, dividend_array + 1, &dividend_was_negative) + 1;
+  int64_t divisor_length =
+      FillInArray(divisor, divisor_array, &divisor_was_negative);
+
+  // Handle some of the easy cases.
+  if (dividend_length <= divisor_length) {
+    *remainder = dividend;
+    *result = (decimal128_t){0};
+    return DEC128_STATUS_SUCCESS;
+  }
+
+  // divisors below 2^64 took the fast path above
+  DCHECK_GE(divisor_length, 3);
+
+  int64_t result_length = dividend_length - divisor_length;
+  uint32_t result_array[kDecimalArrayLength];
+  DCHECK_LE(result_length, kDecimalArrayLength);
+
+  LongDivideArray(dividend_array, dividend_length, divisor_array,
+                  divisor_length, result_array);
 
   // return result and remainder
   decimal_status_t status = BuildFromArray(result, result_array, result_length);
@@ -508,6 +435,29 @@ decimal_status_t dec128_divide(decimal128_t dividend, decimal128_t divisor,
   return DecimalDivide(dividend, divisor, result, remainder);
 }
 
+/* divide by a power of ten */
+// Same result as dec128_divide(v, kDecimal128PowersOfTen[k], ...), on the
+// magnitude with precomputed reciprocals instead of long division.
+static inline void DivideByPowerOfTen(decimal128_t v, int32_t k,
+                                      decimal128_t *result,
+                                      decimal128_t *remainder) {
+  const bool negative = dec128_is_negative(v);
+  __uint128_t x = (__uint128_t)dec128_to_int128(v);
+  if (negative) {
+    x = -x;
+  }
+  __uint128_t r;
+  __uint128_t q = UInt128DivideByPowerOfTen(x, k, &r);
+  if (negative) {
+    q = -q;
+    r = -r;
+  }
+  *result = dec128_from_hilo((int64_t)UINT128_HIGH_BITS(q),
+                             (uint64_t)UINT128_LOW_BITS(q));
+  *remainder = dec128_from_hilo((int64_t)UINT128_HIGH_BITS(r),
+                                (uint64_t)UINT128_LOW_BITS(r));
+}
+
 /* get whole and fraction */
 decimal_status_t dec128_get_whole_and_fraction(decimal128_t v, int32_t scale,
                                                decimal128_t *whole,
@@ -515,10 +465,8 @@ decimal_status_t dec128_get_whole_and_fraction(decimal128_t v, int32_t scale,
   DCHECK_GE(scale, 0);
   DCHECK_LE(scale, 38);
 
-  decimal128_t multiplier = kDecimal128PowersOfTen[scale];
-  decimal_status_t status = dec128_divide(v, multiplier, whole, fraction);
-  DCHECK_EQ(status, DEC128_STATUS_SUCCESS);
-  return status;
+  DivideByPowerOfTen(v, scale, whole, fraction);
+  return DEC128_STATUS_SUCCESS;
 }
 
 /* rescale */
@@ -530,9 +478,7 @@ static bool rescale_would_cause_data_loss(decimal128_t value,
   if (delta_scale < 0) {
     DCHECK(dec128_cmpne(multiplier, kDecimal128Zero));
     decimal128_t remainder;
-    decimal_status_t status =
-        dec128_divide(value, multiplier, result, &remainder);
-    DCHECK_EQ(status, DEC128_STATUS_SUCCESS);
+    DivideByPowerOfTen(value, -delta_scale, result, &remainder);
     return dec128_cmpne(remainder, kDecimal128Zero);
   }
 
@@ -580,16 +526,411 @@ decimal128_t dec128_reduce_scale_by(decimal128_t v, int32_t reduce_by,
     return v;
   }
 
-  decimal128_t divisor = kDecimal128PowersOfTen[reduce_by];
-  decimal128_t result;
-  decimal128_t remainder;
-  decimal_status_t s = dec128_divide(v, divisor, &result, &remainder);
+  // round half away from zero on the magnitude
+  const bool negative = dec128_is_negative(v);
+  __uint128_t x = (__uint128_t)dec128_to_int128(v);
+  if (negative) {
+    x = -x;
+  }
+  __uint128_t remainder;
+  __uint128_t result = UInt128DivideByPowerOfTen(x, reduce_by, &remainder);
+  const __uint128_t half =
+      (__uint128_t)dec128_to_int128(kDecimal128HalfPowersOfTen[reduce_by]);
+  if (round && remainder >= half) {
+    result++;
+  }
+  if (negative) {
+    result = -result;
+  }
+  return dec128_from_hilo((int64_t)UINT128_HIGH_BITS(result),
+                          (uint64_t)UINT128_LOW_BITS(result));
+}
+
+static inline bool IsValidScaleChange(int32_t delta) {
+  return delta >= 0 && delta <= DEC128_MAX_SCALE;
+}
+
+decimal_status_t dec128_rescale_checked(decimal128_t v, int32_t original_scale,
+                                        int32_t new_scale, decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+  const int64_t delta = (int64_t)new_scale - original_scale;
+  if (delta < -DEC128_MAX_SCALE || delta > DEC128_MAX_SCALE) {
+    return DEC128_STATUS_ERROR;
+  }
+  return dec128_rescale(v, original_scale, new_scale, out);
+}
+
+decimal_status_t dec128_increase_scale_by_checked(decimal128_t v,
+                                                  int32_t increase_by,
+                                                  decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+  if (!IsValidScaleChange(increase_by)) {
+    return DEC128_STATUS_ERROR;
+  }
+  return dec128_multiply_checked(v, kDecimal128PowersOfTen[increase_by], out);
+}
+
+decimal_status_t dec128_reduce_scale_by_checked(decimal128_t v,
+                                                int32_t reduce_by, bool round,
+                                                decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+  if (!IsValidScaleChange(reduce_by)) {
+    return DEC128_STATUS_ERROR;
+  }
+  *out = dec128_reduce_scale_by(v, reduce_by, round);
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* decimal256 */
+static const decimal256_t kDecimal256Zero = {0};
+
+decimal_status_t dec256_to_dec128(decimal256_t v, decimal128_t *out) {
+  uint64_t words[4];
+  dec256_to_le_words(v, words);
+  // the two high words must be the sign extension of the low 128 bits
+  const uint64_t ext = (uint64_t)((int64_t)words[1] >> 63);
+  if (words[2] != ext || words[3] != ext) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = dec128_from_hilo((int64_t)words[1], words[0]);
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* comparison */
+bool dec256_cmpeq(decimal256_t left, decimal256_t right) {
+  return memcmp(left.array, right.array, sizeof(left.array)) == 0;
+}
+
+bool dec256_cmpne(decimal256_t left, decimal256_t right) {
+  return !dec256_cmpeq(left, right);
+}
+
+bool dec256_cmplt(decimal256_t left, decimal256_t right) {
+  uint64_t l[4], r[4];
+  dec256_to_le_words(left, l);
+  dec256_to_le_words(right, r);
+  if (l[3] != r[3]) {
+    return (int64_t)l[3] < (int64_t)r[3];
+  }
+  for (int i = 2; i >= 0; i--) {
+    if (l[i] != r[i]) {
+      return l[i] < r[i];
+    }
+  }
+  return false;
+}
+
+bool dec256_cmpgt(decimal256_t left, decimal256_t right) {
+  return dec256_cmplt(right, left);
+}
+
+bool dec256_cmpge(decimal256_t left, decimal256_t right) {
+  return !dec256_cmplt(left, right);
+}
+
+bool dec256_cmple(decimal256_t left, decimal256_t right) {
+  return !dec256_cmpgt(left, right);
+}
+
+/* negate */
+decimal256_t dec256_negate(decimal256_t v) {
+  uint64_t words[4];
+  dec256_to_le_words(v, words);
+  uint64_t carry = 1;
+  for (int i = 0; i < 4; i++) {
+    words[i] = ~words[i] + carry;
+    carry = carry && words[i] == 0;
+  }
+  return dec256_from_le_words(words);
+}
+
+/* absolute */
+decimal256_t dec256_abs(decimal256_t v) {
+  return dec256_is_negative(v) ? dec256_negate(v) : v;
+}
+
+/* sum */
+decimal256_t dec256_sum(decimal256_t left, decimal256_t right) {
+  uint64_t l[4], r[4];
+  dec256_to_le_words(left, l);
+  dec256_to_le_words(right, r);
+  uint64_t carry = 0;
+  for (int i = 0; i < 4; i++) {
+    __uint128_t t = (__uint128_t)l[i] + r[i] + carry;
+    l[i] = (uint64_t)t;
+    carry = (uint64_t)(t >> 64);
+  }
+  return dec256_from_le_words(l);
+}
+
+/* subtract */
+decimal256_t dec256_subtract(decimal256_t left, decimal256_t right) {
+  uint64_t l[4], r[4];
+  dec256_to_le_words(left, l);
+  dec256_to_le_words(right, r);
+  uint64_t borrow = 0;
+  for (int i = 0; i < 4; i++) {
+    __uint128_t t = (__uint128_t)l[i] - r[i] - borrow;
+    l[i] = (uint64_t)t;
+    borrow = (uint64_t)(t >> 64) & 1;
+  }
+  return dec256_from_le_words(l);
+}
+
+/* multiply */
+decimal256_t dec256_multiply(decimal256_t left, decimal256_t right) {
+  // the low 256 bits of the product do not depend on the signs
+  uint64_t l[4], r[4], res[4] = {0};
+  dec256_to_le_words(left, l);
+  dec256_to_le_words(right, r);
+  for (int i = 0; i < 4; i++) {
+    uint64_t carry = 0;
+    for (int j = 0; i + j < 4; j++) {
+      __uint128_t t = (__uint128_t)l[i] * r[j] + res[i + j] + carry;
+      res[i + j] = (uint64_t)t;
+      carry = (uint64_t)(t >> 64);
+    }
+  }
+  return dec256_from_le_words(res);
+}
+
+decimal256_t dec128_multiply_wide(decimal128_t left, decimal128_t right) {
+  // |left * right| < 2^254, so the product always fits
+  return dec256_multiply(dec256_from_dec128(left), dec256_from_dec128(right));
+}
+
+/// Expands a 256-bit value into a big endian array of uint32_t holding its
+/// absolute value, without leading zeros. See FillInArray.
+static int64_t FillInArray256(decimal256_t value, uint32_t *array,
+                              bool *was_negative) {
+  uint64_t words[4];
+  dec256_to_le_words(dec256_abs(value), words);
+  *was_negative = dec256_is_negative(value);
+
+  int64_t next_index = 0;
+  for (int64_t i = 3; i >= 0; i--) {
+    if (words[i] != 0) {
+      if (words[i] <= UINT_MAX) {
+        array[next_index++] = (uint32_t)(words[i]);
+        i--;
+      }
+      for (int64_t j = i; j >= 0; j--) {
+        array[next_index++] = (uint32_t)(words[j] >> 32);
+        array[next_index++] = (uint32_t)(words[j]);
+      }
+      break;
+    }
+  }
+  return next_index;
+}
+
+/// \brief Build a decimal256_t from a big endian array of uint32_t.
+static decimal_status_t BuildFromArray256(decimal256_t *value,
+                                          const uint32_t *array,
+                                          int64_t length) {
+  uint64_t result_array[DEC256_NWORDS];
+  decimal_status_t status =
+      BuildFromArrayToInt64(result_array, DEC256_NWORDS, array, length);
+  if (status != DEC128_STATUS_SUCCESS) {
+    return status;
+  }
+  memcpy(value->array, result_array, sizeof(result_array));
+  return DEC128_STATUS_SUCCESS;
+}
+
+static inline void FixDivisionSigns256(decimal256_t *result,
+                                       decimal256_t *remainder,
+                                       bool dividend_was_negative,
+                                       bool divisor_was_negative) {
+  if (dividend_was_negative != divisor_was_negative) {
+    *result = dec256_negate(*result);
+  }
+
+  if (dividend_was_negative) {
+    *remainder = dec256_negate(*remainder);
+  }
+}
+
+static decimal_status_t DecimalDivide256(decimal256_t dividend,
+                                         decimal256_t divisor,
+                                         decimal256_t *result,
+                                         decimal256_t *remainder) {
+  const int64_t kDecimalArrayLength = DEC256_BIT_WIDTH / 32;
+  uint32_t dividend_array[kDecimalArrayLength + 1];
+  uint32_t divisor_array[kDecimalArrayLength];
+  uint32_t result_array[kDecimalArrayLength + 1];
+  bool dividend_was_negative;
+  bool divisor_was_negative;
+  // leave an extra zero before the dividend
+  dividend_array[0] = 0;
+  int64_t dividend_length =
+      FillInArray256(dividend, dividend_array + 1, &dividend_was_negative) + 1;
+  int64_t divisor_length =
+      FillInArray256(divisor, divisor_array, &divisor_was_negative);
+
+  if (dividend_length <= divisor_length) {
+    *remainder = dividend;
+    *result = kDecimal256Zero;
+    return DEC128_STATUS_SUCCESS;
+  }
+
+  if (divisor_length == 0) {
+    return DEC128_STATUS_DIVIDEDBYZERO;
+  }
+
+  decimal_status_t status;
+  if (divisor_length <= 2) {
+    // divisor fits in 64 bits, one native 128-by-64 division per word
+    const uint64_t d =
+        divisor_length == 1
+            ? divisor_array[0]
+            : ((uint64_t)divisor_array[0] << 32) | divisor_array[1];
+    uint64_t words[DEC256_NWORDS];
+    dec256_to_le_words(dec256_abs(dividend), words);
+    uint64_t r = 0;
+    for (int i = DEC256_NWORDS - 1; i >= 0; i--) {
+      words[i] = Div2By1Native(r, words[i], d, &r);
+    }
+    *result = dec256_from_le_words(words);
+    const uint64_t remainder_words[DEC256_NWORDS] = {r, 0, 0, 0};
+    *remainder = dec256_from_le_words(remainder_words);
+  } else {
+    int64_t result_length = dividend_length - divisor_length;
+    LongDivideArray(dividend_array, dividend_length, divisor_array,
+                    divisor_length, result_array);
+    status = BuildFromArray256(result, result_array, result_length);
+    if (status != DEC128_STATUS_SUCCESS) {
+      return status;
+    }
+    status = BuildFromArray256(remainder, dividend_array, dividend_length);
+    if (status != DEC128_STATUS_SUCCESS) {
+      return status;
+    }
+  }
+
+  FixDivisionSigns256(result, remainder, dividend_was_negative,
+                      divisor_was_negative);
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* divide */
+decimal_status_t dec256_divide(decimal256_t dividend, decimal256_t divisor,
+                               decimal256_t *result, decimal256_t *remainder) {
+  return DecimalDivide256(dividend, divisor, result, remainder);
+}
+
+/* get whole and fraction */
+decimal_status_t dec256_get_whole_and_fraction(decimal256_t v, int32_t scale,
+                                               decimal256_t *whole,
+                                               decimal256_t *fraction) {
+  DCHECK_GE(scale, 0);
+  DCHECK_LE(scale, DEC256_MAX_SCALE);
+
+  decimal256_t multiplier = kDecimal256PowersOfTen[scale];
+  decimal_status_t status = dec256_divide(v, multiplier, whole, fraction);
+  DCHECK_EQ(status, DEC128_STATUS_SUCCESS);
+  return status;
+}
+
+/* get scale multiplier */
+decimal256_t dec256_get_scale_multiplier(int32_t scale) {
+  DCHECK_GE(scale, 0);
+  DCHECK_LE(scale, DEC256_MAX_SCALE);
+
+  return kDecimal256PowersOfTen[scale];
+}
+
+/* get half scale mutlipler */
+decimal256_t dec256_get_half_scale_multiplier(int32_t scale) {
+  DCHECK_GE(scale, 0);
+  DCHECK_LE(scale, DEC256_MAX_SCALE);
+
+  return kDecimal256HalfPowersOfTen[scale];
+}
+
+decimal256_t dec256_max(int32_t precision) {
+  DCHECK_GE(precision, 0);
+  DCHECK_LE(precision, DEC256_MAX_PRECISION);
+
+  return dec256_subtract(kDecimal256PowersOfTen[precision],
+                         dec256_from_int64(1));
+}
+
+/* fits in precision */
+bool dec256_fits_in_precision(decimal256_t v, int32_t precision) {
+  if (!(precision > 0 && precision <= DEC256_MAX_PRECISION)) {
+    return false;
+  }
+  return dec256_cmplt(dec256_abs(v), kDecimal256PowersOfTen[precision]);
+}
+
+/* rescale */
+static bool rescale_would_cause_data_loss256(decimal256_t value,
+                                             int32_t delta_scale,
+                                             decimal256_t multiplier,
+                                             decimal256_t *result) {
+  if (delta_scale < 0) {
+    DCHECK(dec256_cmpne(multiplier, kDecimal256Zero));
+    decimal256_t remainder;
+    decimal_status_t status =
+        dec256_divide(value, multiplier, result, &remainder);
+    DCHECK_EQ(status, DEC128_STATUS_SUCCESS);
+    return dec256_cmpne(remainder, kDecimal256Zero);
+  }
+
+  *result = dec256_multiply(value, multiplier);
+  return dec256_is_negative(value) ? dec256_cmpgt(*result, value)
+                                   : dec256_cmplt(*result, value);
+}
+
+decimal_status_t dec256_rescale(decimal256_t v, int32_t original_scale,
+                                int32_t new_scale, decimal256_t *out) {
+  DCHECK_NE(out, NULL);
+
+  if (original_scale == new_scale) {
+    *out = v;
+    return DEC128_STATUS_SUCCESS;
+  }
+
+  const int32_t delta_scale = new_scale - original_scale;
+  const int32_t abs_delta_scale = abs(delta_scale);
+
+  decimal256_t multiplier = dec256_get_scale_multiplier(abs_delta_scale);
+
+  const bool rescale_data_loss =
+      rescale_would_cause_data_loss256(v, delta_scale, multiplier, out);
+
+  if (rescale_data_loss) {
+    return DEC128_STATUS_RESCALEDATALOSS;
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal256_t dec256_increase_scale_by(decimal256_t v, int32_t increase_by) {
+  DCHECK_GE(increase_by, 0);
+  DCHECK_LE(increase_by, DEC256_MAX_SCALE);
+
+  return dec256_multiply(v, kDecimal256PowersOfTen[increase_by]);
+}
+
+decimal256_t dec256_reduce_scale_by(decimal256_t v, int32_t reduce_by,
+                                    bool round) {
+  DCHECK_GE(reduce_by, 0);
+  DCHECK_LE(reduce_by, DEC256_MAX_SCALE);
+
+  if (reduce_by == 0) {
+    return v;
+  }
+
+  decimal256_t divisor = kDecimal256PowersOfTen[reduce_by];
+  decimal256_t result;
+  decimal256_t remainder;
+  decimal_status_t s = dec256_divide(v, divisor, &result, &remainder);
   DCHECK(s == DEC128_STATUS_SUCCESS);
   if (round) {
-    if (dec128_cmpge(dec128_abs(remainder),
-                     kDecimal128HalfPowersOfTen[reduce_by])) {
-      decimal128_t sign = dec128_from_int64(dec128_sign(v));
-      result = dec128_sum(result, sign);
+    if (dec256_cmpge(dec256_abs(remainder),
+                     kDecimal256HalfPowersOfTen[reduce_by])) {
+      result = dec256_sum(result, dec256_from_int64(dec256_sign(v)));
     }
   }
   return result;
@@ -45,13 +45,28 @@ typedef struct decimal128_t {
   uint64_t array[NWORDS];
 } decimal128_t;
 
-/* comparison */
+#define DEC256_MAX_PRECISION 76
+#define DEC256_MAX_SCALE 76
+#define DEC256_MAX_STRLEN 96
+
+#define DEC256_BIT_WIDTH 256
+#define DEC256_NWORDS (256 / 64)
+
+/* words are in native-endian order, like decimal128_t */
+typedef struct decimal256_t {
+  uint64_t array[DEC256_NWORDS];
+} decimal256_t;
+
+/* comparison, static inline with DEC128_INLINE like the other operations of
+ * inline_decimal.h */
+#ifndef DEC128_INLINE
 bool dec128_cmpeq(decimal128_t left, decimal128_t right);
 bool dec128_cmpne(decimal128_t left, decimal128_t right);
 bool dec128_cmplt(decimal128_t left, decimal128_t right);
 bool dec128_cmpgt(decimal128_t left, decimal128_t right);
 bool dec128_cmpge(decimal128_t left, decimal128_t right);
 bool dec128_cmple(decimal128_t left, decimal128_t right);
+#endif
 
 void dec128_print(FILE *fp, decimal128_t v, int precision, int scale);
 
@@ -98,6 +113,19 @@ static inline decimal128_t dec128_from_hilo(int64_t high, uint64_t low) {
 decimal_status_t dec128_from_string(const char *s, decimal128_t *out,
                                     int32_t *precision, int32_t *scale);
 
+// Parse the decimal at the start of [first, last), which needs no NUL
+// terminator. On success *end points past the number; when end is NULL the
+// whole range must be a number. Returns DEC128_STATUS_OVERFLOW if it has more
+// than DEC128_MAX_PRECISION significant digits.
+decimal_status_t dec128_from_chars(const char *first, const char *last,
+                                   decimal128_t *out, int32_t *precision,
+                                   int32_t *scale, const char **end);
+
+// Sign extend length (1 to 16) bytes of big-endian two's complement, the
+// Parquet and Avro decimal encoding. DEC128_STATUS_ERROR for other lengths.
+decimal_status_t dec128_from_big_endian(const uint8_t *bytes, int32_t length,
+                                        decimal128_t *out);
+
 decimal_status_t dec128_from_float(float real, decimal128_t *out,
                                    int32_t precision, int32_t scale);
 
@@ -119,12 +147,25 @@ double dec128_to_double(decimal128_t v, int32_t scale);
 
 void dec128_to_string(decimal128_t v, char *out, int32_t scale);
 
+// Format v with scale like dec128_to_string into [first, last), without a NUL
+// terminator. Returns the number of characters written, or -1 if the range
+// is too small; DEC128_MAX_STRLEN - 1 characters are always enough for a
+// scale in [-DEC128_MAX_PRECISION, DEC128_MAX_PRECISION].
+int32_t dec128_to_chars(decimal128_t v, char *first, char *last,
+                        int32_t scale);
+
+// Write v as big-endian two's complement in the fewest bytes, at most 16.
+// Returns the number of bytes written.
+int32_t dec128_to_big_endian(decimal128_t v, uint8_t *out);
+
+#ifndef DEC128_INLINE
 /* absolute */
 decimal128_t *dec128_abs_inplace(decimal128_t *v);
 decimal128_t dec128_abs(decimal128_t v);
 
 /* negate */
 decimal128_t dec128_negate(decimal128_t v);
+#endif
 
 // return 1 if positive or zero, -1 if strictly negative
 static inline int64_t dec128_sign(decimal128_t v) {
@@ -135,15 +176,38 @@ static inline bool dec128_is_negative(decimal128_t v) {
   return ((int64_t)v.array[HIGHWORDINDEX]) < 0;
 }
 
+#ifndef DEC128_INLINE
 decimal128_t dec128_sum(decimal128_t left, decimal128_t right);
 
 decimal128_t dec128_subtract(decimal128_t left, decimal128_t right);
 
 decimal128_t dec128_multiply(decimal128_t left, decimal128_t right);
+#endif
 
 decimal_status_t dec128_divide(decimal128_t dividend, decimal128_t divisor,
                                decimal128_t *result, decimal128_t *remainder);
 
+/*
+ * Checked arithmetic: DEC128_STATUS_OVERFLOW if the exact result does not
+ * fit in 128 bits. out is set either way, to the result truncated to 128
+ * bits as the unchecked operation returns it.
+ */
+decimal_status_t dec128_sum_checked(decimal128_t left, decimal128_t right,
+                                    decimal128_t *out);
+
+decimal_status_t dec128_subtract_checked(decimal128_t left,
+                                         decimal128_t right,
+                                         decimal128_t *out);
+
+decimal_status_t dec128_multiply_checked(decimal128_t left,
+                                         decimal128_t right,
+                                         decimal128_t *out);
+
+decimal_status_t dec128_negate_checked(decimal128_t v, decimal128_t *out);
+
+decimal_status_t dec128_abs_checked(decimal128_t v, decimal128_t *out);
+
+#ifndef DEC128_INLINE
 decimal128_t dec128_bitwise_and(decimal128_t left, decimal128_t right);
 
 decimal128_t dec128_bitwise_or(decimal128_t left, decimal128_t right);
@@ -151,6 +215,7 @@ decimal128_t dec128_bitwise_or(decimal128_t left, decimal128_t right);
 decimal128_t dec128_bitwise_shift_left(decimal128_t v, uint32_t bits);
 
 decimal128_t dec128_bitwise_shift_right(decimal128_t v, uint32_t bits);
+#endif
 
 static inline int64_t dec128_high_bits(decimal128_t v) {
 #if DEC128_LITTLE_ENDIAN
@@ -168,6 +233,21 @@ static inline uint64_t dec128_low_bits(decimal128_t v) {
 #endif
 }
 
+/* 128-bit integer conversions, and the trivial operations with
+ * DEC128_INLINE */
+#include "decimal/inline_decimal.h"
+
+/* hash for use in hash tables, not stable across library versions */
+static inline uint64_t dec128_hash(decimal128_t v) {
+  uint64_t h = v.array[0] ^ (v.array[1] * 0x9E3779B97F4A7C15ULL);
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h >> 33;
+  h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
 decimal_status_t dec128_get_whole_and_fraction(decimal128_t v, int32_t scale,
                                                decimal128_t *whole,
                                                decimal128_t *fraction);
@@ -188,6 +268,21 @@ decimal128_t dec128_increase_scale_by(decimal128_t v, int32_t increase_by);
 decimal128_t dec128_reduce_scale_by(decimal128_t v, int32_t reduce_by,
                                     bool round);
 
+/* The scale functions above only check their arguments in checked builds
+ * (see DEC128_CHECK_LEVEL). These validate them in every build and return
+ * DEC128_STATUS_ERROR for a scale change outside [0, DEC128_MAX_SCALE]. */
+decimal_status_t dec128_rescale_checked(decimal128_t v, int32_t original_scale,
+                                        int32_t new_scale, decimal128_t *out);
+
+// DEC128_STATUS_OVERFLOW past 128 bits
+decimal_status_t dec128_increase_scale_by_checked(decimal128_t v,
+                                                  int32_t increase_by,
+                                                  decimal128_t *out);
+
+decimal_status_t dec128_reduce_scale_by_checked(decimal128_t v,
+                                                int32_t reduce_by, bool round,
+                                                decimal128_t *out);
+
 bool dec128_fits_in_precision(decimal128_t v, int32_t precision);
 
 int32_t dec128_count_leading_binary_zeros(decimal128_t v);
@@ -205,10 +300,14 @@ void dec128_DIV_precision_scale(int p1, int s1, int p2, int s2, int *precision,
 void dec128_MOD_precision_scale(int p1, int s1, int p2, int s2, int *precision,
                                 int *scale);
 
-// ret_precision and ret_scale must be calculated by dec_DIV_precison_scale
-decimal128_t dec128_divide_exact(decimal128_t A, int32_t Ascale, decimal128_t B,
-                                 int32_t Bscale, int ret_precision,
-                                 int ret_scale);
+// ret_precision and ret_scale must be calculated by dec_DIV_precison_scale.
+// The quotient is rounded half up to ret_scale. Returns
+// DEC128_STATUS_DIVIDEDBYZERO, or DEC128_STATUS_OVERFLOW if it does not fit
+// in ret_precision.
+decimal_status_t dec128_divide_exact(decimal128_t A, int32_t Ascale,
+                                     decimal128_t B, int32_t Bscale,
+                                     int ret_precision, int ret_scale,
+                                     decimal128_t *out);
 
 decimal128_t dec128_floor(decimal128_t A, int scale);
 
@@ -218,6 +317,130 @@ decimal128_t dec128_mod(decimal128_t A, int Ascale, decimal128_t B, int Bscale);
 
 decimal128_t dec128_round(decimal128_t A, int32_t Ascale, int32_t rscale);
 
+// dec128_mod without aborting or overflowing when A and B are brought to
+// the same scale. DEC128_STATUS_DIVIDEDBYZERO, or DEC128_STATUS_ERROR if the
+// scales are more than DEC128_MAX_SCALE apart.
+decimal_status_t dec128_mod_checked(decimal128_t A, int32_t Ascale,
+                                    decimal128_t B, int32_t Bscale,
+                                    decimal128_t *out);
+
+// dec128_round without aborting, rscale may also be 0. DEC128_STATUS_ERROR
+// for a negative rscale, DEC128_STATUS_OVERFLOW if rounding up overflows.
+decimal_status_t dec128_round_checked(decimal128_t A, int32_t Ascale,
+                                      int32_t rscale, decimal128_t *out);
+
+/* decimal256 */
+
+/* Build from / store to an array of words, least significant first */
+static inline decimal256_t dec256_from_le_words(const uint64_t words[4]) {
+  decimal256_t dec;
+  for (int i = 0; i < DEC256_NWORDS; i++) {
+    dec.array[DEC128_LITTLE_ENDIAN ? i : DEC256_NWORDS - 1 - i] = words[i];
+  }
+  return dec;
+}
+
+static inline void dec256_to_le_words(decimal256_t v, uint64_t words[4]) {
+  for (int i = 0; i < DEC256_NWORDS; i++) {
+    words[i] = v.array[DEC128_LITTLE_ENDIAN ? i : DEC256_NWORDS - 1 - i];
+  }
+}
+
+static inline decimal256_t dec256_from_int64(int64_t value) {
+  uint64_t ext = (uint64_t)(value >> 63);
+  uint64_t words[4] = {(uint64_t)value, ext, ext, ext};
+  return dec256_from_le_words(words);
+}
+
+/* widen, always exact */
+static inline decimal256_t dec256_from_dec128(decimal128_t v) {
+  uint64_t ext = (uint64_t)(dec128_high_bits(v) >> 63);
+  uint64_t words[4] = {dec128_low_bits(v), (uint64_t)dec128_high_bits(v), ext,
+                       ext};
+  return dec256_from_le_words(words);
+}
+
+/* narrow, DEC128_STATUS_OVERFLOW if v does not fit in 128 bits */
+decimal_status_t dec256_to_dec128(decimal256_t v, decimal128_t *out);
+
+static inline bool dec256_is_negative(decimal256_t v) {
+  return (int64_t)v.array[DEC128_LITTLE_ENDIAN ? DEC256_NWORDS - 1 : 0] < 0;
+}
+
+// return 1 if positive or zero, -1 if strictly negative
+static inline int64_t dec256_sign(decimal256_t v) {
+  return dec256_is_negative(v) ? -1 : 1;
+}
+
+bool dec256_cmpeq(decimal256_t left, decimal256_t right);
+bool dec256_cmpne(decimal256_t left, decimal256_t right);
+bool dec256_cmplt(decimal256_t left, decimal256_t right);
+bool dec256_cmpgt(decimal256_t left, decimal256_t right);
+bool dec256_cmpge(decimal256_t left, decimal256_t right);
+bool dec256_cmple(decimal256_t left, decimal256_t right);
+
+decimal256_t dec256_negate(decimal256_t v);
+
+decimal256_t dec256_abs(decimal256_t v);
+
+decimal256_t dec256_sum(decimal256_t left, decimal256_t right);
+
+decimal256_t dec256_subtract(decimal256_t left, decimal256_t right);
+
+/* result is truncated to 256 bits */
+decimal256_t dec256_multiply(decimal256_t left, decimal256_t right);
+
+/* exact product of two decimal128, for results with precision above 38 */
+decimal256_t dec128_multiply_wide(decimal128_t left, decimal128_t right);
+
+decimal_status_t dec256_divide(decimal256_t dividend, decimal256_t divisor,
+                               decimal256_t *result, decimal256_t *remainder);
+
+decimal_status_t dec256_get_whole_and_fraction(decimal256_t v, int32_t scale,
+                                               decimal256_t *whole,
+                                               decimal256_t *fraction);
+
+decimal256_t dec256_get_scale_multiplier(int32_t scale);
+
+decimal256_t dec256_get_half_scale_multiplier(int32_t scale);
+
+decimal256_t dec256_max(int32_t precision);
+
+decimal_status_t dec256_rescale(decimal256_t v, int32_t original_scale,
+                                int32_t new_scale, decimal256_t *out);
+
+decimal256_t dec256_increase_scale_by(decimal256_t v, int32_t increase_by);
+
+decimal256_t dec256_reduce_scale_by(decimal256_t v, int32_t reduce_by,
+                                    bool round);
+
+bool dec256_fits_in_precision(decimal256_t v, int32_t precision);
+
+decimal_status_t dec256_from_string(const char *s, decimal256_t *out,
+                                    int32_t *precision, int32_t *scale);
+
+decimal_status_t dec256_from_chars(const char *first, const char *last,
+                                   decimal256_t *out, int32_t *precision,
+                                   int32_t *scale, const char **end);
+
+decimal_status_t dec256_from_float(float real, decimal256_t *out,
+                                   int32_t precision, int32_t scale);
+
+decimal_status_t dec256_from_double(double real, decimal256_t *out,
+                                    int32_t precision, int32_t scale);
+
+decimal_status_t dec256_to_integer_string(decimal256_t v, char *out);
+
+/* out must hold DEC256_MAX_STRLEN bytes */
+void dec256_to_string(decimal256_t v, char *out, int32_t scale);
+
+int32_t dec256_to_chars(decimal256_t v, char *first, char *last,
+                        int32_t scale);
+
+float dec256_to_float(decimal256_t v, int32_t scale);
+
+double dec256_to_double(decimal256_t v, int32_t scale);
+
 DEC128_EXTERN_END
 
 #endif
@@ -0,0 +1,917 @@
+#include "decimal/batch_decimal.h"
+#include "decimal/bit_util.h"
+#include "decimal/decimal_internal.h"
+#include "decimal/int_util_overflow.h"
+#include "decimal/logging.h"
+#include "decimal/macros.h"
+
+#if defined(__AVX2__) && DEC128_LITTLE_ENDIAN
+#include <immintrin.h>
+#define DEC128_BATCH_AVX2 1
+#else
+#define DEC128_BATCH_AVX2 0
+#endif
+
+/* scalar kernels, same arithmetic as basic_decimal.c but inlinable */
+static inline decimal128_t SumKernel(decimal128_t left, decimal128_t right) {
+  int64_t result_hi =
+      SafeSignedAdd(dec128_high_bits(left), dec128_high_bits(right));
+  uint64_t result_lo = dec128_low_bits(left) + dec128_low_bits(right);
+  result_hi = SafeSignedAdd(result_hi, result_lo < dec128_low_bits(left));
+  return dec128_from_hilo(result_hi, result_lo);
+}
+
+static inline decimal128_t SubtractKernel(decimal128_t left,
+                                          decimal128_t right) {
+  int64_t result_hi =
+      SafeSignedSubtract(dec128_high_bits(left), dec128_high_bits(right));
+  uint64_t result_lo = dec128_low_bits(left) - dec128_low_bits(right);
+  result_hi = SafeSignedSubtract(result_hi, result_lo > dec128_low_bits(left));
+  return dec128_from_hilo(result_hi, result_lo);
+}
+
+// The low 128 bits of a two's complement product do not depend on the signs
+// of the operands, so no abs/negate is needed here.
+static inline decimal128_t MultiplyKernel(decimal128_t left,
+                                          decimal128_t right) {
+  __uint128_t x = (__uint128_t)dec128_to_int128(left);
+  __uint128_t y = (__uint128_t)dec128_to_int128(right);
+  return dec128_from_int128((__int128)(x * y));
+}
+
+static inline decimal128_t NegateKernel(decimal128_t v) {
+  return SubtractKernel((decimal128_t){0}, v);
+}
+
+static inline decimal128_t AbsKernel(decimal128_t v) {
+  return dec128_is_negative(v) ? NegateKernel(v) : v;
+}
+
+#if DEC128_BATCH_AVX2
+/*
+ * Each 256-bit register holds two decimals as [lo0, hi0, lo1, hi1]. The
+ * carry (or borrow) of the low word is computed as an unsigned compare,
+ * which AVX2 lacks, so both sides are biased by 2^63 and compared signed.
+ * The resulting all-ones mask is then moved from the low lane to the high
+ * lane of the same decimal with a byte shift within each 128-bit half.
+ */
+static inline __m256i Add128x2(__m256i a, __m256i b) {
+  const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+  __m256i sum = _mm256_add_epi64(a, b);
+  __m256i carry = _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias),
+                                     _mm256_xor_si256(sum, bias));
+  carry = _mm256_slli_si256(carry, 8);
+  return _mm256_sub_epi64(sum, carry);
+}
+
+static inline __m256i Sub128x2(__m256i a, __m256i b) {
+  const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+  __m256i diff = _mm256_sub_epi64(a, b);
+  __m256i borrow = _mm256_cmpgt_epi64(_mm256_xor_si256(b, bias),
+                                      _mm256_xor_si256(a, bias));
+  borrow = _mm256_slli_si256(borrow, 8);
+  return _mm256_add_epi64(diff, borrow);
+}
+
+static inline __m256i Abs128x2(__m256i v) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i neg = Sub128x2(zero, v);
+  // sign of the high word, broadcast to both words of the decimal
+  __m256i sign = _mm256_cmpgt_epi64(zero, v);
+  sign = _mm256_shuffle_epi32(sign, _MM_SHUFFLE(3, 2, 3, 2));
+  return _mm256_blendv_epi8(v, neg, sign);
+}
+
+static inline __m256i Load128x2(const decimal128_t *p) {
+  return _mm256_loadu_si256((const __m256i *)p);
+}
+
+static inline void Store128x2(decimal128_t *p, __m256i v) {
+  _mm256_storeu_si256((__m256i *)p, v);
+}
+
+static inline __m256i Broadcast128(decimal128_t v) {
+  return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)&v));
+}
+#endif
+
+/* sum */
+void dec128_sum_batch(const decimal128_t *a, const decimal128_t *b,
+                      decimal128_t *out, size_t n) {
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  for (; i + 4 <= n; i += 4) {
+    __m256i r0 = Add128x2(Load128x2(a + i), Load128x2(b + i));
+    __m256i r1 = Add128x2(Load128x2(a + i + 2), Load128x2(b + i + 2));
+    Store128x2(out + i, r0);
+    Store128x2(out + i + 2, r1);
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = SumKernel(a[i], b[i]);
+  }
+}
+
+void dec128_sum_batch_scalar(const decimal128_t *a, decimal128_t b,
+                             decimal128_t *out, size_t n) {
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  const __m256i vb = Broadcast128(b);
+  for (; i + 4 <= n; i += 4) {
+    __m256i r0 = Add128x2(Load128x2(a + i), vb);
+    __m256i r1 = Add128x2(Load128x2(a + i + 2), vb);
+    Store128x2(out + i, r0);
+    Store128x2(out + i + 2, r1);
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = SumKernel(a[i], b);
+  }
+}
+
+/* subtract */
+void dec128_subtract_batch(const decimal128_t *a, const decimal128_t *b,
+                           decimal128_t *out, size_t n) {
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  for (; i + 4 <= n; i += 4) {
+    __m256i r0 = Sub128x2(Load128x2(a + i), Load128x2(b + i));
+    __m256i r1 = Sub128x2(Load128x2(a + i + 2), Load128x2(b + i + 2));
+    Store128x2(out + i, r0);
+    Store128x2(out + i + 2, r1);
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = SubtractKernel(a[i], b[i]);
+  }
+}
+
+void dec128_subtract_batch_scalar(const decimal128_t *a, decimal128_t b,
+                                  decimal128_t *out, size_t n) {
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  const __m256i vb = Broadcast128(b);
+  for (; i + 4 <= n; i += 4) {
+    __m256i r0 = Sub128x2(Load128x2(a + i), vb);
+    __m256i r1 = Sub128x2(Load128x2(a + i + 2), vb);
+    Store128x2(out + i, r0);
+    Store128x2(out + i + 2, r1);
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = SubtractKernel(a[i], b);
+  }
+}
+
+void dec128_subtract_scalar_batch(decimal128_t a, const decimal128_t *b,
+                                  decimal128_t *out, size_t n) {
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  const __m256i va = Broadcast128(a);
+  for (; i + 4 <= n; i += 4) {
+    __m256i r0 = Sub128x2(va, Load128x2(b + i));
+    __m256i r1 = Sub128x2(va, Load128x2(b + i + 2));
+    Store128x2(out + i, r0);
+    Store128x2(out + i + 2, r1);
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = SubtractKernel(a, b[i]);
+  }
+}
+
+/* multiply: AVX2 has no 64x64->128 multiply, the scalar mulx path is faster */
+void dec128_multiply_batch(const decimal128_t *a, const decimal128_t *b,
+                           decimal128_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = MultiplyKernel(a[i], b[i]);
+  }
+}
+
+void dec128_multiply_batch_scalar(const decimal128_t *a, decimal128_t b,
+                                  decimal128_t *out, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = MultiplyKernel(a[i], b);
+  }
+}
+
+/* negate */
+void dec128_negate_batch(const decimal128_t *v, decimal128_t *out, size_t n) {
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  const __m256i zero = _mm256_setzero_si256();
+  for (; i + 4 <= n; i += 4) {
+    __m256i r0 = Sub128x2(zero, Load128x2(v + i));
+    __m256i r1 = Sub128x2(zero, Load128x2(v + i + 2));
+    Store128x2(out + i, r0);
+    Store128x2(out + i + 2, r1);
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = NegateKernel(v[i]);
+  }
+}
+
+/* absolute */
+void dec128_abs_batch(const decimal128_t *v, decimal128_t *out, size_t n) {
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  for (; i + 4 <= n; i += 4) {
+    __m256i r0 = Abs128x2(Load128x2(v + i));
+    __m256i r1 = Abs128x2(Load128x2(v + i + 2));
+    Store128x2(out + i, r0);
+    Store128x2(out + i + 2, r1);
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = AbsKernel(v[i]);
+  }
+}
+
+/*
+ * Checked kernels go through blocks of 8 rows like the comparison kernels
+ * below, the error bits of a block are stored as one byte. OP(k, &r) sets r
+ * for row k and returns true on 128-bit overflow.
+ */
+#define CHECKED_BATCH(OP)                                                      \
+  {                                                                            \
+    DCHECK_GE(precision, 1);                                                   \
+    DCHECK_LE(precision, DEC128_MAX_PRECISION);                                \
+    const __uint128_t limit = UInt128PowerOfTen(precision) - 1;                \
+    size_t nerrors = 0;                                                        \
+    for (size_t i = 0; i < n; i += 8) {                                        \
+      const size_t m = MIN(8, n - i);                                          \
+      unsigned bits = 0;                                                       \
+      for (size_t j = 0; j < m; j++) {                                         \
+        const size_t k = i + j;                                                \
+        __int128_t r;                                                          \
+        bool error = OP(k, &r);                                                \
+        error |= !Int128FitsLimit(r, limit);                                   \
+        out[k] = dec128_from_int128(error ? 0 : r);                            \
+        bits |= (unsigned)error << j;                                          \
+      }                                                                        \
+      if (errors) {                                                            \
+        errors[i / 8] = (uint8_t)bits;                                         \
+      }                                                                        \
+      nerrors += DEC128_POPCOUNT32(bits);                                      \
+    }                                                                          \
+    return nerrors;                                                            \
+  }
+
+#define SUM_ROWS(k, r)                                                         \
+  Int128AddOverflow(dec128_to_int128(a[k]), dec128_to_int128(b[k]), r)
+#define SUM_ROW_SCALAR(k, r)                                                   \
+  Int128AddOverflow(dec128_to_int128(a[k]), y, r)
+#define SUBTRACT_ROWS(k, r)                                                    \
+  Int128SubtractOverflow(dec128_to_int128(a[k]), dec128_to_int128(b[k]), r)
+#define SUBTRACT_ROW_SCALAR(k, r)                                              \
+  Int128SubtractOverflow(dec128_to_int128(a[k]), y, r)
+#define SUBTRACT_SCALAR_ROW(k, r)                                              \
+  Int128SubtractOverflow(x, dec128_to_int128(b[k]), r)
+#define MULTIPLY_ROWS(k, r)                                                    \
+  Int128MultiplyOverflow(dec128_to_int128(a[k]), dec128_to_int128(b[k]), r)
+#define MULTIPLY_ROW_SCALAR(k, r)                                              \
+  Int128MultiplyOverflow(dec128_to_int128(a[k]), y, r)
+
+size_t dec128_sum_batch_checked(const decimal128_t *a, const decimal128_t *b,
+                                size_t n, int32_t precision,
+                                decimal128_t *out, uint8_t *errors) {
+  CHECKED_BATCH(SUM_ROWS);
+}
+
+size_t dec128_sum_batch_scalar_checked(const decimal128_t *a, decimal128_t b,
+                                       size_t n, int32_t precision,
+                                       decimal128_t *out, uint8_t *errors) {
+  const __int128_t y = dec128_to_int128(b);
+  CHECKED_BATCH(SUM_ROW_SCALAR);
+}
+
+size_t dec128_subtract_batch_checked(const decimal128_t *a,
+                                     const decimal128_t *b, size_t n,
+                                     int32_t precision, decimal128_t *out,
+                                     uint8_t *errors) {
+  CHECKED_BATCH(SUBTRACT_ROWS);
+}
+
+size_t dec128_subtract_batch_scalar_checked(const decimal128_t *a,
+                                            decimal128_t b, size_t n,
+                                            int32_t precision,
+                                            decimal128_t *out,
+                                            uint8_t *errors) {
+  const __int128_t y = dec128_to_int128(b);
+  CHECKED_BATCH(SUBTRACT_ROW_SCALAR);
+}
+
+size_t dec128_subtract_scalar_batch_checked(decimal128_t a,
+                                            const decimal128_t *b, size_t n,
+                                            int32_t precision,
+                                            decimal128_t *out,
+                                            uint8_t *errors) {
+  const __int128_t x = dec128_to_int128(a);
+  CHECKED_BATCH(SUBTRACT_SCALAR_ROW);
+}
+
+size_t dec128_multiply_batch_checked(const decimal128_t *a,
+                                     const decimal128_t *b, size_t n,
+                                     int32_t precision, decimal128_t *out,
+                                     uint8_t *errors) {
+  CHECKED_BATCH(MULTIPLY_ROWS);
+}
+
+size_t dec128_multiply_batch_scalar_checked(const decimal128_t *a,
+                                            decimal128_t b, size_t n,
+                                            int32_t precision,
+                                            decimal128_t *out,
+                                            uint8_t *errors) {
+  const __int128_t y = dec128_to_int128(b);
+  CHECKED_BATCH(MULTIPLY_ROW_SCALAR);
+}
+
+/*
+ * Comparison kernels work on blocks of up to 8 rows and produce one bit per
+ * row. A stride of 0 repeats the same value for every row, which is how the
+ * column-vs-constant variants share the column-vs-column code.
+ */
+static inline unsigned LtScalar(decimal128_t left, decimal128_t right) {
+  // branch free form of dec128_cmplt
+  return (unsigned)(dec128_high_bits(left) < dec128_high_bits(right)) |
+         ((unsigned)(dec128_high_bits(left) == dec128_high_bits(right)) &
+          (unsigned)(dec128_low_bits(left) < dec128_low_bits(right)));
+}
+
+static inline unsigned EqScalar(decimal128_t left, decimal128_t right) {
+  return (unsigned)(dec128_high_bits(left) == dec128_high_bits(right)) &
+         (unsigned)(dec128_low_bits(left) == dec128_low_bits(right));
+}
+
+#if DEC128_BATCH_AVX2
+/* results are valid in the high word lanes only */
+static inline __m256i Lt128x2(__m256i a, __m256i b) {
+  const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+  __m256i hi_lt = _mm256_cmpgt_epi64(b, a);
+  __m256i eq = _mm256_cmpeq_epi64(a, b);
+  __m256i lo_lt = _mm256_cmpgt_epi64(_mm256_xor_si256(b, bias),
+                                     _mm256_xor_si256(a, bias));
+  return _mm256_or_si256(hi_lt,
+                         _mm256_and_si256(eq, _mm256_slli_si256(lo_lt, 8)));
+}
+
+static inline __m256i Eq128x2(__m256i a, __m256i b) {
+  __m256i eq = _mm256_cmpeq_epi64(a, b);
+  return _mm256_and_si256(eq, _mm256_slli_si256(eq, 8));
+}
+
+static inline unsigned HighLaneBits(__m256i r) {
+  unsigned m = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(r));
+  return ((m >> 1) & 1) | ((m >> 2) & 2);
+}
+
+static inline __m256i LoadStride128x2(const decimal128_t *p, size_t stride) {
+  return stride ? Load128x2(p) : Broadcast128(*p);
+}
+#endif
+
+static inline unsigned LtMask(const decimal128_t *a, size_t as,
+                              const decimal128_t *b, size_t bs, size_t m) {
+#if DEC128_BATCH_AVX2
+  if (m == 8) {
+    unsigned bits = 0;
+    for (size_t j = 0; j < 8; j += 2) {
+      __m256i r = Lt128x2(LoadStride128x2(a + j * as, as),
+                          LoadStride128x2(b + j * bs, bs));
+      bits |= HighLaneBits(r) << j;
+    }
+    return bits;
+  }
+#endif
+  unsigned bits = 0;
+  for (size_t j = 0; j < m; j++) {
+    bits |= LtScalar(a[j * as], b[j * bs]) << j;
+  }
+  return bits;
+}
+
+static inline unsigned EqMask(const decimal128_t *a, size_t as,
+                              const decimal128_t *b, size_t bs, size_t m) {
+#if DEC128_BATCH_AVX2
+  if (m == 8) {
+    unsigned bits = 0;
+    for (size_t j = 0; j < 8; j += 2) {
+      __m256i r = Eq128x2(LoadStride128x2(a + j * as, as),
+                          LoadStride128x2(b + j * bs, bs));
+      bits |= HighLaneBits(r) << j;
+    }
+    return bits;
+  }
+#endif
+  unsigned bits = 0;
+  for (size_t j = 0; j < m; j++) {
+    bits |= EqScalar(a[j * as], b[j * bs]) << j;
+  }
+  return bits;
+}
+
+static inline unsigned CmpMask(dec128_cmp_op_t op, const decimal128_t *a,
+                               size_t as, const decimal128_t *b, size_t bs,
+                               size_t m) {
+  const unsigned all = (1U << m) - 1;
+  switch (op) {
+  case DEC128_CMP_EQ:
+    return EqMask(a, as, b, bs, m);
+  case DEC128_CMP_NE:
+    return ~EqMask(a, as, b, bs, m) & all;
+  case DEC128_CMP_LT:
+    return LtMask(a, as, b, bs, m);
+  case DEC128_CMP_LE:
+    return ~LtMask(b, bs, a, as, m) & all;
+  case DEC128_CMP_GT:
+    return LtMask(b, bs, a, as, m);
+  case DEC128_CMP_GE:
+    return ~LtMask(a, as, b, bs, m) & all;
+  }
+  return 0;
+}
+
+static inline unsigned BetweenMask(const decimal128_t *a, const decimal128_t *lo,
+                                   const decimal128_t *hi, size_t m) {
+  const unsigned all = (1U << m) - 1;
+  return ~(LtMask(a, 1, lo, 0, m) | LtMask(hi, 0, a, 1, m)) & all;
+}
+
+static inline unsigned InMask(const decimal128_t *a, const decimal128_t *list,
+                              size_t nlist, size_t m) {
+  unsigned bits = 0;
+  for (size_t k = 0; k < nlist; k++) {
+    bits |= EqMask(a, 1, list + k, 0, m);
+  }
+  return bits;
+}
+
+// Branch free append of the set bits of a block to a selection vector. The
+// store at sel[count] is always in bounds as count never exceeds base + j.
+static inline size_t AppendSelection(uint32_t *sel, size_t count, size_t base,
+                                     unsigned bits, size_t m) {
+  for (size_t j = 0; j < m; j++) {
+    sel[count] = (uint32_t)(base + j);
+    count += (bits >> j) & 1;
+  }
+  return count;
+}
+
+#define FILTER_BITMAP(MASK)                                                    \
+  {                                                                            \
+    for (size_t i = 0; i < n; i += 8) {                                        \
+      const size_t m = MIN(8, n - i);                                          \
+      bitmap[i / 8] = (uint8_t)(MASK);                                         \
+    }                                                                          \
+  }
+
+#define FILTER_SEL(MASK)                                                       \
+  {                                                                            \
+    size_t count = 0;                                                          \
+    for (size_t i = 0; i < n; i += 8) {                                        \
+      const size_t m = MIN(8, n - i);                                          \
+      count = AppendSelection(sel, count, i, (MASK), m);                       \
+    }                                                                          \
+    return count;                                                              \
+  }
+
+/* compare */
+void dec128_cmp_batch_bitmap(dec128_cmp_op_t op, const decimal128_t *a,
+                             const decimal128_t *b, size_t n, uint8_t *bitmap) {
+  FILTER_BITMAP(CmpMask(op, a + i, 1, b + i, 1, m));
+}
+
+size_t dec128_cmp_batch_sel(dec128_cmp_op_t op, const decimal128_t *a,
+                            const decimal128_t *b, size_t n, uint32_t *sel) {
+  FILTER_SEL(CmpMask(op, a + i, 1, b + i, 1, m));
+}
+
+void dec128_cmp_batch_scalar_bitmap(dec128_cmp_op_t op, const decimal128_t *a,
+                                    decimal128_t b, size_t n,
+                                    uint8_t *bitmap) {
+  FILTER_BITMAP(CmpMask(op, a + i, 1, &b, 0, m));
+}
+
+size_t dec128_cmp_batch_scalar_sel(dec128_cmp_op_t op, const decimal128_t *a,
+                                   decimal128_t b, size_t n, uint32_t *sel) {
+  FILTER_SEL(CmpMask(op, a + i, 1, &b, 0, m));
+}
+
+/* between */
+void dec128_between_batch_bitmap(const decimal128_t *a, decimal128_t lo,
+                                 decimal128_t hi, size_t n, uint8_t *bitmap) {
+  FILTER_BITMAP(BetweenMask(a + i, &lo, &hi, m));
+}
+
+size_t dec128_between_batch_sel(const decimal128_t *a, decimal128_t lo,
+                                decimal128_t hi, size_t n, uint32_t *sel) {
+  FILTER_SEL(BetweenMask(a + i, &lo, &hi, m));
+}
+
+/* in list */
+void dec128_in_batch_bitmap(const decimal128_t *a, const decimal128_t *list,
+                            size_t nlist, size_t n, uint8_t *bitmap) {
+  FILTER_BITMAP(InMask(a + i, list, nlist, m));
+}
+
+size_t dec128_in_batch_sel(const decimal128_t *a, const decimal128_t *list,
+                           size_t nlist, size_t n, uint32_t *sel) {
+  FILTER_SEL(InMask(a + i, list, nlist, m));
+}
+
+/* aggregation */
+#define AGG_WIDE_WORDS 4
+
+// 192-bit running sum split as a 128-bit low part and a signed top word, so
+// that each row costs one 128-bit add and one add with carry.
+typedef struct WideSum {
+  __uint128_t low;
+  int64_t top;
+} WideSum;
+
+static inline void WideSumAdd(WideSum *acc, decimal128_t v) {
+  const __uint128_t x = (__uint128_t)dec128_to_int128(v);
+  acc->low += x;
+  acc->top += (int64_t)(acc->low < x) + (dec128_high_bits(v) >> 63);
+}
+
+static inline void WideSumMerge(WideSum *acc, const WideSum *other) {
+  acc->low += other->low;
+  acc->top += (int64_t)(acc->low < other->low) + other->top;
+}
+
+static inline WideSum WideSumLoad(const dec128_agg_t *state) {
+  WideSum acc;
+  acc.low = (((__uint128_t)state->sum[1]) << 64) | state->sum[0];
+  acc.top = (int64_t)state->sum[2];
+  return acc;
+}
+
+static inline void WideSumStore(dec128_agg_t *state, const WideSum *acc) {
+  state->sum[0] = (uint64_t)acc->low;
+  state->sum[1] = (uint64_t)(acc->low >> 64);
+  state->sum[2] = (uint64_t)acc->top;
+}
+
+static inline decimal128_t MinKernel(decimal128_t left, decimal128_t right) {
+  return LtScalar(right, left) ? right : left;
+}
+
+static inline decimal128_t MaxKernel(decimal128_t left, decimal128_t right) {
+  return LtScalar(left, right) ? right : left;
+}
+
+void dec128_agg_init(dec128_agg_t *state) {
+  memset(state->sum, 0, sizeof(state->sum));
+  state->count = 0;
+  state->min = dec128_from_hilo(INT64_MAX, UINT64_MAX);
+  state->max = dec128_from_hilo(INT64_MIN, 0);
+}
+
+void dec128_agg_update_batch(dec128_agg_t *state, const decimal128_t *v,
+                             const uint8_t *validity, size_t n) {
+  WideSum acc0 = WideSumLoad(state);
+  decimal128_t min0 = state->min;
+  decimal128_t max0 = state->max;
+  int64_t count = 0;
+
+  if (validity == NULL) {
+    // two independent accumulators to break the carry dependency chain
+    WideSum acc1 = {0, 0};
+    decimal128_t min1 = min0;
+    decimal128_t max1 = max0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+      WideSumAdd(&acc0, v[i]);
+      WideSumAdd(&acc1, v[i + 1]);
+      min0 = MinKernel(min0, v[i]);
+      min1 = MinKernel(min1, v[i + 1]);
+      max0 = MaxKernel(max0, v[i]);
+      max1 = MaxKernel(max1, v[i + 1]);
+    }
+    for (; i < n; i++) {
+      WideSumAdd(&acc0, v[i]);
+      min0 = MinKernel(min0, v[i]);
+      max0 = MaxKernel(max0, v[i]);
+    }
+    WideSumMerge(&acc0, &acc1);
+    min0 = MinKernel(min0, min1);
+    max0 = MaxKernel(max0, max1);
+    count = (int64_t)n;
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      if ((validity[i / 8] >> (i % 8)) & 1) {
+        WideSumAdd(&acc0, v[i]);
+        min0 = MinKernel(min0, v[i]);
+        max0 = MaxKernel(max0, v[i]);
+        count++;
+      }
+    }
+  }
+
+  WideSumStore(state, &acc0);
+  state->min = min0;
+  state->max = max0;
+  state->count += count;
+}
+
+static inline void AggUpdateRow(dec128_agg_t *state, decimal128_t v) {
+  WideSum acc = WideSumLoad(state);
+  WideSumAdd(&acc, v);
+  WideSumStore(state, &acc);
+  state->count++;
+  state->min = MinKernel(state->min, v);
+  state->max = MaxKernel(state->max, v);
+}
+
+void dec128_agg_update_grouped(dec128_agg_t *states, const uint32_t *group_ids,
+                               const decimal128_t *v, const uint8_t *validity,
+                               size_t n) {
+  if (validity == NULL) {
+    for (size_t i = 0; i < n; i++) {
+      AggUpdateRow(&states[group_ids[i]], v[i]);
+    }
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      if ((validity[i / 8] >> (i % 8)) & 1) {
+        AggUpdateRow(&states[group_ids[i]], v[i]);
+      }
+    }
+  }
+}
+
+void dec128_agg_combine(dec128_agg_t *state, const dec128_agg_t *other) {
+  WideSum acc = WideSumLoad(state);
+  WideSum acc_other = WideSumLoad(other);
+  WideSumMerge(&acc, &acc_other);
+  WideSumStore(state, &acc);
+  state->count += other->count;
+  state->min = MinKernel(state->min, other->min);
+  state->max = MaxKernel(state->max, other->max);
+}
+
+// Compares the unsigned magnitude, AbsKernel leaves INT128_MIN negative
+static inline bool FitsInPrecision(decimal128_t v, int32_t precision) {
+  const __int128_t x = dec128_to_int128(v);
+  const __uint128_t m = x < 0 ? -(__uint128_t)x : (__uint128_t)x;
+  return m < UInt128PowerOfTen(precision);
+}
+
+decimal_status_t dec128_agg_sum(const dec128_agg_t *state, int32_t precision,
+                                decimal128_t *out) {
+  DCHECK_GT(precision, 0);
+  DCHECK_LE(precision, DEC128_MAX_PRECISION);
+
+  if (state->count == 0) {
+    return DEC128_STATUS_ERROR;
+  }
+  // the top word must be the sign extension of the low 128 bits
+  const int64_t sign = (int64_t)state->sum[1] >> 63;
+  if ((int64_t)state->sum[2] != sign) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  decimal128_t sum = dec128_from_hilo((int64_t)state->sum[1], state->sum[0]);
+  if (!FitsInPrecision(sum, precision)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = sum;
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec128_agg_min(const dec128_agg_t *state, decimal128_t *out) {
+  if (state->count == 0) {
+    return DEC128_STATUS_ERROR;
+  }
+  *out = state->min;
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec128_agg_max(const dec128_agg_t *state, decimal128_t *out) {
+  if (state->count == 0) {
+    return DEC128_STATUS_ERROR;
+  }
+  *out = state->max;
+  return DEC128_STATUS_SUCCESS;
+}
+
+/// Multiply a little endian magnitude by m, return false on overflow.
+static bool WideMultiply(uint64_t *words, size_t n, uint64_t m) {
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    __uint128_t t = (__uint128_t)words[i] * m + carry;
+    words[i] = (uint64_t)t;
+    carry = (uint64_t)(t >> 64);
+  }
+  return carry == 0;
+}
+
+/// Divide a little endian magnitude by d in place, return the remainder.
+static uint64_t WideDivide(uint64_t *words, size_t n, uint64_t d) {
+  __uint128_t r = 0;
+  for (size_t i = n; i-- > 0;) {
+    r = (r << 64) | words[i];
+    words[i] = (uint64_t)(r / d);
+    r %= d;
+  }
+  return (uint64_t)r;
+}
+
+decimal_status_t dec128_agg_avg(const dec128_agg_t *state, int32_t scale,
+                                int32_t ret_precision, int32_t ret_scale,
+                                decimal128_t *out) {
+  DCHECK_GT(ret_precision, 0);
+  DCHECK_LE(ret_precision, DEC128_MAX_PRECISION);
+
+  if (ret_scale < scale) {
+    return DEC128_STATUS_ERROR;
+  }
+  if (state->count == 0) {
+    return DEC128_STATUS_DIVIDEDBYZERO;
+  }
+
+  // magnitude of the sum, widened to 256 bits to leave room for the rescale
+  const bool negative = (int64_t)state->sum[2] < 0;
+  uint64_t words[AGG_WIDE_WORDS] = {state->sum[0], state->sum[1],
+                                    state->sum[2], 0};
+  if (negative) {
+    uint64_t carry = 1;
+    for (size_t i = 0; i < 3; i++) {
+      words[i] = ~words[i] + carry;
+      carry = carry && words[i] == 0;
+    }
+  }
+
+  for (int32_t k = ret_scale - scale; k > 0; k -= kInt64DecimalDigits) {
+    const int32_t step = MIN(k, kInt64DecimalDigits);
+    if (!WideMultiply(words, AGG_WIDE_WORDS, kUInt64PowersOfTen[step])) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+  }
+
+  const uint64_t count = (uint64_t)state->count;
+  const uint64_t remainder = WideDivide(words, AGG_WIDE_WORDS, count);
+  if (remainder >= count - remainder) {
+    uint64_t one = 1;
+    for (size_t i = 0; i < AGG_WIDE_WORDS && one; i++) {
+      words[i] += one;
+      one = words[i] == 0;
+    }
+  }
+
+  if (words[3] != 0 || words[2] != 0 || (int64_t)words[1] < 0) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  decimal128_t avg = dec128_from_hilo((int64_t)words[1], words[0]);
+  if (negative) {
+    avg = NegateKernel(avg);
+  }
+  if (!FitsInPrecision(avg, ret_precision)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = avg;
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* big-endian two's complement bytes */
+#if DEC128_BATCH_AVX2
+// Byte i of the shuffle takes byte length - 1 - i, which reverses the bytes
+// of a value into the low length bytes. Lanes i >= length are negative, so
+// pshufb zeros them, and they mark the bytes to sign extend.
+static inline __m128i BigEndianShuffle(int32_t length) {
+  const __m128i lanes =
+      _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  return _mm_sub_epi8(_mm_set1_epi8((char)(length - 1)), lanes);
+}
+
+static inline __m128i FromBigEndian128(const uint8_t *bytes,
+                                       __m128i shuffle) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i v = _mm_loadu_si128((const __m128i *)bytes);
+  // the sign of the first byte in every byte
+  const __m128i sign = _mm_cmpgt_epi8(zero, _mm_shuffle_epi8(v, zero));
+  const __m128i extend = _mm_cmpgt_epi8(zero, shuffle);
+  return _mm_or_si128(_mm_shuffle_epi8(v, shuffle),
+                      _mm_and_si128(sign, extend));
+}
+#endif
+
+decimal_status_t dec128_from_big_endian_fixed_batch(const uint8_t *data,
+                                                    int32_t byte_width,
+                                                    size_t n,
+                                                    decimal128_t *out) {
+  if (byte_width < 1 || byte_width > 16) {
+    return DEC128_STATUS_ERROR;
+  }
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  const __m128i shuffle = BigEndianShuffle(byte_width);
+  // 16 byte loads must stay within the n * byte_width input bytes
+  const size_t nvector =
+      n - MIN(n, (size_t)((16 + byte_width - 1) / byte_width - 1));
+  for (; i < nvector; i++) {
+    _mm_storeu_si128((__m128i *)(out + i),
+                     FromBigEndian128(data + i * byte_width, shuffle));
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = DecimalFromBigEndian(data + i * byte_width, byte_width);
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+size_t dec128_from_big_endian_batch(const int32_t *offsets,
+                                    const uint8_t *data,
+                                    const uint8_t *validity, size_t n,
+                                    decimal128_t *out, uint8_t *errors) {
+  size_t nerrors = 0;
+  if (errors) {
+    memset(errors, 0, (n + 7) / 8);
+  }
+#if DEC128_BATCH_AVX2
+  const uint8_t *data_end = data + offsets[n];
+#endif
+  for (size_t i = 0; i < n; i++) {
+    if (validity && !((validity[i / 8] >> (i % 8)) & 1)) {
+      out[i] = (decimal128_t){0};
+      continue;
+    }
+    const uint8_t *bytes = data + offsets[i];
+    const int32_t length = offsets[i + 1] - offsets[i];
+    if (DEC128_PREDICT_FALSE(length < 1 || length > 16)) {
+      out[i] = (decimal128_t){0};
+      if (errors) {
+        errors[i / 8] |= (uint8_t)(1U << (i % 8));
+      }
+      nerrors++;
+      continue;
+    }
+#if DEC128_BATCH_AVX2
+    if (DEC128_PREDICT_TRUE(data_end - bytes >= 16)) {
+      _mm_storeu_si128((__m128i *)(out + i),
+                       FromBigEndian128(bytes, BigEndianShuffle(length)));
+      continue;
+    }
+#endif
+    out[i] = DecimalFromBigEndian(bytes, length);
+  }
+  return nerrors;
+}
+
+decimal_status_t dec128_to_big_endian_fixed_batch(const decimal128_t *values,
+                                                  size_t n, int32_t byte_width,
+                                                  uint8_t *data) {
+  if (byte_width < 1 || byte_width > 16) {
+    return DEC128_STATUS_ERROR;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (DEC128_PREDICT_FALSE(DecimalBigEndianLength(values[i]) > byte_width)) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+  }
+  size_t i = 0;
+#if DEC128_BATCH_AVX2
+  // the shuffle reverses the low byte_width bytes back, 16 byte stores must
+  // stay within the n * byte_width output bytes
+  const __m128i shuffle = BigEndianShuffle(byte_width);
+  const size_t nvector =
+      n - MIN(n, (size_t)((16 + byte_width - 1) / byte_width - 1));
+  for (; i < nvector; i++) {
+    const __m128i v = _mm_loadu_si128((const __m128i *)(values + i));
+    _mm_storeu_si128((__m128i *)(data + i * byte_width),
+                     _mm_shuffle_epi8(v, shuffle));
+  }
+#endif
+  for (; i < n; i++) {
+    uint8_t bytes[16];
+    DecimalToBigEndian(values[i], bytes);
+    memcpy(data + i * byte_width, bytes + 16 - byte_width, byte_width);
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+size_t dec128_to_big_endian_batch(const decimal128_t *values,
+                                  const uint8_t *validity, size_t n,
+                                  int32_t *offsets, uint8_t *data) {
+  size_t size = 0;
+  offsets[0] = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (!validity || ((validity[i / 8] >> (i % 8)) & 1)) {
+      const int32_t length = DecimalBigEndianLength(values[i]);
+#if DEC128_BATCH_AVX2
+      // data holds 16 bytes per row, so the store stays in bounds and the
+      // bytes past length are overwritten by the next rows
+      const __m128i v = _mm_loadu_si128((const __m128i *)(values + i));
+      _mm_storeu_si128((__m128i *)(data + size),
+                       _mm_shuffle_epi8(v, BigEndianShuffle(length)));
+#else
+      uint8_t bytes[16];
+      DecimalToBigEndian(values[i], bytes);
+      memcpy(data + size, bytes + 16 - length, length);
+#endif
+      size += (size_t)length;
+    }
+    offsets[i + 1] = (int32_t)size;
+  }
+  return size;
+}
@@ -0,0 +1,262 @@
+#ifndef _BATCH_DECIMAL_H_
+#define _BATCH_DECIMAL_H_
+
+#include "decimal/basic_decimal.h"
+#include <stddef.h>
+
+DEC128_EXTERN_BEGIN
+
+/*
+ * Columnar kernels over arrays of decimal128_t.
+ *
+ * All kernels process n values and write n results. The output array may be
+ * the same as one of the input arrays (in-place), but must not partially
+ * overlap it. Results are truncated to 128 bits exactly like the scalar
+ * dec128_* operations.
+ */
+
+/* out[i] = a[i] + b[i] */
+void dec128_sum_batch(const decimal128_t *a, const decimal128_t *b,
+                      decimal128_t *out, size_t n);
+
+/* out[i] = a[i] + b */
+void dec128_sum_batch_scalar(const decimal128_t *a, decimal128_t b,
+                             decimal128_t *out, size_t n);
+
+/* out[i] = a[i] - b[i] */
+void dec128_subtract_batch(const decimal128_t *a, const decimal128_t *b,
+                           decimal128_t *out, size_t n);
+
+/* out[i] = a[i] - b */
+void dec128_subtract_batch_scalar(const decimal128_t *a, decimal128_t b,
+                                  decimal128_t *out, size_t n);
+
+/* out[i] = a - b[i] */
+void dec128_subtract_scalar_batch(decimal128_t a, const decimal128_t *b,
+                                  decimal128_t *out, size_t n);
+
+/* out[i] = a[i] * b[i] */
+void dec128_multiply_batch(const decimal128_t *a, const decimal128_t *b,
+                           decimal128_t *out, size_t n);
+
+/* out[i] = a[i] * b */
+void dec128_multiply_batch_scalar(const decimal128_t *a, decimal128_t b,
+                                  decimal128_t *out, size_t n);
+
+/* out[i] = -v[i] */
+void dec128_negate_batch(const decimal128_t *v, decimal128_t *out, size_t n);
+
+/* out[i] = |v[i]| */
+void dec128_abs_batch(const decimal128_t *v, decimal128_t *out, size_t n);
+
+/*
+ * Checked kernels, the same operations without wrapping: rows whose exact
+ * result does not fit in precision digits (1 to DEC128_MAX_PRECISION) or in
+ * 128 bits are zero and get their bit set in errors (may be NULL), in the
+ * bitmap layout of the comparison kernels below. They return the number of
+ * errors.
+ */
+size_t dec128_sum_batch_checked(const decimal128_t *a, const decimal128_t *b,
+                                size_t n, int32_t precision,
+                                decimal128_t *out, uint8_t *errors);
+
+size_t dec128_sum_batch_scalar_checked(const decimal128_t *a, decimal128_t b,
+                                       size_t n, int32_t precision,
+                                       decimal128_t *out, uint8_t *errors);
+
+size_t dec128_subtract_batch_checked(const decimal128_t *a,
+                                     const decimal128_t *b, size_t n,
+                                     int32_t precision, decimal128_t *out,
+                                     uint8_t *errors);
+
+size_t dec128_subtract_batch_scalar_checked(const decimal128_t *a,
+                                            decimal128_t b, size_t n,
+                                            int32_t precision,
+                                            decimal128_t *out,
+                                            uint8_t *errors);
+
+size_t dec128_subtract_scalar_batch_checked(decimal128_t a,
+                                            const decimal128_t *b, size_t n,
+                                            int32_t precision,
+                                            decimal128_t *out,
+                                            uint8_t *errors);
+
+size_t dec128_multiply_batch_checked(const decimal128_t *a,
+                                     const decimal128_t *b, size_t n,
+                                     int32_t precision, decimal128_t *out,
+                                     uint8_t *errors);
+
+size_t dec128_multiply_batch_scalar_checked(const decimal128_t *a,
+                                            decimal128_t b, size_t n,
+                                            int32_t precision,
+                                            decimal128_t *out,
+                                            uint8_t *errors);
+
+/*
+ * Comparison kernels.
+ *
+ * The _bitmap variants write ceil(n / 8) bytes in Arrow validity layout
+ * (bit i of the result is bit (i % 8) of byte i / 8, least significant bit
+ * first); bits past n in the last byte are cleared.
+ *
+ * The _sel variants write the indexes of the rows that pass into sel, in
+ * ascending order, and return how many were written. sel must have room
+ * for n entries.
+ */
+typedef enum dec128_cmp_op_t {
+  DEC128_CMP_EQ,
+  DEC128_CMP_NE,
+  DEC128_CMP_LT,
+  DEC128_CMP_LE,
+  DEC128_CMP_GT,
+  DEC128_CMP_GE,
+} dec128_cmp_op_t;
+
+/* a[i] op b[i] */
+void dec128_cmp_batch_bitmap(dec128_cmp_op_t op, const decimal128_t *a,
+                             const decimal128_t *b, size_t n, uint8_t *bitmap);
+
+size_t dec128_cmp_batch_sel(dec128_cmp_op_t op, const decimal128_t *a,
+                            const decimal128_t *b, size_t n, uint32_t *sel);
+
+/* a[i] op b */
+void dec128_cmp_batch_scalar_bitmap(dec128_cmp_op_t op, const decimal128_t *a,
+                                    decimal128_t b, size_t n,
+                                    uint8_t *bitmap);
+
+size_t dec128_cmp_batch_scalar_sel(dec128_cmp_op_t op, const decimal128_t *a,
+                                   decimal128_t b, size_t n, uint32_t *sel);
+
+/* lo <= a[i] && a[i] <= hi */
+void dec128_between_batch_bitmap(const decimal128_t *a, decimal128_t lo,
+                                 decimal128_t hi, size_t n, uint8_t *bitmap);
+
+size_t dec128_between_batch_sel(const decimal128_t *a, decimal128_t lo,
+                                decimal128_t hi, size_t n, uint32_t *sel);
+
+/* a[i] IN (list[0], ..., list[nlist - 1]) */
+void dec128_in_batch_bitmap(const decimal128_t *a, const decimal128_t *list,
+                            size_t nlist, size_t n, uint8_t *bitmap);
+
+size_t dec128_in_batch_sel(const decimal128_t *a, const decimal128_t *list,
+                           size_t nlist, size_t n, uint32_t *sel);
+
+/*
+ * Aggregation kernels (SUM, AVG, MIN, MAX, COUNT).
+ *
+ * The running sum is kept in 192 bits, which cannot overflow for fewer than
+ * 2^64 rows, so no per-row overflow check is done. Range checks happen once
+ * in dec128_agg_sum() / dec128_agg_avg(). Partial states computed on
+ * different threads or vectors can be merged with dec128_agg_combine().
+ */
+typedef struct dec128_agg_t {
+  /* 192-bit two's complement sum, least significant word first */
+  uint64_t sum[3];
+  int64_t count;
+  /* INT128_MAX and INT128_MIN while count is 0, read them through
+   * dec128_agg_min() / dec128_agg_max() */
+  decimal128_t min;
+  decimal128_t max;
+} dec128_agg_t;
+
+void dec128_agg_init(dec128_agg_t *state);
+
+/* validity is an Arrow validity bitmap, rows with a 0 bit are skipped. It
+ * may be NULL if all rows are valid. */
+void dec128_agg_update_batch(dec128_agg_t *state, const decimal128_t *v,
+                             const uint8_t *validity, size_t n);
+
+/* Grouped form: row i is accumulated into states[group_ids[i]]. */
+void dec128_agg_update_grouped(dec128_agg_t *states, const uint32_t *group_ids,
+                               const decimal128_t *v, const uint8_t *validity,
+                               size_t n);
+
+void dec128_agg_combine(dec128_agg_t *state, const dec128_agg_t *other);
+
+/* The sum has the scale of the input. Returns DEC128_STATUS_OVERFLOW if the
+ * sum does not fit in precision digits, DEC128_STATUS_ERROR for an empty
+ * group (count 0), whose SUM is NULL. */
+decimal_status_t dec128_agg_sum(const dec128_agg_t *state, int32_t precision,
+                                decimal128_t *out);
+
+/* MIN and MAX, DEC128_STATUS_ERROR for an empty group (count 0), whose
+ * result is NULL. */
+decimal_status_t dec128_agg_min(const dec128_agg_t *state, decimal128_t *out);
+
+decimal_status_t dec128_agg_max(const dec128_agg_t *state, decimal128_t *out);
+
+/* Average of values with the given scale, rounded half away from zero to
+ * ret_scale, which must not be smaller than scale. */
+decimal_status_t dec128_agg_avg(const dec128_agg_t *state, int32_t scale,
+                                int32_t ret_precision, int32_t ret_scale,
+                                decimal128_t *out);
+
+/*
+ * String conversion for Arrow utf8 columns: row i is
+ * data[offsets[i], offsets[i + 1]), strings are not NUL terminated.
+ */
+
+/* Parse into DECIMAL(precision, scale). Rows that are not a valid decimal,
+ * have nonzero digits beyond scale or do not fit in precision are set to
+ * zero and get their bit set in the errors bitmap (ceil(n / 8) bytes, may
+ * be NULL). Rows with a 0 validity bit are zero and not errors, validity
+ * may be NULL. Returns the number of errors. */
+size_t dec128_from_string_batch(const int32_t *offsets, const char *data,
+                                const uint8_t *validity, size_t n,
+                                int32_t precision, int32_t scale,
+                                decimal128_t *out, uint8_t *errors);
+
+/* Total length of the rows formatted with scale like dec128_to_string,
+ * without NUL terminators. Rows with a 0 validity bit are empty, validity
+ * may be NULL. */
+size_t dec128_to_string_batch_length(const decimal128_t *values,
+                                     const uint8_t *validity, size_t n,
+                                     int32_t scale);
+
+/* Format the rows with scale into data and fill the n + 1 offsets. A
+ * data_size of dec128_to_string_batch_length() bytes is exactly enough,
+ * and must fit in int32 offsets. Returns DEC128_STATUS_ERROR if data_size
+ * is too small. */
+decimal_status_t dec128_to_string_batch(const decimal128_t *values,
+                                        const uint8_t *validity, size_t n,
+                                        int32_t scale, int32_t *offsets,
+                                        char *data, size_t data_size);
+
+/*
+ * Big-endian two's complement bytes, the decimal encoding of Parquet
+ * FIXED_LEN_BYTE_ARRAY and BYTE_ARRAY columns and of Avro bytes. Values of
+ * 1 to 16 bytes are sign extended.
+ */
+
+/* Decode n values of byte_width bytes each. DEC128_STATUS_ERROR if
+ * byte_width is not within 1 to 16. */
+decimal_status_t dec128_from_big_endian_fixed_batch(const uint8_t *data,
+                                                    int32_t byte_width,
+                                                    size_t n,
+                                                    decimal128_t *out);
+
+/* Decode values of varying length, row i is data[offsets[i],
+ * offsets[i + 1]). Rows of 0 or more than 16 bytes are set to zero and get
+ * their bit set in errors (may be NULL), rows with a 0 validity bit are
+ * zero and not errors. Returns the number of errors. */
+size_t dec128_from_big_endian_batch(const int32_t *offsets,
+                                    const uint8_t *data,
+                                    const uint8_t *validity, size_t n,
+                                    decimal128_t *out, uint8_t *errors);
+
+/* Encode n values in byte_width bytes each, DEC128_STATUS_OVERFLOW (and
+ * nothing written) if a value needs more bytes. */
+decimal_status_t dec128_to_big_endian_fixed_batch(const decimal128_t *values,
+                                                  size_t n, int32_t byte_width,
+                                                  uint8_t *data);
+
+/* Encode each value in the fewest bytes and fill the n + 1 offsets, rows
+ * with a 0 validity bit are empty. data must hold 16 * n bytes. Returns the
+ * number of bytes used. */
+size_t dec128_to_big_endian_batch(const decimal128_t *values,
+                                  const uint8_t *validity, size_t n,
+                                  int32_t *offsets, uint8_t *data);
+
+DEC128_EXTERN_END
+
+#endif
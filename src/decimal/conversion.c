@@ -1,9 +1,9 @@
 #include "decimal/basic_decimal.h"
+#include "decimal/batch_decimal.h"
 #include "decimal/bit_util.h"
 #include "decimal/decimal_internal.h"
 #include "decimal/logging.h"
 #include "decimal/macros.h"
-#include "decimal/value_parsing.h"
 #include <assert.h>
 #include <math.h>
 
@@ -375,14 +375,6 @@ double dec128_to_double(decimal128_t decimal, int32_t scale) {
 }
 
 /* string conversion */
-typedef struct decimal_components_t {
-  char whole_digits[DEC128_MAX_STRLEN];
-  char fractional_digits[DEC128_MAX_STRLEN];
-  int32_t exponent;
-  char sign;
-  bool has_exponent;
-} decimal_components_t;
-
 static inline bool IsSign(char c) { return c == '-' || c == '+'; }
 
 static inline bool IsDot(char c) { return c == '.'; }
@@ -391,169 +383,266 @@ static inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
 
 static inline bool StartsExponent(char c) { return c == 'e' || c == 'E'; }
 
-static inline size_t ParseDigitsRun(const char *s, size_t start, size_t size,
-                                    char *out) {
-  size_t pos;
-  for (pos = start; pos < size; ++pos) {
-    if (!IsDigit(s[pos])) {
-      break;
-    }
-  }
-  strncpy(out, s + start, pos - start);
-  return pos;
+// Load 8 characters as a little endian word
+static inline uint64_t LoadEightChars(const char *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+#if !DEC128_LITTLE_ENDIAN
+  v = __builtin_bswap64(v);
+#endif
+  return v;
 }
 
-static bool ParseDecimalComponents(const char *s, decimal_components_t *out) {
-  size_t pos = 0;
-  size_t size = strlen(s);
+// SWAR check that the 8 characters are all in '0'..'9'
+static inline bool IsEightDigits(uint64_t v) {
+  return (((v & 0xF0F0F0F0F0F0F0F0ULL) |
+           (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+          0x3333333333333333ULL);
+}
 
-  if (size == 0) {
-    return false;
-  }
-  // Sign of the number
-  if (IsSign(s[pos])) {
-    out->sign = *(s + pos);
-    ++pos;
-  }
-  // First run of digits
-  pos = ParseDigitsRun(s, pos, size, (char *)out->whole_digits);
-  if (pos == size) {
-    return !(*out->whole_digits == 0);
-  }
-  // Optional dot (if given in fractional form)
-  bool has_dot = IsDot(s[pos]);
-  if (has_dot) {
-    // Second run of digits
-    ++pos;
-    pos = ParseDigitsRun(s, pos, size, out->fractional_digits);
+// SWAR conversion of 8 digits, the first character being the most
+// significant digit
+static inline uint32_t ParseEightDigits(uint64_t v) {
+  const uint64_t mask = 0x000000FF000000FFULL;
+  const uint64_t mul1 = 100 + (1000000ULL << 32);
+  const uint64_t mul2 = 1 + (10000ULL << 32);
+  v -= 0x3030303030303030ULL;
+  v = (v * 10) + (v >> 8);
+  v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+  return (uint32_t)v;
+}
+
+// Multiply a little endian array by multiple and add addend, truncating to
+// out_size words.
+static inline void MultiplyAdd(uint64_t out[], size_t out_size,
+                               uint64_t multiple, uint64_t addend) {
+  for (size_t i = 0; i < out_size; ++i) {
+    __uint128_t tmp = out[i];
+    tmp *= multiple;
+    tmp += addend;
+    out[i] = (uint64_t)(tmp & 0xFFFFFFFFFFFFFFFFULL);
+    addend = (uint64_t)(tmp >> 64);
   }
-  if (*out->whole_digits == 0 && *out->fractional_digits == 0) {
-    // Need at least some digits (whole or fractional)
-    return false;
+}
+
+// Multiply a little endian array by 10^exp, truncating to out_size words.
+static inline void MultiplyByPowerOfTen(uint64_t out[], size_t out_size,
+                                        int32_t exp) {
+  while (exp > 0) {
+    const int32_t step = MIN(exp, kInt64DecimalDigits);
+    MultiplyAdd(out, out_size, kUInt64PowersOfTen[step], 0);
+    exp -= step;
   }
-  if (pos == size) {
-    return true;
+}
+
+static inline const char *SkipZeros(const char *p, const char *last) {
+  while (last - p >= 8 && LoadEightChars(p) == 0x3030303030303030ULL) {
+    p += 8;
   }
-  // Optional exponent
-  if (StartsExponent(s[pos])) {
-    ++pos;
-    if (pos != size && s[pos] == '+') {
-      ++pos;
-    }
-    out->has_exponent = true;
-    return StringToInt32(s + pos, size - pos, &(out->exponent));
+  while (p < last && *p == '0') {
+    p++;
   }
-  return pos == size;
+  return p;
 }
 
-static inline size_t find_first_not_of(char *s, char c) {
-  size_t len = strlen(s);
-  for (size_t i = 0; i < len; i++) {
-    if (s[i] != c) {
-      return i;
+// Accumulate at most max_count digits of the run at p into the little endian
+// array out. Digits are converted 8 at a time into a 64-bit chunk which is
+// folded into out every 16 digits. Returns where accumulation stopped.
+static inline const char *AccumulateDigits(const char *p, const char *last,
+                                           int32_t max_count, uint64_t out[],
+                                           size_t out_size) {
+  const char *limit = last - p > max_count ? p + max_count : last;
+  uint64_t chunk = 0;
+  int32_t chunk_digits = 0;
+  while (limit - p >= 8) {
+    const uint64_t v = LoadEightChars(p);
+    if (!IsEightDigits(v)) {
+      break;
+    }
+    chunk = chunk * 100000000 + ParseEightDigits(v);
+    p += 8;
+    chunk_digits += 8;
+    if (chunk_digits == 16) {
+      MultiplyAdd(out, out_size, kUInt64PowersOfTen[16], chunk);
+      chunk = 0;
+      chunk_digits = 0;
+    }
+  }
+  while (p < limit && IsDigit(*p)) {
+    chunk = chunk * 10 + (uint32_t)(*p - '0');
+    p++;
+    if (++chunk_digits == kInt64DecimalDigits) {
+      MultiplyAdd(out, out_size, kUInt64PowersOfTen[kInt64DecimalDigits],
+                  chunk);
+      chunk = 0;
+      chunk_digits = 0;
     }
   }
-  return -1;
+  if (chunk_digits > 0) {
+    MultiplyAdd(out, out_size, kUInt64PowersOfTen[chunk_digits], chunk);
+  }
+  return p;
 }
 
-// Iterates over input and for each group of kInt64DecimalDigits multiple out by
-// the appropriate power of 10 necessary to add source parsed as uint64 and
-// then adds the parsed value of source.
-static inline void ShiftAndAdd(const char *input, uint64_t out[],
-                               size_t out_size) {
-  size_t len = strlen(input);
-  for (size_t posn = 0; posn < len;) {
-    const size_t group_size = MIN(kInt64DecimalDigits, len - posn);
-    const uint64_t multiple = kUInt64PowersOfTen[group_size];
-    uint64_t chunk = 0;
-
-    if (!StringToUInt64(input + posn, group_size, &chunk)) {
-      // error here
-      fprintf(stderr, "parse uint64 error");
-      return;
+// Exponents are clamped to this magnitude, far beyond any valid scale
+#define kMaxParsedExponent 100000
+
+typedef struct ParsedDecimal {
+  int32_t precision; // digits without leading zeros, fractional ones included
+  int32_t scale;     // fractional digits minus exponent, may be negative
+  bool negative;
+} ParsedDecimal;
+
+// Parse the decimal at the start of [first, last) in a single pass, without
+// copying, accumulating its magnitude into the zeroed little endian array out.
+// Syntax is [+-]digits[.digits][(e|E)[+-]digits], with at least one digit
+// and at most max_digits significant ones: trailing fractional zeros beyond
+// that are dropped, other digits give DEC128_STATUS_OVERFLOW. A malformed
+// exponent is not consumed. On success *end is set past the number.
+static decimal_status_t ParseDecimal(const char *first, const char *last,
+                                     uint64_t out[], size_t out_size,
+                                     int32_t max_digits, ParsedDecimal *parsed,
+                                     const char **end) {
+  const char *p = first;
+  parsed->precision = 0;
+  parsed->scale = 0;
+  parsed->negative = false;
+
+  if (p < last && IsSign(*p)) {
+    parsed->negative = *p == '-';
+    p++;
+  }
+  const char *whole = p;
+  const char *significant = p = SkipZeros(p, last);
+  p = AccumulateDigits(p, last, max_digits, out, out_size);
+  if (p < last && IsDigit(*p)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  const int32_t whole_digits = (int32_t)(p - significant);
+  bool has_digits = p > whole;
+
+  if (p < last && IsDot(*p)) {
+    const char *fraction = ++p;
+    if (whole_digits == 0) {
+      // leading fractional zeros only add to the scale
+      p = SkipZeros(p, last);
     }
-
-    for (size_t i = 0; i < out_size; ++i) {
-      __uint128_t tmp = out[i];
-      tmp *= multiple;
-      tmp += chunk;
-      out[i] = (uint64_t)(tmp & 0xFFFFFFFFFFFFFFFFULL);
-      chunk = (uint64_t)(tmp >> 64);
+    p = AccumulateDigits(p, last, max_digits - whole_digits, out, out_size);
+    parsed->scale = (int32_t)(p - fraction);
+    p = SkipZeros(p, last);
+    if (p < last && IsDigit(*p)) {
+      return DEC128_STATUS_OVERFLOW;
     }
-    posn += group_size;
+    has_digits |= p > fraction;
   }
-}
-
-static decimal_status_t DecimalFromString(const char *s, decimal128_t *out,
-                                          int32_t *precision, int32_t *scale) {
-  if (!s || *s == 0) {
-    // return Status::Invalid("Empty string cannot be converted to ",
-    // type_name);
+  if (!has_digits) {
     return DEC128_STATUS_ERROR;
   }
-
-  decimal_components_t dec = {0};
-  if (!ParseDecimalComponents(s, &dec)) {
-    // return Status::Invalid("The string '", s, "' is not a valid ", type_name,
-    // " number");
-    return DEC128_STATUS_ERROR;
+  parsed->precision = whole_digits + parsed->scale;
+
+  if (p + 1 < last && StartsExponent(*p)) {
+    const char *e = p + 1;
+    bool negative_exponent = false;
+    if (IsSign(*e)) {
+      negative_exponent = *e == '-';
+      e++;
+    }
+    if (e < last && IsDigit(*e)) {
+      int32_t exponent = 0;
+      for (; e < last && IsDigit(*e); e++) {
+        exponent = MIN(exponent * 10 + (*e - '0'), kMaxParsedExponent);
+      }
+      parsed->scale -= negative_exponent ? -exponent : exponent;
+      p = e;
+    }
   }
+  *end = p;
+  return DEC128_STATUS_SUCCESS;
+}
 
-  // Count number of significant digits (without leading zeros)
-  size_t first_non_zero = find_first_not_of(dec.whole_digits, '0');
-  size_t significant_digits = strlen(dec.fractional_digits);
-  if (first_non_zero != (size_t)-1) {
-    significant_digits += strlen(dec.whole_digits) - first_non_zero;
+// Parse [first, last) into the magnitude of the unscaled value as a little
+// endian array of out_size words, its sign, precision and scale. When end is
+// NULL the whole range must be a number.
+static decimal_status_t
+DecimalFromChars(const char *first, const char *last, uint64_t out[],
+                 size_t out_size, int32_t max_digits, int32_t max_scale,
+                 bool *negative, int32_t *precision, int32_t *scale,
+                 const char **end) {
+  ParsedDecimal parsed;
+  const char *stop;
+  memset(out, 0, sizeof(uint64_t) * out_size);
+  decimal_status_t status =
+      ParseDecimal(first, last, out, out_size, max_digits, &parsed, &stop);
+  if (status != DEC128_STATUS_SUCCESS) {
+    return status;
   }
-  int32_t parsed_precision = (int32_t)(significant_digits);
-
-  int32_t parsed_scale = 0;
-  if (dec.has_exponent) {
-    int32_t adjusted_exponent = dec.exponent;
-    parsed_scale = -adjusted_exponent + (int32_t)strlen(dec.fractional_digits);
-  } else {
-    parsed_scale = (int32_t)strlen(dec.fractional_digits);
-  }
-
-  if (out != NULL) {
-    size_t N = DEC128_BIT_WIDTH / 64;
-    uint64_t little_endian_array[N];
-    memset(little_endian_array, 0, sizeof(little_endian_array));
-    ShiftAndAdd(dec.whole_digits, little_endian_array, N);
-    ShiftAndAdd(dec.fractional_digits, little_endian_array, N);
-    *out = dec128_from_hilo((int64_t)little_endian_array[1],
-                            little_endian_array[0]);
-    if (dec.sign == '-') {
-      *out = dec128_negate(*out);
-    }
+  if (end != NULL) {
+    *end = stop;
+  } else if (stop != last) {
+    return DEC128_STATUS_ERROR;
   }
 
-  if (parsed_scale < 0) {
+  if (parsed.scale < 0) {
     // Force the scale to zero, to avoid negative scales (due to compatibility
     // issues with external systems such as databases)
-    if (-parsed_scale > DEC128_MAX_SCALE) {
-      // return Status::Invalid("The string '", s, "' cannot be represented as
-      // ", type_name);
+    if (-parsed.scale > max_scale) {
       return DEC128_STATUS_ERROR;
     }
-    if (out != NULL) {
-      decimal128_t multiplier = dec128_get_scale_multiplier(-parsed_scale);
-      *out = dec128_multiply(*out, multiplier);
+    if (parsed.precision - parsed.scale > max_digits) {
+      return DEC128_STATUS_OVERFLOW;
     }
-    parsed_precision -= parsed_scale;
-    parsed_scale = 0;
+    MultiplyByPowerOfTen(out, out_size, -parsed.scale);
+    parsed.precision -= parsed.scale;
+    parsed.scale = 0;
   }
 
+  *negative = parsed.negative;
   if (precision != NULL) {
-    *precision = parsed_precision;
+    *precision = parsed.precision;
   }
   if (scale != NULL) {
-    *scale = parsed_scale;
+    *scale = parsed.scale;
   }
-
   return DEC128_STATUS_SUCCESS;
 }
 
+// Rescale a parsed magnitude to scale, false if that loses digits or the
+// result does not fit in precision
+static inline bool ParsedToDecimal128(const ParsedDecimal *parsed,
+                                      const uint64_t words[2],
+                                      int32_t precision, int32_t scale,
+                                      decimal128_t *out) {
+  __uint128_t m = ((__uint128_t)words[1] << 64) | words[0];
+  const int32_t delta = scale - parsed->scale;
+  if (m != 0) {
+    if (delta > 0) {
+      if (delta >= precision || m >= UInt128PowerOfTen(precision - delta)) {
+        return false;
+      }
+      m *= UInt128PowerOfTen(delta);
+    } else {
+      if (delta < 0) {
+        __uint128_t remainder;
+        if (-delta > DEC128_MAX_PRECISION) {
+          return false;
+        }
+        m = UInt128DivideByPowerOfTen(m, -delta, &remainder);
+        if (remainder != 0) {
+          return false;
+        }
+      }
+      if (m >= UInt128PowerOfTen(precision)) {
+        return false;
+      }
+    }
+  }
+  if (parsed->negative) {
+    m = -m;
+  }
+  *out = dec128_from_int128((__int128)m);
+  return true;
+}
+
 /* print */
 void dec128_print(FILE *fp, decimal128_t v, int precision, int scale) {
   // DECIMAL: Formula: unscaledValue * 10^(-scale)
@@ -599,163 +688,267 @@ void dec128_print(FILE *fp, decimal128_t v, int precision, int scale) {
   fprintf(fp, "\n");
 }
 
-static void AppendLittleEndianArrayToString(const uint64_t array[], size_t n,
-                                            char *result) {
+// Two digit lookup table, 00 to 99
+static const char kDigitPairs[200 + 1] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Write the decimal digits of v backwards, ending at end. At least min_digits
+// are written, padding with leading zeros. Returns the first digit.
+static inline char *FormatUInt64(uint64_t v, char *end, int32_t min_digits) {
+  char *p = end;
+  while (v >= 100) {
+    p -= 2;
+    memcpy(p, &kDigitPairs[2 * (v % 100)], 2);
+    v /= 100;
+  }
+  if (v >= 10) {
+    p -= 2;
+    memcpy(p, &kDigitPairs[2 * v], 2);
+  } else {
+    *--p = (char)('0' + v);
+  }
+  while (end - p < min_digits) {
+    *--p = '0';
+  }
+  return p;
+}
 
-  size_t most_significant_elem_idx = n;
-  for (size_t i = 0; i < n; i++) {
-    if (array[i] != 0) {
-      most_significant_elem_idx = i;
+// Write the decimal digits of the little endian array of n words backwards,
+// ending at end, splitting off 19 digits at a time with a division by 10^19
+// through its reciprocal. The array is destroyed. Returns the first digit.
+static char *FormatWords(uint64_t words[], size_t n, char *end) {
+  const UInt64Reciprocal *r = &kPowersOfTenReciprocals[19];
+  while (n > 1 && words[n - 1] == 0) {
+    n--;
+  }
+  while (n > 1) {
+    // the value is at least 2^64, so the quotient is not zero and the
+    // remainder gets all of its 19 digits
+    uint64_t remainder = 0;
+    for (size_t i = n; i-- > 0;) {
+      words[i] = Div2By1(remainder, words[i], r->divisor, r->reciprocal,
+                         &remainder);
+    }
+    end = FormatUInt64(remainder, end, 19);
+    while (words[n - 1] == 0) {
+      n--;
     }
   }
+  return FormatUInt64(words[0], end, 1);
+}
 
-  if (most_significant_elem_idx == n) {
-    strcpy(result, "0");
-    return;
-  }
+// Number of decimal digits of m, 1 for zero
+static inline int32_t UInt128Digits(__uint128_t m) {
+  m |= 1;
+  const uint64_t high = (uint64_t)(m >> 64);
+  const int32_t bits = high ? 128 - CountLeadingZerosInt64(high)
+                            : 64 - CountLeadingZerosInt64((uint64_t)m);
+  // bits * log10(2) is within one of the digit count
+  const int32_t t = (bits * 1233) >> 12;
+  return t + 1 - (m < UInt128PowerOfTen(t));
+}
 
-  uint64_t copy[n];
-  memcpy(copy, array, sizeof(uint64_t) * n);
-  const uint32_t k1e9 = 1000000000U;
-  const size_t kNumBits = n * 64;
-  // Segments will contain the array split into groups that map to decimal
-  // digits, in little endian order. Each segment will hold at most 9 decimal
-  // digits. For example, if the input represents 9876543210123456789, then
-  // segments will be [123456789, 876543210, 9]. The max number of segments
-  // needed = ceil(kNumBits * log(2) / log(1e9)) = ceil(kNumBits / 29.897352854)
-  // <= ceil(kNumBits / 29).
-  uint32_t segments[(kNumBits + 28) / 29];
-  size_t num_segments = 0;
-  uint64_t *most_significant_elem = &copy[most_significant_elem_idx];
-  do {
-    // Compute remainder = copy % 1e9 and copy = copy / 1e9.
-    uint32_t remainder = 0;
-    uint64_t *elem = most_significant_elem;
-    do {
-      // Compute dividend = (remainder << 32) | *elem  (a virtual 96-bit
-      // integer); *elem = dividend / 1e9; remainder = dividend % 1e9.
-      uint32_t hi = (uint32_t)(*elem >> 32);
-      uint32_t lo = (uint32_t)(*elem & LeastSignificantBitMask(32));
-      uint64_t dividend_hi = (((uint64_t)(remainder)) << 32) | hi;
-      uint64_t quotient_hi = dividend_hi / k1e9;
-      remainder = (uint32_t)(dividend_hi % k1e9);
-      uint64_t dividend_lo = (((uint64_t)(remainder)) << 32) | lo;
-      uint64_t quotient_lo = dividend_lo / k1e9;
-      remainder = (uint32_t)(dividend_lo % k1e9);
-      *elem = (quotient_hi << 32) | quotient_lo;
-    } while (elem-- != copy);
-
-    segments[num_segments++] = remainder;
-  } while (*most_significant_elem != 0 || most_significant_elem-- != copy);
-
-  char *output = result;
-  const uint32_t *segment = &segments[num_segments - 1];
-  output += sprintf(output, "%u", *segment);
-
-  while (segment != segments) {
-    --segment;
-    // Right-pad formatted segment such that e.g. 123 is formatted as
-    // "000000123".
-    output += sprintf(output, "%09u", *segment);
-  }
-}
-
-static void AdjustIntegerStringWithScale(char *str, int32_t scale,
-                                         char *result) {
-  if (scale == 0) {
-    strcpy(result, str);
-    return;
-  }
-  DCHECK(str != NULL);
-  DCHECK(!(*str == 0));
-  const bool is_negative = *str == '-';
-  const int32_t is_negative_offset = (int32_t)(is_negative);
-  const int32_t len = strlen(str);
-  const int32_t num_digits = len - is_negative_offset;
-  const int32_t adjusted_exponent = num_digits - 1 - scale;
-  char *out = result;
-
-  /// Note that the -6 is taken from the Java BigDecimal documentation.
-  if (scale < 0 || adjusted_exponent < -6) {
-    // Example 1:
-    // Precondition: *str = "123", is_negative_offset = 0, num_digits = 3, scale
-    // = -2,
-    //               adjusted_exponent = 4
-    // After inserting decimal point: *str = "1.23"
-    // After appending exponent: *str = "1.23E+4"
-    // Example 2:
-    // Precondition: *str = "-123", is_negative_offset = 1, num_digits = 3,
-    // scale = 9,
-    //               adjusted_exponent = -7
-    // After inserting decimal point: *str = "-1.23"
-    // After appending exponent: *str = "-1.23E-7"
-
-    int32_t dotpos = 1 + is_negative_offset;
-    strncpy(out, str, dotpos);
-    out += dotpos;
-    out += sprintf(out, ".");
-    out += sprintf(out, "%s", str + dotpos);
-    out += sprintf(out, "E");
-    if (adjusted_exponent >= 0) {
-      out += sprintf(out, "+");
+// Scientific notation is used for a negative scale or when the adjusted
+// exponent is below -6, as Java's BigDecimal does
+static inline bool IsScientific(int64_t adjusted_exponent, int32_t scale) {
+  return scale < 0 || adjusted_exponent < -6;
+}
+
+// Length of a value of num_digits digits laid out by FormatScaled
+static inline int64_t ScaledLength(int32_t num_digits, bool negative,
+                                   int32_t scale) {
+  const int64_t adjusted_exponent = (int64_t)num_digits - 1 - scale;
+  if (IsScientific(adjusted_exponent, scale)) {
+    uint64_t abs_exponent = adjusted_exponent < 0
+                                ? (uint64_t)-adjusted_exponent
+                                : (uint64_t)adjusted_exponent;
+    int64_t exponent_digits = 1;
+    while (abs_exponent >= 10) {
+      abs_exponent /= 10;
+      exponent_digits++;
     }
-    out += sprintf(out, "%d", adjusted_exponent);
-    return;
+    // "d." digits "E" sign exponent
+    return negative + num_digits + 3 + exponent_digits;
+  }
+  if (scale == 0) {
+    return negative + num_digits;
   }
+  return negative + 1 + MAX(num_digits, scale + 1);
+}
 
-  if (num_digits > scale) {
-    const size_t n = (size_t)(len - scale);
-    // Example 1:
-    // Precondition: *str = "123", len = num_digits = 3, scale = 1, n = 2
-    // After inserting decimal point: *str = "12.3"
-    // Example 2:
-    // Precondition: *str = "-123", len = 4, num_digits = 3, scale = 1, n = 3
-    // After inserting decimal point: *str = "-12.3"
-    memcpy(out, str, n);
-    out += n;
-    out += sprintf(out, ".");
-    out += sprintf(out, "%s", str + n);
-    return;
+// Lay out the digits of a value with scale in [first, last): plain digits at
+// scale 0, scientific notation when IsScientific, otherwise with a decimal
+// point. Returns the length, or -1 if it does not fit.
+static int32_t FormatScaled(const char *digits, int32_t num_digits,
+                            bool negative, int32_t scale, char *first,
+                            char *last) {
+  DCHECK_GE(num_digits, 1);
+  const int64_t adjusted_exponent = (int64_t)num_digits - 1 - scale;
+  const bool scientific = IsScientific(adjusted_exponent, scale);
+  const int64_t length = ScaledLength(num_digits, negative, scale);
+  if (length > last - first) {
+    return -1;
   }
 
-  // Example 1:
-  // Precondition: *str = "123", is_negative_offset = 0, num_digits = 3, scale =
-  // 4 After insert: *str = "000123" After setting decimal point: *str =
-  // "0.0123" Example 2: Precondition: *str = "-123", is_negative_offset = 1,
-  // num_digits = 3, scale = 4 After insert: *str = "-000123" After setting
-  // decimal point: *str = "-0.0123"
-  char *p = out;
-  if (is_negative) {
-    *p = '-';
-    p++;
+  char *p = first;
+  if (negative) {
+    *p++ = '-';
   }
-  for (int i = 0; i < scale - num_digits + 2; i++) {
-    *p = '0';
-    p++;
+  if (scientific) {
+    // unsigned so the length after the first digit is never a huge size_t
+    const uint32_t tail = (uint32_t)num_digits - 1;
+    *p++ = digits[0];
+    *p++ = '.';
+    memcpy(p, digits + 1, tail);
+    p += tail;
+    *p++ = 'E';
+    *p++ = adjusted_exponent < 0 ? '-' : '+';
+    const uint64_t abs_exponent = adjusted_exponent < 0
+                                      ? (uint64_t)-adjusted_exponent
+                                      : (uint64_t)adjusted_exponent;
+    FormatUInt64(abs_exponent, first + length, 1);
+  } else if (scale == 0) {
+    memcpy(p, digits, num_digits);
+  } else if (num_digits > scale) {
+    const int32_t whole = num_digits - scale;
+    memcpy(p, digits, whole);
+    p += whole;
+    *p++ = '.';
+    memcpy(p, digits + whole, scale);
+  } else {
+    *p++ = '0';
+    *p++ = '.';
+    memset(p, '0', scale - num_digits);
+    p += scale - num_digits;
+    memcpy(p, digits, num_digits);
   }
-  p += sprintf(p, "%s", str + is_negative_offset);
-  out[is_negative_offset + 1] = '.';
+  return (int32_t)length;
 }
 
 /* input */
+decimal_status_t dec128_from_chars(const char *first, const char *last,
+                                   decimal128_t *out, int32_t *precision,
+                                   int32_t *scale, const char **end) {
+  uint64_t little_endian_array[NWORDS];
+  bool negative;
+  decimal_status_t status = DecimalFromChars(
+      first, last, little_endian_array, NWORDS, DEC128_MAX_PRECISION,
+      DEC128_MAX_SCALE, &negative, precision, scale, end);
+  if (status != DEC128_STATUS_SUCCESS || out == NULL) {
+    return status;
+  }
+  *out = dec128_from_hilo((int64_t)little_endian_array[1],
+                          little_endian_array[0]);
+  if (negative) {
+    *out = dec128_negate(*out);
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
 decimal_status_t dec128_from_string(const char *s, decimal128_t *out,
                                     int32_t *precision, int32_t *scale) {
-  return DecimalFromString(s, out, precision, scale);
+  if (!s) {
+    return DEC128_STATUS_ERROR;
+  }
+  return dec128_from_chars(s, s + strlen(s), out, precision, scale, NULL);
+}
+
+decimal_status_t dec256_from_chars(const char *first, const char *last,
+                                   decimal256_t *out, int32_t *precision,
+                                   int32_t *scale, const char **end) {
+  uint64_t little_endian_array[DEC256_NWORDS];
+  bool negative;
+  decimal_status_t status = DecimalFromChars(
+      first, last, little_endian_array, DEC256_NWORDS, DEC256_MAX_PRECISION,
+      DEC256_MAX_SCALE, &negative, precision, scale, end);
+  if (status != DEC128_STATUS_SUCCESS || out == NULL) {
+    return status;
+  }
+  *out = dec256_from_le_words(little_endian_array);
+  if (negative) {
+    *out = dec256_negate(*out);
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec256_from_string(const char *s, decimal256_t *out,
+                                    int32_t *precision, int32_t *scale) {
+  if (!s) {
+    return DEC128_STATUS_ERROR;
+  }
+  return dec256_from_chars(s, s + strlen(s), out, precision, scale, NULL);
+}
+
+decimal_status_t dec128_from_big_endian(const uint8_t *bytes, int32_t length,
+                                        decimal128_t *out) {
+  if (length < 1 || length > 16) {
+    return DEC128_STATUS_ERROR;
+  }
+  *out = DecimalFromBigEndian(bytes, length);
+  return DEC128_STATUS_SUCCESS;
+}
+
+size_t dec128_from_string_batch(const int32_t *offsets, const char *data,
+                                const uint8_t *validity, size_t n,
+                                int32_t precision, int32_t scale,
+                                decimal128_t *out, uint8_t *errors) {
+  DCHECK_GT(precision, 0);
+  DCHECK_LE(precision, DEC128_MAX_PRECISION);
+  DCHECK_GE(scale, 0);
+  DCHECK_LE(scale, precision);
+
+  size_t nerrors = 0;
+  if (errors) {
+    memset(errors, 0, (n + 7) / 8);
+  }
+  for (size_t i = 0; i < n; i++) {
+    out[i] = (decimal128_t){0};
+    if (validity && !((validity[i / 8] >> (i % 8)) & 1)) {
+      continue;
+    }
+    const char *first = data + offsets[i];
+    const char *last = data + offsets[i + 1];
+    uint64_t words[NWORDS] = {0};
+    ParsedDecimal parsed;
+    const char *end;
+    if (DEC128_PREDICT_FALSE(
+            ParseDecimal(first, last, words, NWORDS, DEC128_MAX_PRECISION,
+                         &parsed, &end) != DEC128_STATUS_SUCCESS ||
+            end != last ||
+            !ParsedToDecimal128(&parsed, words, precision, scale, &out[i]))) {
+      out[i] = (decimal128_t){0};
+      if (errors) {
+        errors[i / 8] |= (uint8_t)(1U << (i % 8));
+      }
+      nerrors++;
+    }
+  }
+  return nerrors;
 }
 
 /* output to various formats */
-decimal_status_t dec128_to_integer_string(decimal128_t v, char *out) {
-  char *p = out;
-  if (dec128_high_bits(v) < 0) {
-    *p = '-';
-    p++;
-    decimal128_t abs = dec128_negate(v);
-    uint64_t array[] = {dec128_low_bits(abs), (uint64_t)dec128_high_bits(abs)};
-    AppendLittleEndianArrayToString(array, 2, p);
-  } else {
-    uint64_t array[] = {dec128_low_bits(v), (uint64_t)dec128_high_bits(v)};
-    AppendLittleEndianArrayToString(array, 2, p);
+int32_t dec128_to_chars(decimal128_t v, char *first, char *last,
+                        int32_t scale) {
+  const bool negative = dec128_high_bits(v) < 0;
+  if (negative) {
+    v = dec128_negate(v);
   }
+  uint64_t array[] = {dec128_low_bits(v), (uint64_t)dec128_high_bits(v)};
+  char digits[DEC128_MAX_PRECISION + 1];
+  char *end = digits + sizeof(digits);
+  const char *start = FormatWords(array, NWORDS, end);
+  return FormatScaled(start, (int32_t)(end - start), negative, scale, first,
+                      last);
+}
+
+decimal_status_t dec128_to_integer_string(decimal128_t v, char *out) {
+  int32_t length = dec128_to_chars(v, out, out + DEC128_MAX_STRLEN - 1, 0);
+  DCHECK_GE(length, 0);
+  out[length] = 0;
   return DEC128_STATUS_SUCCESS;
 }
 
@@ -767,9 +960,317 @@ int64_t dec128_to_int64(decimal128_t v) {
 }
 
 void dec128_to_string(decimal128_t v, char *out, int32_t scale) {
-  decimal_status_t s;
-  char intstr[DEC128_MAX_STRLEN];
-  s = dec128_to_integer_string(v, intstr);
-  DCHECK_OK(s);
-  AdjustIntegerStringWithScale(intstr, scale, out);
+  int32_t length = dec128_to_chars(v, out, out + DEC128_MAX_STRLEN - 1, scale);
+  DCHECK_GE(length, 0);
+  out[length < 0 ? 0 : length] = 0;
+}
+
+size_t dec128_to_string_batch_length(const decimal128_t *values,
+                                     const uint8_t *validity, size_t n,
+                                     int32_t scale) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (validity && !((validity[i / 8] >> (i % 8)) & 1)) {
+      continue;
+    }
+    const bool negative = dec128_high_bits(values[i]) < 0;
+    __uint128_t m = (__uint128_t)dec128_to_int128(values[i]);
+    if (negative) {
+      m = -m;
+    }
+    total += (size_t)ScaledLength(UInt128Digits(m), negative, scale);
+  }
+  return total;
+}
+
+decimal_status_t dec128_to_string_batch(const decimal128_t *values,
+                                        const uint8_t *validity, size_t n,
+                                        int32_t scale, int32_t *offsets,
+                                        char *data, size_t data_size) {
+  char *p = data;
+  char *last = data + data_size;
+  offsets[0] = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (!validity || ((validity[i / 8] >> (i % 8)) & 1)) {
+      const int32_t length = dec128_to_chars(values[i], p, last, scale);
+      if (DEC128_PREDICT_FALSE(length < 0)) {
+        return DEC128_STATUS_ERROR;
+      }
+      p += length;
+    }
+    offsets[i + 1] = (int32_t)(p - data);
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+int32_t dec128_to_big_endian(decimal128_t v, uint8_t *out) {
+  uint8_t bytes[16];
+  const int32_t length = DecimalBigEndianLength(v);
+  DecimalToBigEndian(v, bytes);
+  memcpy(out, bytes + 16 - length, length);
+  return length;
+}
+
+int32_t dec256_to_chars(decimal256_t v, char *first, char *last,
+                        int32_t scale) {
+  const bool negative = dec256_is_negative(v);
+  if (negative) {
+    v = dec256_negate(v);
+  }
+  uint64_t array[DEC256_NWORDS];
+  dec256_to_le_words(v, array);
+  char digits[DEC256_MAX_PRECISION + 1];
+  char *end = digits + sizeof(digits);
+  const char *start = FormatWords(array, DEC256_NWORDS, end);
+  return FormatScaled(start, (int32_t)(end - start), negative, scale, first,
+                      last);
+}
+
+decimal_status_t dec256_to_integer_string(decimal256_t v, char *out) {
+  int32_t length = dec256_to_chars(v, out, out + DEC256_MAX_STRLEN - 1, 0);
+  DCHECK_GE(length, 0);
+  out[length] = 0;
+  return DEC128_STATUS_SUCCESS;
+}
+
+void dec256_to_string(decimal256_t v, char *out, int32_t scale) {
+  int32_t length = dec256_to_chars(v, out, out + DEC256_MAX_STRLEN - 1, scale);
+  DCHECK_GE(length, 0);
+  out[length < 0 ? 0 : length] = 0;
+}
+
+/* decimal256 real conversion */
+
+// Working width for real to decimal256 conversion: a float mantissa shifted
+// left by up to 104 bits and multiplied by 10^76 needs 381 bits.
+#define REAL_WORDS 6
+
+static inline void ShiftLeftWords(uint64_t *words, size_t n, int bits) {
+  const int word_shift = bits / 64;
+  const int bit_shift = bits % 64;
+  for (size_t i = n; i-- > 0;) {
+    uint64_t w = 0;
+    if (i >= (size_t)word_shift) {
+      w = words[i - word_shift] << bit_shift;
+      if (bit_shift != 0 && i > (size_t)word_shift) {
+        w |= words[i - word_shift - 1] >> (64 - bit_shift);
+      }
+    }
+    words[i] = w;
+  }
+}
+
+// Right shift by `bits`, rounded half to even
+static inline void RoundedRightShiftWords(uint64_t *words, size_t n,
+                                          int bits) {
+  if (bits == 0) {
+    return;
+  }
+  if ((size_t)bits > n * 64) {
+    // everything is shifted out and the value is below one half
+    memset(words, 0, n * sizeof(uint64_t));
+    return;
+  }
+  const int half = bits - 1;
+  const bool round_bit = (words[half / 64] >> (half % 64)) & 1;
+  bool sticky = (words[half / 64] & LeastSignificantBitMask(half % 64)) != 0;
+  for (int i = 0; i < half / 64; i++) {
+    sticky |= words[i] != 0;
+  }
+
+  const int word_shift = bits / 64;
+  const int bit_shift = bits % 64;
+  for (size_t i = 0; i < n; i++) {
+    uint64_t w = 0;
+    if (i + word_shift < n) {
+      w = words[i + word_shift] >> bit_shift;
+      if (bit_shift != 0 && i + word_shift + 1 < n) {
+        w |= words[i + word_shift + 1] << (64 - bit_shift);
+      }
+    }
+    words[i] = w;
+  }
+
+  if (round_bit && (sticky || (words[0] & 1))) {
+    for (size_t i = 0; i < n && ++words[i] == 0; i++) {
+    }
+  }
+}
+
+static inline decimal_status_t WordsToDecimal256(const uint64_t *words,
+                                                 int32_t precision,
+                                                 decimal256_t *out) {
+  if (words[4] != 0 || words[5] != 0 || (int64_t)words[3] < 0) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  decimal256_t x = dec256_from_le_words(words);
+  if (!dec256_fits_in_precision(x, precision)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = x;
+  return DEC128_STATUS_SUCCESS;
+}
+
+#define FROM_POSITIVE_REAL_256(REAL)                                           \
+  {                                                                            \
+    const int kMantissaBits = trait_##REAL.kMantissaBits;                      \
+    uint64_t words[REAL_WORDS] = {0};                                          \
+    int binary_exp = 0;                                                        \
+                                                                               \
+    if (scale < 0) {                                                           \
+      /* Approximate algorithm in the FP domain, as for decimal128 */          \
+      const REAL x = rint(real * PowerOfTen_##REAL(scale));                    \
+      if (x >= PowerOfTen_##REAL(precision)) {                                 \
+        return DEC128_STATUS_OVERFLOW;                                         \
+      }                                                                        \
+      /* x is an integer, so its binary exponent is at least the number of    \
+       * mantissa bits unless it is small enough to fit exactly */             \
+      const REAL x_mant = frexp(x, &binary_exp);                               \
+      words[0] = (uint64_t)(ldexp(x_mant, kMantissaBits));                     \
+      const int k = binary_exp - kMantissaBits;                                \
+      if (k >= 0) {                                                            \
+        ShiftLeftWords(words, REAL_WORDS, k);                                  \
+      } else {                                                                 \
+        RoundedRightShiftWords(words, REAL_WORDS, -k);                         \
+      }                                                                        \
+      return WordsToDecimal256(words, precision, out);                         \
+    }                                                                          \
+                                                                               \
+    /* 1. Check that `real` is within acceptable bounds. */                    \
+    const REAL limit = PowerOfTen_##REAL(precision - scale);                   \
+    if (real > limit) {                                                        \
+      return DEC128_STATUS_OVERFLOW;                                           \
+    }                                                                          \
+                                                                               \
+    /* 2. Losslessly convert `real` to `mant * 2**k` */                        \
+    const REAL real_mant = frexp(real, &binary_exp);                           \
+    words[0] = (uint64_t)(ldexp(real_mant, kMantissaBits));                    \
+    const int k = binary_exp - kMantissaBits;                                  \
+                                                                               \
+    /* 3. `mant * 10^scale * 2^k` is computed exactly in REAL_WORDS words,     \
+     * so unlike decimal128 no iterative shift and multiply is needed. */      \
+    MultiplyByPowerOfTen(words, REAL_WORDS, scale);                            \
+    if (k >= 0) {                                                              \
+      ShiftLeftWords(words, REAL_WORDS, k);                                    \
+    } else {                                                                   \
+      RoundedRightShiftWords(words, REAL_WORDS, -k);                           \
+    }                                                                          \
+    return WordsToDecimal256(words, precision, out);                           \
+  }
+
+static decimal_status_t FromPositiveReal256_float(float real,
+                                                  int32_t precision,
+                                                  int32_t scale,
+                                                  decimal256_t *out) {
+  FROM_POSITIVE_REAL_256(float);
+}
+
+static decimal_status_t FromPositiveReal256_double(double real,
+                                                   int32_t precision,
+                                                   int32_t scale,
+                                                   decimal256_t *out) {
+  FROM_POSITIVE_REAL_256(double);
+}
+
+#define FROM_REAL_256(REAL)                                                    \
+  {                                                                            \
+    DCHECK_GT(precision, 0);                                                   \
+    DCHECK_LE(precision, trait_dec256.kMaxPrecision);                          \
+    DCHECK_GE(scale, -trait_dec256.kMaxScale);                                 \
+    DCHECK_LE(scale, trait_dec256.kMaxScale);                                  \
+                                                                               \
+    if (!isfinite(x)) {                                                        \
+      return DEC128_STATUS_ERROR;                                              \
+    }                                                                          \
+    if (x < 0) {                                                               \
+      decimal_status_t s =                                                     \
+          FromPositiveReal256_##REAL(-x, precision, scale, out);               \
+      if (s != DEC128_STATUS_SUCCESS) {                                        \
+        return s;                                                              \
+      }                                                                        \
+      *out = dec256_negate(*out);                                              \
+      return DEC128_STATUS_SUCCESS;                                            \
+    } else {                                                                   \
+      return FromPositiveReal256_##REAL(x, precision, scale, out);             \
+    }                                                                          \
+  }
+
+decimal_status_t dec256_from_float(float x, decimal256_t *out,
+                                   int32_t precision, int32_t scale) {
+  FROM_REAL_256(float);
+}
+
+decimal_status_t dec256_from_double(double x, decimal256_t *out,
+                                    int32_t precision, int32_t scale) {
+  FROM_REAL_256(double);
+}
+
+#define TO_REAL_POSITIVE_NO_SPLIT_256(REAL)                                    \
+  {                                                                            \
+    uint64_t words[DEC256_NWORDS];                                             \
+    dec256_to_le_words(decimal, words);                                        \
+    REAL x = two_to_192_##REAL((REAL)(words[3]));                              \
+    x += two_to_128_##REAL((REAL)(words[2]));                                  \
+    x += two_to_64_##REAL((REAL)(words[1]));                                   \
+    x += (REAL)(words[0]);                                                     \
+    x *= LargePowerOfTen_##REAL(-scale);                                       \
+    return x;                                                                  \
+  }
+
+static float ToRealPositiveNoSplit256_float(decimal256_t decimal,
+                                            int32_t scale) {
+  TO_REAL_POSITIVE_NO_SPLIT_256(float);
+}
+
+static double ToRealPositiveNoSplit256_double(decimal256_t decimal,
+                                              int32_t scale) {
+  TO_REAL_POSITIVE_NO_SPLIT_256(double);
+}
+
+/// Same guarantees as TO_REAL_POSITIVE for decimal128.
+#define TO_REAL_POSITIVE_256(REAL)                                             \
+  {                                                                            \
+    if (scale <= 0 ||                                                          \
+        dec256_cmple(decimal,                                                  \
+                     dec256_from_int64(trait_##REAL.kMaxPreciseInteger))) {    \
+      return ToRealPositiveNoSplit256_##REAL(decimal, scale);                  \
+    }                                                                          \
+                                                                               \
+    decimal256_t whole_decimal, fraction_decimal;                              \
+    dec256_get_whole_and_fraction(decimal, scale, &whole_decimal,              \
+                                  &fraction_decimal);                          \
+                                                                               \
+    REAL whole = ToRealPositiveNoSplit256_##REAL(whole_decimal, 0);            \
+    REAL fraction = ToRealPositiveNoSplit256_##REAL(fraction_decimal, scale);  \
+                                                                               \
+    return whole + fraction;                                                   \
+  }
+
+static float ToRealPositive256_float(decimal256_t decimal, int32_t scale) {
+  TO_REAL_POSITIVE_256(float);
+}
+
+static double ToRealPositive256_double(decimal256_t decimal, int32_t scale) {
+  TO_REAL_POSITIVE_256(double);
+}
+
+#define TO_REAL_256(REAL)                                                      \
+  {                                                                            \
+    DCHECK_GE(scale, -trait_dec256.kMaxScale);                                 \
+    DCHECK_LE(scale, trait_dec256.kMaxScale);                                  \
+    if (dec256_is_negative(decimal)) {                                         \
+      /* Convert the absolute value to avoid precision loss */                 \
+      decimal256_t abs = dec256_negate(decimal);                               \
+      return -ToRealPositive256_##REAL(abs, scale);                            \
+    } else {                                                                   \
+      return ToRealPositive256_##REAL(decimal, scale);                         \
+    }                                                                          \
+  }
+
+float dec256_to_float(decimal256_t decimal, int32_t scale) {
+  TO_REAL_256(float);
+}
+
+double dec256_to_double(decimal256_t decimal, int32_t scale) {
+  TO_REAL_256(double);
 }
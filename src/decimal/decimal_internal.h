@@ -2,6 +2,7 @@
 #define DECIMAL_INTERNAL_H_
 
 #include "decimal/basic_decimal.h"
+#include "decimal/macros.h"
 #include <limits.h>
 #include <math.h>
 #include <stdint.h>
@@ -33,6 +34,116 @@ static const uint64_t kUInt64PowersOfTen[kInt64DecimalDigits + 1] = {
     // clang-format on
 };
 
+/*
+ * Division by invariant integers, see Moller and Granlund, "Improved
+ * division by invariant integers". Dividing by one of the fixed powers of
+ * ten costs a couple of multiplies instead of a long division.
+ */
+
+// A divisor shifted left until its top bit is set, and the reciprocal
+// floor((2^128 - 1) / divisor) - 2^64 of the shifted divisor.
+typedef struct UInt64Reciprocal {
+  uint64_t divisor;
+  uint64_t reciprocal;
+  int shift;
+} UInt64Reciprocal;
+
+// 10^k for k in [1...19], 10^19 being the largest power of ten in a uint64_t
+static const UInt64Reciprocal kPowersOfTenReciprocals[19 + 1] = {
+    // clang-format off
+    {0, 0, 0},
+    {0xA000000000000000ULL, 0x9999999999999999ULL, 60},
+    {0xC800000000000000ULL, 0x47AE147AE147AE14ULL, 57},
+    {0xFA00000000000000ULL, 0x0624DD2F1A9FBE76ULL, 54},
+    {0x9C40000000000000ULL, 0xA36E2EB1C432CA57ULL, 50},
+    {0xC350000000000000ULL, 0x4F8B588E368F0846ULL, 47},
+    {0xF424000000000000ULL, 0x0C6F7A0B5ED8D36BULL, 44},
+    {0x9896800000000000ULL, 0xAD7F29ABCAF48578ULL, 40},
+    {0xBEBC200000000000ULL, 0x5798EE2308C39DF9ULL, 37},
+    {0xEE6B280000000000ULL, 0x12E0BE826D694B2EULL, 34},
+    {0x9502F90000000000ULL, 0xB7CDFD9D7BDBAB7DULL, 30},
+    {0xBA43B74000000000ULL, 0x5FD7FE17964955FDULL, 27},
+    {0xE8D4A51000000000ULL, 0x19799812DEA11197ULL, 24},
+    {0x9184E72A00000000ULL, 0xC25C268497681C26ULL, 20},
+    {0xB5E620F480000000ULL, 0x6849B86A12B9B01EULL, 17},
+    {0xE35FA931A0000000ULL, 0x203AF9EE756159B2ULL, 14},
+    {0x8E1BC9BF04000000ULL, 0xCD2B297D889BC2B6ULL, 10},
+    {0xB1A2BC2EC5000000ULL, 0x70EF54646D496892ULL, 7},
+    {0xDE0B6B3A76400000ULL, 0x2725DD1D243ABA0EULL, 4},
+    {0x8AC7230489E80000ULL, 0xD83C94FB6D2AC34AULL, 0},
+    // clang-format on
+};
+
+// Divide u1:u0 by a shifted divisor d with reciprocal v, requires u1 < d.
+static inline uint64_t Div2By1(uint64_t u1, uint64_t u0, uint64_t d,
+                               uint64_t v, uint64_t *remainder) {
+  __uint128_t q = (__uint128_t)v * u1;
+  q += ((__uint128_t)u1 << 64) | u0;
+  uint64_t q1 = (uint64_t)(q >> 64) + 1;
+  const uint64_t q0 = (uint64_t)q;
+  uint64_t r = u0 - q1 * d;
+  if (r > q0) {
+    q1--;
+    r += d;
+  }
+  if (DEC128_PREDICT_FALSE(r >= d)) {
+    q1++;
+    r -= d;
+  }
+  *remainder = r;
+  return q1;
+}
+
+// Divide u1:u0 by an arbitrary d, requires u1 < d so the quotient fits in
+// 64 bits. A single divq on x86-64.
+static inline uint64_t Div2By1Native(uint64_t u1, uint64_t u0, uint64_t d,
+                                     uint64_t *remainder) {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  uint64_t q, r;
+  __asm__("divq %4" : "=a"(q), "=d"(r) : "a"(u0), "d"(u1), "rm"(d));
+  *remainder = r;
+  return q;
+#else
+  const __uint128_t u = ((__uint128_t)u1 << 64) | u0;
+  *remainder = (uint64_t)(u % d);
+  return (uint64_t)(u / d);
+#endif
+}
+
+static inline __uint128_t UInt128DivideByReciprocal(__uint128_t x,
+                                                    const UInt64Reciprocal *r,
+                                                    uint64_t *remainder) {
+  const int shift = r->shift;
+  const uint64_t u2 = shift ? (uint64_t)(x >> (128 - shift)) : 0;
+  x <<= shift;
+  uint64_t rem;
+  const uint64_t q1 =
+      Div2By1(u2, (uint64_t)(x >> 64), r->divisor, r->reciprocal, &rem);
+  const uint64_t q0 =
+      Div2By1(rem, (uint64_t)x, r->divisor, r->reciprocal, &rem);
+  *remainder = rem >> shift;
+  return ((__uint128_t)q1 << 64) | q0;
+}
+
+// x / 10^k and x % 10^k for k in [0...38]
+static inline __uint128_t UInt128DivideByPowerOfTen(__uint128_t x, int32_t k,
+                                                    __uint128_t *remainder) {
+  uint64_t r0, r1;
+  if (k == 0) {
+    *remainder = 0;
+    return x;
+  }
+  if (k <= 19) {
+    x = UInt128DivideByReciprocal(x, &kPowersOfTenReciprocals[k], &r0);
+    *remainder = r0;
+    return x;
+  }
+  x = UInt128DivideByReciprocal(x, &kPowersOfTenReciprocals[19], &r0);
+  x = UInt128DivideByReciprocal(x, &kPowersOfTenReciprocals[k - 19], &r1);
+  *remainder = (__uint128_t)r1 * kPowersOfTenReciprocals[19].divisor + r0;
+  return x;
+}
+
 // On the Windows R toolchain, INFINITY is double type instead of float
 // constexpr float kFloatInf = std::numeric_limits<float>::infinity();
 #define kFloatInf HUGE_VALF
@@ -253,6 +364,331 @@ static const decimal128_t kDecimal128HalfPowersOfTen[] = {
 
 #endif
 
+static inline __uint128_t UInt128PowerOfTen(int32_t k) {
+  return (__uint128_t)dec128_to_int128(kDecimal128PowersOfTen[k]);
+}
+
+#if DEC128_LITTLE_ENDIAN
+static const decimal256_t kDecimal256PowersOfTen[76 + 1] = {
+    {{1ULL, 0ULL, 0ULL, 0ULL}},
+    {{10ULL, 0ULL, 0ULL, 0ULL}},
+    {{100ULL, 0ULL, 0ULL, 0ULL}},
+    {{1000ULL, 0ULL, 0ULL, 0ULL}},
+    {{10000ULL, 0ULL, 0ULL, 0ULL}},
+    {{100000ULL, 0ULL, 0ULL, 0ULL}},
+    {{1000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{10000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{100000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{1000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{10000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{100000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{1000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{10000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{100000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{1000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{10000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{100000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{1000000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{10000000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{7766279631452241920ULL, 5ULL, 0ULL, 0ULL}},
+    {{3875820019684212736ULL, 54ULL, 0ULL, 0ULL}},
+    {{1864712049423024128ULL, 542ULL, 0ULL, 0ULL}},
+    {{200376420520689664ULL, 5421ULL, 0ULL, 0ULL}},
+    {{2003764205206896640ULL, 54210ULL, 0ULL, 0ULL}},
+    {{1590897978359414784ULL, 542101ULL, 0ULL, 0ULL}},
+    {{15908979783594147840ULL, 5421010ULL, 0ULL, 0ULL}},
+    {{11515845246265065472ULL, 54210108ULL, 0ULL, 0ULL}},
+    {{4477988020393345024ULL, 542101086ULL, 0ULL, 0ULL}},
+    {{7886392056514347008ULL, 5421010862ULL, 0ULL, 0ULL}},
+    {{5076944270305263616ULL, 54210108624ULL, 0ULL, 0ULL}},
+    {{13875954555633532928ULL, 542101086242ULL, 0ULL, 0ULL}},
+    {{9632337040368467968ULL, 5421010862427ULL, 0ULL, 0ULL}},
+    {{4089650035136921600ULL, 54210108624275ULL, 0ULL, 0ULL}},
+    {{4003012203950112768ULL, 542101086242752ULL, 0ULL, 0ULL}},
+    {{3136633892082024448ULL, 5421010862427522ULL, 0ULL, 0ULL}},
+    {{12919594847110692864ULL, 54210108624275221ULL, 0ULL, 0ULL}},
+    {{68739955140067328ULL, 542101086242752217ULL, 0ULL, 0ULL}},
+    {{687399551400673280ULL, 5421010862427522170ULL, 0ULL, 0ULL}},
+    {{6873995514006732800ULL, 17316620476856118468ULL, 2ULL, 0ULL}},
+    {{13399722918938673152ULL, 7145508105175220139ULL, 29ULL, 0ULL}},
+    {{4870020673419870208ULL, 16114848830623546549ULL, 293ULL, 0ULL}},
+    {{11806718586779598848ULL, 13574535716559052564ULL, 2938ULL, 0ULL}},
+    {{7386721425538678784ULL, 6618148649623664334ULL, 29387ULL, 0ULL}},
+    {{80237960548581376ULL, 10841254275107988496ULL, 293873ULL, 0ULL}},
+    {{802379605485813760ULL, 16178822382532126880ULL, 2938735ULL, 0ULL}},
+    {{8023796054858137600ULL, 14214271235644855872ULL, 29387358ULL, 0ULL}},
+    {{6450984253743169536ULL, 13015503840481697412ULL, 293873587ULL, 0ULL}},
+    {{9169610316303040512ULL, 1027829888850112811ULL, 2938735877ULL, 0ULL}},
+    {{17909126868192198656ULL, 10278298888501128114ULL, 29387358770ULL, 0ULL}},
+    {{13070572018536022016ULL, 10549268516463523069ULL, 293873587705ULL, 0ULL}},
+    {{1578511669393358848ULL, 13258964796087472617ULL, 2938735877055ULL, 0ULL}},
+    {{15785116693933588480ULL, 3462439444907864858ULL, 29387358770557ULL, 0ULL}},
+    {{10277214349659471872ULL, 16177650375369096972ULL, 293873587705571ULL, 0ULL}},
+    {{10538423128046960640ULL, 14202551164014556797ULL, 2938735877055718ULL, 0ULL}},
+    {{13150510911921848320ULL, 12898303124178706663ULL, 29387358770557187ULL, 0ULL}},
+    {{2377900603251621888ULL, 18302566799529756941ULL, 293873587705571876ULL, 0ULL}},
+    {{5332261958806667264ULL, 17004971331911604867ULL, 2938735877055718769ULL, 0ULL}},
+    {{16429131440647569408ULL, 4029016655730084128ULL, 10940614696847636083ULL, 1ULL}},
+    {{16717361816799281152ULL, 3396678409881738056ULL, 17172426599928602752ULL, 15ULL}},
+    {{1152921504606846976ULL, 15520040025107828953ULL, 5703569335900062977ULL, 159ULL}},
+    {{11529215046068469760ULL, 7626447661401876602ULL, 1695461137871974930ULL, 1593ULL}},
+    {{4611686018427387904ULL, 2477500319180559562ULL, 16954611378719749304ULL, 15930ULL}},
+    {{9223372036854775808ULL, 6328259118096044006ULL, 3525417123811528497ULL, 159309ULL}},
+    {{0ULL, 7942358959831785217ULL, 16807427164405733357ULL, 1593091ULL}},
+    {{0ULL, 5636613303479645706ULL, 2053574980671369030ULL, 15930919ULL}},
+    {{0ULL, 1025900813667802212ULL, 2089005733004138687ULL, 159309191ULL}},
+    {{0ULL, 10259008136678022120ULL, 2443313256331835254ULL, 1593091911ULL}},
+    {{0ULL, 10356360998232463120ULL, 5986388489608800929ULL, 15930919111ULL}},
+    {{0ULL, 11329889613776873120ULL, 4523652674959354447ULL, 159309191113ULL}},
+    {{0ULL, 2618431695511421504ULL, 8343038602174441244ULL, 1593091911132ULL}},
+    {{0ULL, 7737572881404663424ULL, 9643409726906205977ULL, 15930919111324ULL}},
+    {{0ULL, 3588752519208427776ULL, 4200376900514301694ULL, 159309191113245ULL}},
+    {{0ULL, 17440781118374726144ULL, 5110280857723913709ULL, 1593091911132452ULL}},
+    {{0ULL, 8387114520361296896ULL, 14209320429820033867ULL, 15930919111324522ULL}},
+    {{0ULL, 10084168908774762496ULL, 12965995782233477362ULL, 159309191113245227ULL}},
+    {{0ULL, 8607968719199866880ULL, 532749306367912313ULL, 1593091911132452277ULL}}};
+
+static const decimal256_t kDecimal256HalfPowersOfTen[76 + 1] = {
+    {{0ULL, 0ULL, 0ULL, 0ULL}},
+    {{5ULL, 0ULL, 0ULL, 0ULL}},
+    {{50ULL, 0ULL, 0ULL, 0ULL}},
+    {{500ULL, 0ULL, 0ULL, 0ULL}},
+    {{5000ULL, 0ULL, 0ULL, 0ULL}},
+    {{50000ULL, 0ULL, 0ULL, 0ULL}},
+    {{500000ULL, 0ULL, 0ULL, 0ULL}},
+    {{5000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{50000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{500000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{5000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{50000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{500000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{5000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{50000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{500000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{5000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{50000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{500000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{5000000000000000000ULL, 0ULL, 0ULL, 0ULL}},
+    {{13106511852580896768ULL, 2ULL, 0ULL, 0ULL}},
+    {{1937910009842106368ULL, 27ULL, 0ULL, 0ULL}},
+    {{932356024711512064ULL, 271ULL, 0ULL, 0ULL}},
+    {{9323560247115120640ULL, 2710ULL, 0ULL, 0ULL}},
+    {{1001882102603448320ULL, 27105ULL, 0ULL, 0ULL}},
+    {{10018821026034483200ULL, 271050ULL, 0ULL, 0ULL}},
+    {{7954489891797073920ULL, 2710505ULL, 0ULL, 0ULL}},
+    {{5757922623132532736ULL, 27105054ULL, 0ULL, 0ULL}},
+    {{2238994010196672512ULL, 271050543ULL, 0ULL, 0ULL}},
+    {{3943196028257173504ULL, 2710505431ULL, 0ULL, 0ULL}},
+    {{2538472135152631808ULL, 27105054312ULL, 0ULL, 0ULL}},
+    {{6937977277816766464ULL, 271050543121ULL, 0ULL, 0ULL}},
+    {{14039540557039009792ULL, 2710505431213ULL, 0ULL, 0ULL}},
+    {{11268197054423236608ULL, 27105054312137ULL, 0ULL, 0ULL}},
+    {{2001506101975056384ULL, 271050543121376ULL, 0ULL, 0ULL}},
+    {{1568316946041012224ULL, 2710505431213761ULL, 0ULL, 0ULL}},
+    {{15683169460410122240ULL, 27105054312137610ULL, 0ULL, 0ULL}},
+    {{9257742014424809472ULL, 271050543121376108ULL, 0ULL, 0ULL}},
+    {{343699775700336640ULL, 2710505431213761085ULL, 0ULL, 0ULL}},
+    {{3436997757003366400ULL, 8658310238428059234ULL, 1ULL, 0ULL}},
+    {{15923233496324112384ULL, 12796126089442385877ULL, 14ULL, 0ULL}},
+    {{11658382373564710912ULL, 17280796452166549082ULL, 146ULL, 0ULL}},
+    {{5903359293389799424ULL, 6787267858279526282ULL, 1469ULL, 0ULL}},
+    {{3693360712769339392ULL, 12532446361666607975ULL, 14693ULL, 0ULL}},
+    {{40118980274290688ULL, 14643999174408770056ULL, 146936ULL, 0ULL}},
+    {{401189802742906880ULL, 17312783228120839248ULL, 1469367ULL, 0ULL}},
+    {{4011898027429068800ULL, 7107135617822427936ULL, 14693679ULL, 0ULL}},
+    {{3225492126871584768ULL, 15731123957095624514ULL, 146936793ULL, 0ULL}},
+    {{13808177195006296064ULL, 9737286981279832213ULL, 1469367938ULL, 0ULL}},
+    {{8954563434096099328ULL, 5139149444250564057ULL, 14693679385ULL, 0ULL}},
+    {{15758658046122786816ULL, 14498006295086537342ULL, 146936793852ULL, 0ULL}},
+    {{10012627871551455232ULL, 15852854434898512116ULL, 1469367938527ULL, 0ULL}},
+    {{7892558346966794240ULL, 10954591759308708237ULL, 14693679385278ULL, 0ULL}},
+    {{5138607174829735936ULL, 17312197224539324294ULL, 146936793852785ULL, 0ULL}},
+    {{14492583600878256128ULL, 7101275582007278398ULL, 1469367938527859ULL, 0ULL}},
+    {{15798627492815699968ULL, 15672523598944129139ULL, 14693679385278593ULL, 0ULL}},
+    {{10412322338480586752ULL, 9151283399764878470ULL, 146936793852785938ULL, 0ULL}},
+    {{11889503016258109440ULL, 17725857702810578241ULL, 1469367938527859384ULL, 0ULL}},
+    {{8214565720323784704ULL, 11237880364719817872ULL, 14693679385278593849ULL, 0ULL}},
+    {{8358680908399640576ULL, 1698339204940869028ULL, 17809585336819077184ULL, 7ULL}},
+    {{9799832789158199296ULL, 16983392049408690284ULL, 12075156704804807296ULL, 79ULL}},
+    {{5764607523034234880ULL, 3813223830700938301ULL, 10071102605790763273ULL, 796ULL}},
+    {{2305843009213693952ULL, 1238750159590279781ULL, 8477305689359874652ULL, 7965ULL}},
+    {{4611686018427387904ULL, 12387501595902797811ULL, 10986080598760540056ULL, 79654ULL}},
+    {{9223372036854775808ULL, 13194551516770668416ULL, 17627085619057642486ULL, 796545ULL}},
+    {{0ULL, 2818306651739822853ULL, 10250159527190460323ULL, 7965459ULL}},
+    {{0ULL, 9736322443688676914ULL, 10267874903356845151ULL, 79654595ULL}},
+    {{0ULL, 5129504068339011060ULL, 10445028665020693435ULL, 796545955ULL}},
+    {{0ULL, 14401552535971007368ULL, 12216566281659176272ULL, 7965459555ULL}},
+    {{0ULL, 14888316843743212368ULL, 11485198374334453031ULL, 79654595556ULL}},
+    {{0ULL, 1309215847755710752ULL, 4171519301087220622ULL, 796545955566ULL}},
+    {{0ULL, 13092158477557107520ULL, 4821704863453102988ULL, 7965459555662ULL}},
+    {{0ULL, 1794376259604213888ULL, 11323560487111926655ULL, 79654595556622ULL}},
+    {{0ULL, 17943762596042138880ULL, 2555140428861956854ULL, 796545955566226ULL}},
+    {{0ULL, 13416929297035424256ULL, 7104660214910016933ULL, 7965459555662261ULL}},
+    {{0ULL, 5042084454387381248ULL, 15706369927971514489ULL, 79654595556622613ULL}},
+    {{0ULL, 13527356396454709248ULL, 9489746690038731964ULL, 796545955566226138ULL}}};
+
+#else
+
+static const decimal256_t kDecimal256PowersOfTen[76 + 1] = {
+    {{0ULL, 0ULL, 0ULL, 1ULL}},
+    {{0ULL, 0ULL, 0ULL, 10ULL}},
+    {{0ULL, 0ULL, 0ULL, 100ULL}},
+    {{0ULL, 0ULL, 0ULL, 1000ULL}},
+    {{0ULL, 0ULL, 0ULL, 10000ULL}},
+    {{0ULL, 0ULL, 0ULL, 100000ULL}},
+    {{0ULL, 0ULL, 0ULL, 1000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 10000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 100000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 1000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 10000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 100000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 1000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 10000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 100000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 1000000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 10000000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 100000000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 1000000000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 10000000000000000000ULL}},
+    {{0ULL, 0ULL, 5ULL, 7766279631452241920ULL}},
+    {{0ULL, 0ULL, 54ULL, 3875820019684212736ULL}},
+    {{0ULL, 0ULL, 542ULL, 1864712049423024128ULL}},
+    {{0ULL, 0ULL, 5421ULL, 200376420520689664ULL}},
+    {{0ULL, 0ULL, 54210ULL, 2003764205206896640ULL}},
+    {{0ULL, 0ULL, 542101ULL, 1590897978359414784ULL}},
+    {{0ULL, 0ULL, 5421010ULL, 15908979783594147840ULL}},
+    {{0ULL, 0ULL, 54210108ULL, 11515845246265065472ULL}},
+    {{0ULL, 0ULL, 542101086ULL, 4477988020393345024ULL}},
+    {{0ULL, 0ULL, 5421010862ULL, 7886392056514347008ULL}},
+    {{0ULL, 0ULL, 54210108624ULL, 5076944270305263616ULL}},
+    {{0ULL, 0ULL, 542101086242ULL, 13875954555633532928ULL}},
+    {{0ULL, 0ULL, 5421010862427ULL, 9632337040368467968ULL}},
+    {{0ULL, 0ULL, 54210108624275ULL, 4089650035136921600ULL}},
+    {{0ULL, 0ULL, 542101086242752ULL, 4003012203950112768ULL}},
+    {{0ULL, 0ULL, 5421010862427522ULL, 3136633892082024448ULL}},
+    {{0ULL, 0ULL, 54210108624275221ULL, 12919594847110692864ULL}},
+    {{0ULL, 0ULL, 542101086242752217ULL, 68739955140067328ULL}},
+    {{0ULL, 0ULL, 5421010862427522170ULL, 687399551400673280ULL}},
+    {{0ULL, 2ULL, 17316620476856118468ULL, 6873995514006732800ULL}},
+    {{0ULL, 29ULL, 7145508105175220139ULL, 13399722918938673152ULL}},
+    {{0ULL, 293ULL, 16114848830623546549ULL, 4870020673419870208ULL}},
+    {{0ULL, 2938ULL, 13574535716559052564ULL, 11806718586779598848ULL}},
+    {{0ULL, 29387ULL, 6618148649623664334ULL, 7386721425538678784ULL}},
+    {{0ULL, 293873ULL, 10841254275107988496ULL, 80237960548581376ULL}},
+    {{0ULL, 2938735ULL, 16178822382532126880ULL, 802379605485813760ULL}},
+    {{0ULL, 29387358ULL, 14214271235644855872ULL, 8023796054858137600ULL}},
+    {{0ULL, 293873587ULL, 13015503840481697412ULL, 6450984253743169536ULL}},
+    {{0ULL, 2938735877ULL, 1027829888850112811ULL, 9169610316303040512ULL}},
+    {{0ULL, 29387358770ULL, 10278298888501128114ULL, 17909126868192198656ULL}},
+    {{0ULL, 293873587705ULL, 10549268516463523069ULL, 13070572018536022016ULL}},
+    {{0ULL, 2938735877055ULL, 13258964796087472617ULL, 1578511669393358848ULL}},
+    {{0ULL, 29387358770557ULL, 3462439444907864858ULL, 15785116693933588480ULL}},
+    {{0ULL, 293873587705571ULL, 16177650375369096972ULL, 10277214349659471872ULL}},
+    {{0ULL, 2938735877055718ULL, 14202551164014556797ULL, 10538423128046960640ULL}},
+    {{0ULL, 29387358770557187ULL, 12898303124178706663ULL, 13150510911921848320ULL}},
+    {{0ULL, 293873587705571876ULL, 18302566799529756941ULL, 2377900603251621888ULL}},
+    {{0ULL, 2938735877055718769ULL, 17004971331911604867ULL, 5332261958806667264ULL}},
+    {{1ULL, 10940614696847636083ULL, 4029016655730084128ULL, 16429131440647569408ULL}},
+    {{15ULL, 17172426599928602752ULL, 3396678409881738056ULL, 16717361816799281152ULL}},
+    {{159ULL, 5703569335900062977ULL, 15520040025107828953ULL, 1152921504606846976ULL}},
+    {{1593ULL, 1695461137871974930ULL, 7626447661401876602ULL, 11529215046068469760ULL}},
+    {{15930ULL, 16954611378719749304ULL, 2477500319180559562ULL, 4611686018427387904ULL}},
+    {{159309ULL, 3525417123811528497ULL, 6328259118096044006ULL, 9223372036854775808ULL}},
+    {{1593091ULL, 16807427164405733357ULL, 7942358959831785217ULL, 0ULL}},
+    {{15930919ULL, 2053574980671369030ULL, 5636613303479645706ULL, 0ULL}},
+    {{159309191ULL, 2089005733004138687ULL, 1025900813667802212ULL, 0ULL}},
+    {{1593091911ULL, 2443313256331835254ULL, 10259008136678022120ULL, 0ULL}},
+    {{15930919111ULL, 5986388489608800929ULL, 10356360998232463120ULL, 0ULL}},
+    {{159309191113ULL, 4523652674959354447ULL, 11329889613776873120ULL, 0ULL}},
+    {{1593091911132ULL, 8343038602174441244ULL, 2618431695511421504ULL, 0ULL}},
+    {{15930919111324ULL, 9643409726906205977ULL, 7737572881404663424ULL, 0ULL}},
+    {{159309191113245ULL, 4200376900514301694ULL, 3588752519208427776ULL, 0ULL}},
+    {{1593091911132452ULL, 5110280857723913709ULL, 17440781118374726144ULL, 0ULL}},
+    {{15930919111324522ULL, 14209320429820033867ULL, 8387114520361296896ULL, 0ULL}},
+    {{159309191113245227ULL, 12965995782233477362ULL, 10084168908774762496ULL, 0ULL}},
+    {{1593091911132452277ULL, 532749306367912313ULL, 8607968719199866880ULL, 0ULL}}};
+
+static const decimal256_t kDecimal256HalfPowersOfTen[76 + 1] = {
+    {{0ULL, 0ULL, 0ULL, 0ULL}},
+    {{0ULL, 0ULL, 0ULL, 5ULL}},
+    {{0ULL, 0ULL, 0ULL, 50ULL}},
+    {{0ULL, 0ULL, 0ULL, 500ULL}},
+    {{0ULL, 0ULL, 0ULL, 5000ULL}},
+    {{0ULL, 0ULL, 0ULL, 50000ULL}},
+    {{0ULL, 0ULL, 0ULL, 500000ULL}},
+    {{0ULL, 0ULL, 0ULL, 5000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 50000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 500000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 5000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 50000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 500000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 5000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 50000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 500000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 5000000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 50000000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 500000000000000000ULL}},
+    {{0ULL, 0ULL, 0ULL, 5000000000000000000ULL}},
+    {{0ULL, 0ULL, 2ULL, 13106511852580896768ULL}},
+    {{0ULL, 0ULL, 27ULL, 1937910009842106368ULL}},
+    {{0ULL, 0ULL, 271ULL, 932356024711512064ULL}},
+    {{0ULL, 0ULL, 2710ULL, 9323560247115120640ULL}},
+    {{0ULL, 0ULL, 27105ULL, 1001882102603448320ULL}},
+    {{0ULL, 0ULL, 271050ULL, 10018821026034483200ULL}},
+    {{0ULL, 0ULL, 2710505ULL, 7954489891797073920ULL}},
+    {{0ULL, 0ULL, 27105054ULL, 5757922623132532736ULL}},
+    {{0ULL, 0ULL, 271050543ULL, 2238994010196672512ULL}},
+    {{0ULL, 0ULL, 2710505431ULL, 3943196028257173504ULL}},
+    {{0ULL, 0ULL, 27105054312ULL, 2538472135152631808ULL}},
+    {{0ULL, 0ULL, 271050543121ULL, 6937977277816766464ULL}},
+    {{0ULL, 0ULL, 2710505431213ULL, 14039540557039009792ULL}},
+    {{0ULL, 0ULL, 27105054312137ULL, 11268197054423236608ULL}},
+    {{0ULL, 0ULL, 271050543121376ULL, 2001506101975056384ULL}},
+    {{0ULL, 0ULL, 2710505431213761ULL, 1568316946041012224ULL}},
+    {{0ULL, 0ULL, 27105054312137610ULL, 15683169460410122240ULL}},
+    {{0ULL, 0ULL, 271050543121376108ULL, 9257742014424809472ULL}},
+    {{0ULL, 0ULL, 2710505431213761085ULL, 343699775700336640ULL}},
+    {{0ULL, 1ULL, 8658310238428059234ULL, 3436997757003366400ULL}},
+    {{0ULL, 14ULL, 12796126089442385877ULL, 15923233496324112384ULL}},
+    {{0ULL, 146ULL, 17280796452166549082ULL, 11658382373564710912ULL}},
+    {{0ULL, 1469ULL, 6787267858279526282ULL, 5903359293389799424ULL}},
+    {{0ULL, 14693ULL, 12532446361666607975ULL, 3693360712769339392ULL}},
+    {{0ULL, 146936ULL, 14643999174408770056ULL, 40118980274290688ULL}},
+    {{0ULL, 1469367ULL, 17312783228120839248ULL, 401189802742906880ULL}},
+    {{0ULL, 14693679ULL, 7107135617822427936ULL, 4011898027429068800ULL}},
+    {{0ULL, 146936793ULL, 15731123957095624514ULL, 3225492126871584768ULL}},
+    {{0ULL, 1469367938ULL, 9737286981279832213ULL, 13808177195006296064ULL}},
+    {{0ULL, 14693679385ULL, 5139149444250564057ULL, 8954563434096099328ULL}},
+    {{0ULL, 146936793852ULL, 14498006295086537342ULL, 15758658046122786816ULL}},
+    {{0ULL, 1469367938527ULL, 15852854434898512116ULL, 10012627871551455232ULL}},
+    {{0ULL, 14693679385278ULL, 10954591759308708237ULL, 7892558346966794240ULL}},
+    {{0ULL, 146936793852785ULL, 17312197224539324294ULL, 5138607174829735936ULL}},
+    {{0ULL, 1469367938527859ULL, 7101275582007278398ULL, 14492583600878256128ULL}},
+    {{0ULL, 14693679385278593ULL, 15672523598944129139ULL, 15798627492815699968ULL}},
+    {{0ULL, 146936793852785938ULL, 9151283399764878470ULL, 10412322338480586752ULL}},
+    {{0ULL, 1469367938527859384ULL, 17725857702810578241ULL, 11889503016258109440ULL}},
+    {{0ULL, 14693679385278593849ULL, 11237880364719817872ULL, 8214565720323784704ULL}},
+    {{7ULL, 17809585336819077184ULL, 1698339204940869028ULL, 8358680908399640576ULL}},
+    {{79ULL, 12075156704804807296ULL, 16983392049408690284ULL, 9799832789158199296ULL}},
+    {{796ULL, 10071102605790763273ULL, 3813223830700938301ULL, 5764607523034234880ULL}},
+    {{7965ULL, 8477305689359874652ULL, 1238750159590279781ULL, 2305843009213693952ULL}},
+    {{79654ULL, 10986080598760540056ULL, 12387501595902797811ULL, 4611686018427387904ULL}},
+    {{796545ULL, 17627085619057642486ULL, 13194551516770668416ULL, 9223372036854775808ULL}},
+    {{7965459ULL, 10250159527190460323ULL, 2818306651739822853ULL, 0ULL}},
+    {{79654595ULL, 10267874903356845151ULL, 9736322443688676914ULL, 0ULL}},
+    {{796545955ULL, 10445028665020693435ULL, 5129504068339011060ULL, 0ULL}},
+    {{7965459555ULL, 12216566281659176272ULL, 14401552535971007368ULL, 0ULL}},
+    {{79654595556ULL, 11485198374334453031ULL, 14888316843743212368ULL, 0ULL}},
+    {{796545955566ULL, 4171519301087220622ULL, 1309215847755710752ULL, 0ULL}},
+    {{7965459555662ULL, 4821704863453102988ULL, 13092158477557107520ULL, 0ULL}},
+    {{79654595556622ULL, 11323560487111926655ULL, 1794376259604213888ULL, 0ULL}},
+    {{796545955566226ULL, 2555140428861956854ULL, 17943762596042138880ULL, 0ULL}},
+    {{7965459555662261ULL, 7104660214910016933ULL, 13416929297035424256ULL, 0ULL}},
+    {{79654595556622613ULL, 15706369927971514489ULL, 5042084454387381248ULL, 0ULL}},
+    {{796545955566226138ULL, 9489746690038731964ULL, 13527356396454709248ULL, 0ULL}}};
+
+#endif
+
 // ceil(log2(10 ^ k)) for k in [0...76]
 static const int kCeilLog2PowersOfTen[76 + 1] = {
     0,   4,   7,   10,  14,  17,  20,  24,  27,  30,  34,  37,  40,
@@ -333,4 +769,101 @@ static inline const decimal128_t *powers_of_ten_dec128() {
   return kDecimal128PowersOfTen;
 }
 
+static const DecimalTrait trait_dec256 = {DEC256_MAX_PRECISION,
+                                          DEC256_MAX_SCALE};
+static inline const decimal256_t *powers_of_ten_dec256() {
+  return kDecimal256PowersOfTen;
+}
+
+/* big-endian two's complement bytes, as stored by Parquet and Avro */
+// Sign extend 1 to 16 big-endian bytes
+static inline decimal128_t DecimalFromBigEndian(const uint8_t *bytes,
+                                                int32_t length) {
+  uint8_t buffer[16];
+  memset(buffer, (int8_t)bytes[0] < 0 ? 0xFF : 0, 16 - length);
+  memcpy(buffer + 16 - length, bytes, length);
+  uint64_t high, low;
+  memcpy(&high, buffer, sizeof(high));
+  memcpy(&low, buffer + 8, sizeof(low));
+#if DEC128_LITTLE_ENDIAN
+  high = __builtin_bswap64(high);
+  low = __builtin_bswap64(low);
+#endif
+  return dec128_from_hilo((int64_t)high, low);
+}
+
+// All 16 big-endian bytes of v
+static inline void DecimalToBigEndian(decimal128_t v, uint8_t out[16]) {
+  uint64_t high = (uint64_t)dec128_high_bits(v);
+  uint64_t low = dec128_low_bits(v);
+#if DEC128_LITTLE_ENDIAN
+  high = __builtin_bswap64(high);
+  low = __builtin_bswap64(low);
+#endif
+  memcpy(out, &high, sizeof(high));
+  memcpy(out + 8, &low, sizeof(low));
+}
+
+// Fewest bytes that hold v in two's complement, 1 to 16
+static inline int32_t DecimalBigEndianLength(decimal128_t v) {
+  const int64_t high = dec128_high_bits(v);
+  const uint64_t low = dec128_low_bits(v);
+  if (high == ((int64_t)low >> 63)) {
+    return 8 - __builtin_clrsbll((int64_t)low) / 8;
+  }
+  return 16 - __builtin_clrsbll(high) / 8;
+}
+
+/* overflow checked two's complement arithmetic */
+// Each sets out to the result truncated to 128 bits and returns true if the
+// exact result does not fit
+static inline bool Int128AddOverflow(__int128_t x, __int128_t y,
+                                     __int128_t *out) {
+  return __builtin_add_overflow(x, y, out);
+}
+
+static inline bool Int128SubtractOverflow(__int128_t x, __int128_t y,
+                                          __int128_t *out) {
+  return __builtin_sub_overflow(x, y, out);
+}
+
+// Multiplies the magnitudes in 64-bit halves, __builtin_mul_overflow on
+// 128-bit operands needs a runtime library call with some compilers
+static inline bool Int128MultiplyOverflow(__int128_t x, __int128_t y,
+                                          __int128_t *out) {
+  if (DEC128_PREDICT_TRUE(x == (int64_t)x && y == (int64_t)y)) {
+    // at most 2^126 in magnitude
+    *out = (__int128_t)(int64_t)x * (int64_t)y;
+    return false;
+  }
+  const bool negative = (x < 0) != (y < 0);
+  const __uint128_t a = x < 0 ? -(__uint128_t)x : (__uint128_t)x;
+  const __uint128_t b = y < 0 ? -(__uint128_t)y : (__uint128_t)y;
+  const uint64_t a_high = (uint64_t)(a >> 64);
+  const uint64_t b_high = (uint64_t)(b >> 64);
+  __uint128_t product = (__uint128_t)(uint64_t)a * (uint64_t)b;
+  bool overflow = false;
+  if (DEC128_PREDICT_FALSE(a_high | b_high)) {
+    // one of the high halves is zero unless the product overflows
+    uint64_t cross, high = 0;
+    overflow = (a_high && b_high) ||
+               __builtin_mul_overflow(a_high | b_high,
+                                      a_high ? (uint64_t)b : (uint64_t)a,
+                                      &cross) ||
+               __builtin_add_overflow((uint64_t)(product >> 64), cross, &high);
+    product = ((__uint128_t)high << 64) | (uint64_t)product;
+  }
+  // a negative product may reach 2^127
+  overflow = overflow || product > ((__uint128_t)1 << 127) - !negative;
+  *out = DEC128_PREDICT_FALSE(overflow)
+             ? (__int128_t)((__uint128_t)x * (__uint128_t)y)
+             : (__int128_t)(negative ? -product : product);
+  return overflow;
+}
+
+// |x| < 10^precision for a limit of 10^precision - 1
+static inline bool Int128FitsLimit(__int128_t x, __uint128_t limit) {
+  return (__uint128_t)x + limit <= 2 * limit;
+}
+
 #endif
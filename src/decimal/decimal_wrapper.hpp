@@ -1,7 +1,11 @@
 #pragma once
 
 #include "basic_decimal.h"
+#include "narrow_decimal.h"
+#include <functional>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 
 /// Represents a signed 128-bit integer in two's complement.
 ///
@@ -35,18 +39,12 @@ struct Decimal128 {
     dec = dec128_from_int64(value);
   }
 
-  std::string ToIntegerString() const {
-    char ret[DEC128_MAX_STRLEN];
-    *ret = 0;
-    dec128_to_integer_string(dec, ret);
-    return std::string(ret);
-  }
+  std::string ToIntegerString() const { return ToString(0); }
 
   std::string ToString(int32_t scale) const {
     char ret[DEC128_MAX_STRLEN];
-    *ret = 0;
-    dec128_to_string(dec, ret, scale);
-    return std::string(ret);
+    int32_t length = dec128_to_chars(dec, ret, ret + sizeof(ret), scale);
+    return std::string(ret, length < 0 ? 0 : length);
   }
 
   float ToFloat(int32_t scale) { return dec128_to_float(dec, scale); }
@@ -152,7 +150,12 @@ struct Decimal128 {
   /// dec128_DIV_precision_scale
   static Decimal128 Divide(Decimal128 &left, int s1, Decimal128 &right, int s2,
                            int precision, int scale) {
-    return {dec128_divide_exact(left.dec, s1, right.dec, s2, precision, scale)};
+    Decimal128 result;
+    if (dec128_divide_exact(left.dec, s1, right.dec, s2, precision, scale,
+                            &result.dec) != DEC128_STATUS_SUCCESS) {
+      throw std::runtime_error("dec128_divide_exact failed");
+    }
+    return result;
   }
 
   /// \brief Absolute value (in-place)
@@ -252,3 +255,351 @@ inline Decimal128 operator%(const Decimal128 &left, const Decimal128 &right) {
   ret %= right;
   return ret;
 }
+
+namespace std {
+template <> struct hash<Decimal128> {
+  size_t operator()(const Decimal128 &v) const noexcept {
+    return (size_t)dec128_hash(v.dec);
+  }
+};
+} // namespace std
+
+/* compile-time precision and scale */
+namespace dec128 {
+
+constexpr int32_t Max(int32_t a, int32_t b) { return a > b ? a : b; }
+
+constexpr int32_t Min(int32_t a, int32_t b) { return a < b ? a : b; }
+
+/// \brief The result rules of dec128_ADD_SUB_precision_scale() and friends.
+constexpr int32_t AddSubScale(int32_t s1, int32_t s2) { return Max(s1, s2); }
+
+constexpr int32_t AddSubPrecision(int32_t p1, int32_t s1, int32_t p2,
+                                  int32_t s2) {
+  return Max(p1 - s1, p2 - s2) + 1 + AddSubScale(s1, s2);
+}
+
+constexpr int32_t MulScale(int32_t s1, int32_t s2) { return s1 + s2; }
+
+constexpr int32_t MulPrecision(int32_t p1, int32_t p2) { return p1 + p2 + 1; }
+
+constexpr int32_t DivScale(int32_t s1, int32_t p2, int32_t s2) {
+  return Max(4, s1 + p2 - s2 + 1);
+}
+
+constexpr int32_t DivPrecision(int32_t p1, int32_t s1, int32_t p2,
+                               int32_t s2) {
+  return p1 - s1 + s2 + DivScale(s1, p2, s2);
+}
+
+constexpr int32_t ModScale(int32_t s1, int32_t s2) { return Max(s1, s2); }
+
+constexpr int32_t ModPrecision(int32_t p1, int32_t p2) { return Max(p1, p2); }
+
+/// \brief Precision of a value of precision p and scale s brought to
+/// new_scale, reducing the scale rounds and may carry into one more digit.
+constexpr int32_t RescalePrecision(int32_t p, int32_t s, int32_t new_scale) {
+  return new_scale >= s ? p + new_scale - s
+                        : Min(DEC128_MAX_PRECISION, p - s + new_scale + 1);
+}
+
+template <typename T> constexpr T Pow10(int32_t n) {
+  T ret = 1;
+  while (n-- > 0) {
+    ret *= 10;
+  }
+  return ret;
+}
+
+/// \brief The narrowest of decimal32_t, decimal64_t and decimal128_t holding
+/// precision digits.
+constexpr int32_t StorageWidth(int32_t precision) {
+  return precision <= DEC32_MAX_PRECISION   ? 32
+         : precision <= DEC64_MAX_PRECISION ? 64
+                                            : 128;
+}
+
+template <int32_t Width> struct Storage;
+
+template <> struct Storage<32> {
+  using type = decimal32_t;
+  using native = int32_t;
+  static native Get(type v) { return v.value; }
+  static type Make(native x) { return dec32_from_int32(x); }
+  static decimal128_t ToDec128(type v) { return dec32_to_dec128(v); }
+};
+
+template <> struct Storage<64> {
+  using type = decimal64_t;
+  using native = int64_t;
+  static native Get(type v) { return v.value; }
+  static type Make(native x) { return dec64_from_int64(x); }
+  static decimal128_t ToDec128(type v) { return dec64_to_dec128(v); }
+};
+
+template <> struct Storage<128> {
+  using type = decimal128_t;
+  using native = __int128;
+  static native Get(type v) { return dec128_to_int128(v); }
+  static type Make(native x) { return dec128_from_int128(x); }
+  static decimal128_t ToDec128(type v) { return v; }
+};
+
+} // namespace dec128
+
+/// A DECIMAL(P, S) value: the unscaled integer in the narrowest storage that
+/// holds P digits.
+///
+/// Operators return the precision and scale of the util.c rules, computed at
+/// compile time, and bring operands to a common scale with constant factors.
+/// Results always fit their type, a result needing more than
+/// DEC128_MAX_PRECISION digits does not compile.
+template <int32_t P, int32_t S> struct Decimal {
+  static_assert(P >= 1 && P <= DEC128_MAX_PRECISION,
+                "Decimal precision out of range");
+  static_assert(S >= 0 && S <= P, "Decimal scale out of range");
+
+  static constexpr int32_t kPrecision = P;
+  static constexpr int32_t kScale = S;
+
+  using Storage = dec128::Storage<dec128::StorageWidth(P)>;
+  using storage_type = typename Storage::type;
+  using native_type = typename Storage::native;
+
+  storage_type dec;
+
+  /// \brief Empty constructor creates a decimal with a value of 0.
+  Decimal() noexcept : dec(Storage::Make(0)) {}
+
+  /// \brief Create a decimal from its unscaled value, which must have at most
+  /// P digits.
+  explicit Decimal(storage_type _dec) noexcept : dec(_dec) {}
+
+  /// \brief Exact conversion from a decimal with no more whole or fractional
+  /// digits.
+  template <int32_t P2, int32_t S2,
+            typename = typename std::enable_if<(S2 <= S &&
+                                                P2 - S2 <= P - S)>::type>
+  Decimal(const Decimal<P2, S2> &other) noexcept // NOLINT(runtime/explicit)
+      : dec(Storage::Make(Upscale<S2>(other.Native()))) {}
+
+  static Decimal FromNative(native_type v) noexcept {
+    return Decimal(Storage::Make(v));
+  }
+
+  /// \brief The unscaled value.
+  native_type Native() const { return Storage::Get(dec); }
+
+  /// \brief Bring an unscaled value of scale from_scale to S.
+  template <int32_t from_scale, typename T> static native_type Upscale(T v) {
+    static_assert(from_scale <= S, "Upscale reduces the scale");
+    constexpr native_type factor = dec128::Pow10<native_type>(S - from_scale);
+    return (native_type)v * factor;
+  }
+
+  /// \brief Convert v of scale, DEC128_STATUS_RESCALEDATALOSS if it has
+  /// nonzero digits below S, DEC128_STATUS_OVERFLOW if more than P digits.
+  static decimal_status_t FromDecimal128(const Decimal128 &v, int32_t scale,
+                                         Decimal *out) {
+    decimal128_t rescaled;
+    decimal_status_t s = dec128_rescale(v.dec, scale, S, &rescaled);
+    if (s != DEC128_STATUS_SUCCESS) {
+      return s;
+    }
+    if (!dec128_fits_in_precision(rescaled, P)) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+    *out = FromNative((native_type)dec128::Storage<128>::Get(rescaled));
+    return DEC128_STATUS_SUCCESS;
+  }
+
+  static decimal_status_t FromString(const char *s, Decimal *out) {
+    Decimal128 v;
+    int32_t precision, scale;
+    decimal_status_t status = Decimal128::FromString(s, &v, &precision, &scale);
+    if (status != DEC128_STATUS_SUCCESS) {
+      return status;
+    }
+    return FromDecimal128(v, scale, out);
+  }
+
+  static decimal_status_t FromString(const std::string &s, Decimal *out) {
+    return FromString(s.c_str(), out);
+  }
+
+  Decimal128 ToDecimal128() const { return Storage::ToDec128(dec); }
+
+  std::string ToString() const { return ToDecimal128().ToString(S); }
+
+  double ToDouble() const {
+    return dec128_to_double(Storage::ToDec128(dec), S);
+  }
+
+  /// \brief Change the scale, rounding half up when it is reduced.
+  template <int32_t new_scale>
+  Decimal<dec128::RescalePrecision(P, S, new_scale), new_scale>
+  Rescale() const {
+    using Result =
+        Decimal<dec128::RescalePrecision(P, S, new_scale), new_scale>;
+    using T = typename Result::native_type;
+    if constexpr (new_scale >= S) {
+      return Result::FromNative(Result::template Upscale<S>(Native()));
+    } else {
+      constexpr native_type factor = dec128::Pow10<native_type>(S - new_scale);
+      const native_type v = Native();
+      native_type q = v / factor;
+      const native_type r = v % factor;
+      // |r| >= factor - |r| cannot overflow unlike 2 * |r| >= factor
+      if ((r < 0 ? -r : r) >= factor - (r < 0 ? -r : r)) {
+        q += v < 0 ? -1 : 1;
+      }
+      return Result::FromNative((T)q);
+    }
+  }
+};
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline Decimal<dec128::AddSubPrecision(P1, S1, P2, S2),
+               dec128::AddSubScale(S1, S2)>
+operator+(const Decimal<P1, S1> &left, const Decimal<P2, S2> &right) {
+  using Result = Decimal<dec128::AddSubPrecision(P1, S1, P2, S2),
+                         dec128::AddSubScale(S1, S2)>;
+  return Result::FromNative(Result::template Upscale<S1>(left.Native()) +
+                            Result::template Upscale<S2>(right.Native()));
+}
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline Decimal<dec128::AddSubPrecision(P1, S1, P2, S2),
+               dec128::AddSubScale(S1, S2)>
+operator-(const Decimal<P1, S1> &left, const Decimal<P2, S2> &right) {
+  using Result = Decimal<dec128::AddSubPrecision(P1, S1, P2, S2),
+                         dec128::AddSubScale(S1, S2)>;
+  return Result::FromNative(Result::template Upscale<S1>(left.Native()) -
+                            Result::template Upscale<S2>(right.Native()));
+}
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline Decimal<dec128::MulPrecision(P1, P2), dec128::MulScale(S1, S2)>
+operator*(const Decimal<P1, S1> &left, const Decimal<P2, S2> &right) {
+  using Result =
+      Decimal<dec128::MulPrecision(P1, P2), dec128::MulScale(S1, S2)>;
+  using T = typename Result::native_type;
+  return Result::FromNative((T)left.Native() * (T)right.Native());
+}
+
+/// \brief Quotient rounded half up like dec128_divide_exact(), throws on
+/// division by zero.
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline Decimal<dec128::DivPrecision(P1, S1, P2, S2),
+               dec128::DivScale(S1, P2, S2)>
+operator/(const Decimal<P1, S1> &left, const Decimal<P2, S2> &right) {
+  using Result = Decimal<dec128::DivPrecision(P1, S1, P2, S2),
+                         dec128::DivScale(S1, P2, S2)>;
+  using T = typename Result::native_type;
+  // the scaled dividend has exactly the result precision, the divisor fewer
+  // digits
+  constexpr T factor = dec128::Pow10<T>(Result::kScale + S2 - S1);
+  const T dividend = (T)left.Native() * factor;
+  const T divisor = right.Native();
+  if (divisor == 0) {
+    throw std::runtime_error("Decimal division by zero");
+  }
+  T result = dividend / divisor;
+  const T remainder = dividend % divisor;
+  const T abs_remainder = remainder < 0 ? -remainder : remainder;
+  const T abs_divisor = divisor < 0 ? -divisor : divisor;
+  if (abs_remainder >= abs_divisor - abs_remainder) {
+    result += (dividend < 0) != (divisor < 0) ? -1 : 1;
+  }
+  return Result::FromNative(result);
+}
+
+/// \brief Remainder with the sign of left like dec128_mod(), throws on
+/// division by zero.
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline Decimal<dec128::ModPrecision(P1, P2), dec128::ModScale(S1, S2)>
+operator%(const Decimal<P1, S1> &left, const Decimal<P2, S2> &right) {
+  using Result =
+      Decimal<dec128::ModPrecision(P1, P2), dec128::ModScale(S1, S2)>;
+  // digits of the operands at the common scale
+  constexpr int32_t digits = dec128::AddSubPrecision(P1, S1, P2, S2) - 1;
+  if (right.Native() == 0) {
+    throw std::runtime_error("Decimal division by zero");
+  }
+  if constexpr (digits <= DEC128_MAX_PRECISION) {
+    using Common = Decimal<digits, Result::kScale>;
+    const typename Common::native_type remainder =
+        Common::template Upscale<S1>(left.Native()) %
+        Common::template Upscale<S2>(right.Native());
+    return Result::FromNative((typename Result::native_type)remainder);
+  } else {
+    decimal128_t remainder;
+    if (dec128_mod_checked(left.ToDecimal128().dec, S1,
+                           right.ToDecimal128().dec, S2,
+                           &remainder) != DEC128_STATUS_SUCCESS) {
+      throw std::runtime_error("dec128_mod_checked failed");
+    }
+    return Result::FromNative(
+        (typename Result::native_type)dec128::Storage<128>::Get(remainder));
+  }
+}
+
+template <int32_t P, int32_t S>
+inline Decimal<P, S> operator-(const Decimal<P, S> &operand) {
+  return Decimal<P, S>::FromNative(-operand.Native());
+}
+
+template <int32_t P, int32_t S>
+inline Decimal<P, S> Abs(const Decimal<P, S> &v) {
+  return v.Native() < 0 ? -v : v;
+}
+
+/// \brief Compare at the common scale, which must not need more than
+/// DEC128_MAX_PRECISION digits.
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline int DecimalCompare(const Decimal<P1, S1> &left,
+                          const Decimal<P2, S2> &right) {
+  using Common = Decimal<dec128::AddSubPrecision(P1, S1, P2, S2) - 1,
+                         dec128::AddSubScale(S1, S2)>;
+  const typename Common::native_type l =
+      Common::template Upscale<S1>(left.Native());
+  const typename Common::native_type r =
+      Common::template Upscale<S2>(right.Native());
+  return (l > r) - (l < r);
+}
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline bool operator==(const Decimal<P1, S1> &left,
+                       const Decimal<P2, S2> &right) {
+  return DecimalCompare(left, right) == 0;
+}
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline bool operator!=(const Decimal<P1, S1> &left,
+                       const Decimal<P2, S2> &right) {
+  return DecimalCompare(left, right) != 0;
+}
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline bool operator<(const Decimal<P1, S1> &left,
+                      const Decimal<P2, S2> &right) {
+  return DecimalCompare(left, right) < 0;
+}
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline bool operator<=(const Decimal<P1, S1> &left,
+                       const Decimal<P2, S2> &right) {
+  return DecimalCompare(left, right) <= 0;
+}
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline bool operator>(const Decimal<P1, S1> &left,
+                      const Decimal<P2, S2> &right) {
+  return DecimalCompare(left, right) > 0;
+}
+
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+inline bool operator>=(const Decimal<P1, S1> &left,
+                       const Decimal<P2, S2> &right) {
+  return DecimalCompare(left, right) >= 0;
+}
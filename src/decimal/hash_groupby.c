@@ -0,0 +1,282 @@
+#include "decimal/hash_groupby.h"
+#include "decimal/logging.h"
+#include "decimal/macros.h"
+
+#define kEmptySlot UINT32_MAX
+#define kDefaultCapacity 1024
+// rows hashed and prefetched ahead of probing, multiple of 8 so validity
+// bitmaps can be offset by whole bytes
+#define kProbeBatch 256
+
+// Slots only hold the group id and part of the hash, so a probe touches one
+// 8 byte slot and only loads the key on a tag match.
+typedef struct GroupSlot {
+  uint32_t group;
+  uint32_t tag;
+} GroupSlot;
+
+struct dec128_groupby_t {
+  size_t ncols;
+  GroupSlot *slots;
+  uint64_t mask; // number of slots - 1
+  decimal128_t *keys;
+  size_t ngroups;
+  size_t group_capacity;
+  dec128_agg_t **aggs; // ncols arrays indexed by group id
+};
+
+static inline bool KeyEquals(decimal128_t left, decimal128_t right) {
+  return ((left.array[0] ^ right.array[0]) |
+          (left.array[1] ^ right.array[1])) == 0;
+}
+
+static GroupSlot *AllocSlots(size_t nslots) {
+  GroupSlot *slots = malloc(nslots * sizeof(GroupSlot));
+  if (slots) {
+    // kEmptySlot is all ones
+    memset(slots, 0xFF, nslots * sizeof(GroupSlot));
+  }
+  return slots;
+}
+
+static bool GrowSlots(dec128_groupby_t *gb) {
+  const size_t nslots = (gb->mask + 1) * 2;
+  GroupSlot *slots = AllocSlots(nslots);
+  if (!slots) {
+    return false;
+  }
+  const uint64_t mask = nslots - 1;
+  for (size_t g = 0; g < gb->ngroups; g++) {
+    const uint64_t hash = dec128_hash(gb->keys[g]);
+    uint64_t pos = hash & mask;
+    while (slots[pos].group != kEmptySlot) {
+      pos = (pos + 1) & mask;
+    }
+    slots[pos].group = (uint32_t)g;
+    slots[pos].tag = (uint32_t)(hash >> 32);
+  }
+  free(gb->slots);
+  gb->slots = slots;
+  gb->mask = mask;
+  return true;
+}
+
+static bool GrowGroups(dec128_groupby_t *gb) {
+  const size_t capacity = gb->group_capacity * 2;
+  decimal128_t *keys = realloc(gb->keys, capacity * sizeof(decimal128_t));
+  if (!keys) {
+    return false;
+  }
+  gb->keys = keys;
+  for (size_t c = 0; c < gb->ncols; c++) {
+    dec128_agg_t *aggs = realloc(gb->aggs[c], capacity * sizeof(dec128_agg_t));
+    if (!aggs) {
+      return false;
+    }
+    gb->aggs[c] = aggs;
+  }
+  gb->group_capacity = capacity;
+  return true;
+}
+
+static decimal_status_t FindOrInsert(dec128_groupby_t *gb, decimal128_t key,
+                                     uint64_t hash, uint32_t *group) {
+  // keep the load factor at or below 1/2 so probe sequences stay short
+  if (DEC128_PREDICT_FALSE((gb->ngroups + 1) * 2 > gb->mask + 1)) {
+    if (!GrowSlots(gb)) {
+      return DEC128_STATUS_ERROR;
+    }
+  }
+
+  const uint32_t tag = (uint32_t)(hash >> 32);
+  uint64_t pos = hash & gb->mask;
+  for (;;) {
+    GroupSlot *slot = &gb->slots[pos];
+    if (slot->group == kEmptySlot) {
+      // group ids must stay below kEmptySlot, which marks free slots
+      if (DEC128_PREDICT_FALSE(gb->ngroups == kEmptySlot)) {
+        return DEC128_STATUS_ERROR;
+      }
+      if (gb->ngroups == gb->group_capacity && !GrowGroups(gb)) {
+        return DEC128_STATUS_ERROR;
+      }
+      const uint32_t g = (uint32_t)gb->ngroups++;
+      gb->keys[g] = key;
+      for (size_t c = 0; c < gb->ncols; c++) {
+        dec128_agg_init(&gb->aggs[c][g]);
+      }
+      slot->group = g;
+      slot->tag = tag;
+      *group = g;
+      return DEC128_STATUS_SUCCESS;
+    }
+    if (slot->tag == tag && KeyEquals(gb->keys[slot->group], key)) {
+      *group = slot->group;
+      return DEC128_STATUS_SUCCESS;
+    }
+    pos = (pos + 1) & gb->mask;
+  }
+}
+
+dec128_groupby_t *dec128_groupby_create(size_t ncols, size_t capacity) {
+  size_t nslots = kDefaultCapacity;
+  while (nslots < capacity * 2) {
+    nslots *= 2;
+  }
+
+  dec128_groupby_t *gb = calloc(1, sizeof(dec128_groupby_t));
+  if (!gb) {
+    return NULL;
+  }
+  gb->ncols = ncols;
+  gb->mask = nslots - 1;
+  gb->group_capacity = nslots / 2;
+  gb->slots = AllocSlots(nslots);
+  gb->keys = malloc(gb->group_capacity * sizeof(decimal128_t));
+  gb->aggs = calloc(ncols ? ncols : 1, sizeof(dec128_agg_t *));
+  if (!gb->slots || !gb->keys || !gb->aggs) {
+    dec128_groupby_destroy(gb);
+    return NULL;
+  }
+  for (size_t c = 0; c < ncols; c++) {
+    gb->aggs[c] = malloc(gb->group_capacity * sizeof(dec128_agg_t));
+    if (!gb->aggs[c]) {
+      dec128_groupby_destroy(gb);
+      return NULL;
+    }
+  }
+  return gb;
+}
+
+void dec128_groupby_destroy(dec128_groupby_t *gb) {
+  if (!gb) {
+    return;
+  }
+  if (gb->aggs) {
+    for (size_t c = 0; c < gb->ncols; c++) {
+      free(gb->aggs[c]);
+    }
+    free(gb->aggs);
+  }
+  free(gb->keys);
+  free(gb->slots);
+  free(gb);
+}
+
+decimal_status_t dec128_groupby_find_or_insert_batch(dec128_groupby_t *gb,
+                                                     const decimal128_t *keys,
+                                                     size_t n,
+                                                     uint32_t *group_ids) {
+  uint64_t hashes[kProbeBatch];
+  for (size_t base = 0; base < n; base += kProbeBatch) {
+    const size_t m = MIN(kProbeBatch, n - base);
+    // hash the whole batch first, then prefetch, so the slot loads of
+    // different rows overlap instead of stalling one after the other
+    for (size_t i = 0; i < m; i++) {
+      hashes[i] = dec128_hash(keys[base + i]);
+    }
+    for (size_t i = 0; i < m; i++) {
+      DEC128_PREFETCH(&gb->slots[hashes[i] & gb->mask]);
+    }
+    for (size_t i = 0; i < m; i++) {
+      decimal_status_t s =
+          FindOrInsert(gb, keys[base + i], hashes[i], &group_ids[base + i]);
+      if (s != DEC128_STATUS_SUCCESS) {
+        return s;
+      }
+    }
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t
+dec128_groupby_accumulate_batch(dec128_groupby_t *gb, const decimal128_t *keys,
+                                const decimal128_t *const *columns,
+                                const uint8_t *const *validity, size_t n) {
+  uint32_t group_ids[kProbeBatch];
+  for (size_t base = 0; base < n; base += kProbeBatch) {
+    const size_t m = MIN(kProbeBatch, n - base);
+    decimal_status_t s =
+        dec128_groupby_find_or_insert_batch(gb, keys + base, m, group_ids);
+    if (s != DEC128_STATUS_SUCCESS) {
+      return s;
+    }
+    for (size_t c = 0; c < gb->ncols; c++) {
+      const uint8_t *valid =
+          (validity && validity[c]) ? validity[c] + base / 8 : NULL;
+      dec128_agg_update_grouped(gb->aggs[c], group_ids, columns[c] + base,
+                                valid, m);
+    }
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec128_groupby_merge(dec128_groupby_t *gb,
+                                      const dec128_groupby_t *other) {
+  DCHECK_EQ(gb->ncols, other->ncols);
+
+  uint32_t group_ids[kProbeBatch];
+  for (size_t base = 0; base < other->ngroups; base += kProbeBatch) {
+    const size_t m = MIN(kProbeBatch, other->ngroups - base);
+    decimal_status_t s = dec128_groupby_find_or_insert_batch(
+        gb, other->keys + base, m, group_ids);
+    if (s != DEC128_STATUS_SUCCESS) {
+      return s;
+    }
+    for (size_t c = 0; c < gb->ncols; c++) {
+      for (size_t i = 0; i < m; i++) {
+        dec128_agg_combine(&gb->aggs[c][group_ids[i]],
+                           &other->aggs[c][base + i]);
+      }
+    }
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+size_t dec128_groupby_ngroups(const dec128_groupby_t *gb) {
+  return gb->ngroups;
+}
+
+const decimal128_t *dec128_groupby_keys(const dec128_groupby_t *gb) {
+  return gb->keys;
+}
+
+const dec128_agg_t *dec128_groupby_aggs(const dec128_groupby_t *gb,
+                                        size_t col) {
+  DCHECK_LT(col, gb->ncols);
+  return gb->aggs[col];
+}
+
+size_t dec128_groupby_finalize_sum(const dec128_groupby_t *gb, size_t col,
+                                   int32_t precision, decimal128_t *sums,
+                                   uint8_t *validity, uint8_t *overflow) {
+  DCHECK_LT(col, gb->ncols);
+
+  size_t noverflow = 0;
+  if (validity) {
+    memset(validity, 0, (gb->ngroups + 7) / 8);
+  }
+  if (overflow) {
+    memset(overflow, 0, (gb->ngroups + 7) / 8);
+  }
+  for (size_t g = 0; g < gb->ngroups; g++) {
+    const uint8_t bit = (uint8_t)(1U << (g % 8));
+    const decimal_status_t s =
+        dec128_agg_sum(&gb->aggs[col][g], precision, &sums[g]);
+    if (s == DEC128_STATUS_SUCCESS) {
+      if (validity) {
+        validity[g / 8] |= bit;
+      }
+      continue;
+    }
+    sums[g] = (decimal128_t){0};
+    // DEC128_STATUS_ERROR is an empty group, a NULL rather than an overflow
+    if (s == DEC128_STATUS_OVERFLOW) {
+      if (overflow) {
+        overflow[g / 8] |= bit;
+      }
+      noverflow++;
+    }
+  }
+  return noverflow;
+}
@@ -0,0 +1,71 @@
+#ifndef _HASH_GROUPBY_H_
+#define _HASH_GROUPBY_H_
+
+#include "decimal/batch_decimal.h"
+
+DEC128_EXTERN_BEGIN
+
+/*
+ * Hash GROUP BY keyed by decimal128_t.
+ *
+ * Keys are assigned dense group ids (0, 1, 2, ... in first seen order) by an
+ * open addressing table. Each group keeps one dec128_agg_t per aggregated
+ * column, so SUM, AVG, MIN, MAX and COUNT are all available at finalize.
+ *
+ * Usage:
+ *   dec128_groupby_t *gb = dec128_groupby_create(ncols, 0);
+ *   for each vector:
+ *     dec128_groupby_accumulate_batch(gb, keys, columns, validity, n);
+ *   dec128_groupby_merge(gb, partial);   (optional)
+ *   dec128_groupby_finalize_sum(gb, col, precision, sums, validity,
+ *                               overflow);
+ *   dec128_groupby_destroy(gb);
+ */
+typedef struct dec128_groupby_t dec128_groupby_t;
+
+/* ncols is the number of aggregated columns, capacity a hint for the number
+ * of groups (0 for a default). Returns NULL if out of memory. */
+dec128_groupby_t *dec128_groupby_create(size_t ncols, size_t capacity);
+
+void dec128_groupby_destroy(dec128_groupby_t *gb);
+
+/* Look up the group id of each key, inserting new groups as needed.
+ * DEC128_STATUS_ERROR if out of memory or past UINT32_MAX - 1 groups. */
+decimal_status_t dec128_groupby_find_or_insert_batch(dec128_groupby_t *gb,
+                                                     const decimal128_t *keys,
+                                                     size_t n,
+                                                     uint32_t *group_ids);
+
+/* columns[c][i] is accumulated into column c of the group of keys[i].
+ * validity may be NULL, or hold one Arrow validity bitmap (or NULL) per
+ * column. */
+decimal_status_t
+dec128_groupby_accumulate_batch(dec128_groupby_t *gb, const decimal128_t *keys,
+                                const decimal128_t *const *columns,
+                                const uint8_t *const *validity, size_t n);
+
+/* Fold the groups of other into gb. Both must have the same ncols. */
+decimal_status_t dec128_groupby_merge(dec128_groupby_t *gb,
+                                      const dec128_groupby_t *other);
+
+size_t dec128_groupby_ngroups(const dec128_groupby_t *gb);
+
+/* Keys indexed by group id. */
+const decimal128_t *dec128_groupby_keys(const dec128_groupby_t *gb);
+
+/* Aggregate states of column col, indexed by group id. */
+const dec128_agg_t *dec128_groupby_aggs(const dec128_groupby_t *gb,
+                                        size_t col);
+
+/* Write the SUM of column col for every group. Groups whose sum does not
+ * fit in precision get their bit set in the overflow bitmap, groups with no
+ * valid rows in col have a NULL sum. Both get a zero sum and a 0 bit in the
+ * Arrow validity bitmap of the sums. Either bitmap may be NULL. Returns the
+ * number of overflowing groups. */
+size_t dec128_groupby_finalize_sum(const dec128_groupby_t *gb, size_t col,
+                                   int32_t precision, decimal128_t *sums,
+                                   uint8_t *validity, uint8_t *overflow);
+
+DEC128_EXTERN_END
+
+#endif
@@ -0,0 +1,247 @@
+#ifndef _INLINE_DECIMAL_H_
+#define _INLINE_DECIMAL_H_
+
+/*
+ * The trivial decimal128 operations: comparison, negate, abs, sum, subtract,
+ * multiply and bitwise operations.
+ *
+ * Defining DEC128_INLINE before including basic_decimal.h makes them static
+ * inline in the includer, so loops and comparators calling them compile to
+ * straight-line code. basic_decimal.c defines an empty DEC128_INLINE_FN to
+ * export the same definitions, which callers built without DEC128_INLINE
+ * link against.
+ */
+
+/* two's complement conversions to and from the native 128-bit integer */
+#ifdef __SIZEOF_INT128__
+static inline __int128 dec128_to_int128(decimal128_t v) {
+  return (__int128)(((unsigned __int128)dec128_high_bits(v) << 64) |
+                    dec128_low_bits(v));
+}
+
+static inline decimal128_t dec128_from_int128(__int128 x) {
+  return dec128_from_hilo((int64_t)(x >> 64), (uint64_t)x);
+}
+#endif
+
+#if defined(DEC128_INLINE) || defined(DEC128_INLINE_FN)
+#ifndef DEC128_INLINE_FN
+#define DEC128_INLINE_FN static inline
+#endif
+
+/*
+ * Backend: plain 128-bit integer arithmetic where the compiler has __int128,
+ * so a compare or a sum is 2 or 3 instructions, otherwise the same operations
+ * on the two 64-bit words. DEC128_USE_INT128=0 forces the word based code.
+ */
+#ifndef DEC128_USE_INT128
+#ifdef __SIZEOF_INT128__
+#define DEC128_USE_INT128 1
+#else
+#define DEC128_USE_INT128 0
+#endif
+#endif
+
+#if DEC128_USE_INT128
+/* comparison */
+DEC128_INLINE_FN bool dec128_cmpeq(decimal128_t left, decimal128_t right) {
+  return dec128_to_int128(left) == dec128_to_int128(right);
+}
+
+DEC128_INLINE_FN bool dec128_cmplt(decimal128_t left, decimal128_t right) {
+  return dec128_to_int128(left) < dec128_to_int128(right);
+}
+
+/* negate, wrapping like the other operations */
+DEC128_INLINE_FN decimal128_t dec128_negate(decimal128_t v) {
+  return dec128_from_int128(
+      (__int128)(-(unsigned __int128)dec128_to_int128(v)));
+}
+
+/* sum */
+DEC128_INLINE_FN decimal128_t dec128_sum(decimal128_t left,
+                                         decimal128_t right) {
+  return dec128_from_int128(
+      (__int128)((unsigned __int128)dec128_to_int128(left) +
+                 (unsigned __int128)dec128_to_int128(right)));
+}
+
+/* subtract */
+DEC128_INLINE_FN decimal128_t dec128_subtract(decimal128_t left,
+                                              decimal128_t right) {
+  return dec128_from_int128(
+      (__int128)((unsigned __int128)dec128_to_int128(left) -
+                 (unsigned __int128)dec128_to_int128(right)));
+}
+
+/* multiply */
+// The low 128 bits of a two's complement product do not depend on the signs
+// of the operands
+DEC128_INLINE_FN decimal128_t dec128_multiply(decimal128_t left,
+                                              decimal128_t right) {
+  return dec128_from_int128(
+      (__int128)((unsigned __int128)dec128_to_int128(left) *
+                 (unsigned __int128)dec128_to_int128(right)));
+}
+#else
+/* comparison */
+DEC128_INLINE_FN bool dec128_cmpeq(decimal128_t left, decimal128_t right) {
+  return dec128_high_bits(left) == dec128_high_bits(right) &&
+         dec128_low_bits(left) == dec128_low_bits(right);
+}
+
+DEC128_INLINE_FN bool dec128_cmplt(decimal128_t left, decimal128_t right) {
+  return dec128_high_bits(left) < dec128_high_bits(right) ||
+         (dec128_high_bits(left) == dec128_high_bits(right) &&
+          dec128_low_bits(left) < dec128_low_bits(right));
+}
+
+/* negate */
+DEC128_INLINE_FN decimal128_t dec128_negate(decimal128_t v) {
+  const uint64_t result_lo = ~dec128_low_bits(v) + 1;
+  const uint64_t result_hi =
+      ~(uint64_t)dec128_high_bits(v) + (uint64_t)(result_lo == 0);
+  return dec128_from_hilo((int64_t)result_hi, result_lo);
+}
+
+/* sum */
+DEC128_INLINE_FN decimal128_t dec128_sum(decimal128_t left,
+                                         decimal128_t right) {
+  const uint64_t result_lo = dec128_low_bits(left) + dec128_low_bits(right);
+  const uint64_t result_hi = (uint64_t)dec128_high_bits(left) +
+                             (uint64_t)dec128_high_bits(right) +
+                             (uint64_t)(result_lo < dec128_low_bits(left));
+  return dec128_from_hilo((int64_t)result_hi, result_lo);
+}
+
+/* subtract */
+DEC128_INLINE_FN decimal128_t dec128_subtract(decimal128_t left,
+                                              decimal128_t right) {
+  const uint64_t result_lo = dec128_low_bits(left) - dec128_low_bits(right);
+  const uint64_t result_hi = (uint64_t)dec128_high_bits(left) -
+                             (uint64_t)dec128_high_bits(right) -
+                             (uint64_t)(result_lo > dec128_low_bits(left));
+  return dec128_from_hilo((int64_t)result_hi, result_lo);
+}
+
+/* multiply */
+// 64 x 64 -> 128 bit product of the low words from 32-bit halves
+static inline uint64_t dec128_multiply_words(uint64_t x, uint64_t y,
+                                             uint64_t *high) {
+  const uint64_t x_lo = x & 0xFFFFFFFF, x_hi = x >> 32;
+  const uint64_t y_lo = y & 0xFFFFFFFF, y_hi = y >> 32;
+  const uint64_t lo_lo = x_lo * y_lo;
+  const uint64_t hi_lo = x_hi * y_lo;
+  const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + x_lo * y_hi;
+  *high = x_hi * y_hi + (hi_lo >> 32) + (cross >> 32);
+  return (cross << 32) | (lo_lo & 0xFFFFFFFF);
+}
+
+// The low 128 bits of a two's complement product do not depend on the signs
+// of the operands
+DEC128_INLINE_FN decimal128_t dec128_multiply(decimal128_t left,
+                                              decimal128_t right) {
+  uint64_t high;
+  const uint64_t low = dec128_multiply_words(dec128_low_bits(left),
+                                             dec128_low_bits(right), &high);
+  high += (uint64_t)dec128_high_bits(left) * dec128_low_bits(right) +
+          dec128_low_bits(left) * (uint64_t)dec128_high_bits(right);
+  return dec128_from_hilo((int64_t)high, low);
+}
+#endif
+
+DEC128_INLINE_FN bool dec128_cmpne(decimal128_t left, decimal128_t right) {
+  return !dec128_cmpeq(left, right);
+}
+
+DEC128_INLINE_FN bool dec128_cmpgt(decimal128_t left, decimal128_t right) {
+  return dec128_cmplt(right, left);
+}
+
+DEC128_INLINE_FN bool dec128_cmpge(decimal128_t left, decimal128_t right) {
+  return !dec128_cmplt(left, right);
+}
+
+DEC128_INLINE_FN bool dec128_cmple(decimal128_t left, decimal128_t right) {
+  return !dec128_cmpgt(left, right);
+}
+
+/* absolute */
+DEC128_INLINE_FN decimal128_t *dec128_abs_inplace(decimal128_t *v) {
+  if (dec128_is_negative(*v)) {
+    *v = dec128_negate(*v);
+  }
+  return v;
+}
+
+DEC128_INLINE_FN decimal128_t dec128_abs(decimal128_t v) {
+  return dec128_is_negative(v) ? dec128_negate(v) : v;
+}
+
+/* bitwise and */
+DEC128_INLINE_FN decimal128_t dec128_bitwise_and(decimal128_t left,
+                                                 decimal128_t right) {
+  decimal128_t res;
+  res.array[0] = left.array[0] & right.array[0];
+  res.array[1] = left.array[1] & right.array[1];
+  return res;
+}
+
+/* bitwise or */
+DEC128_INLINE_FN decimal128_t dec128_bitwise_or(decimal128_t left,
+                                                decimal128_t right) {
+  decimal128_t res;
+  res.array[0] = left.array[0] | right.array[0];
+  res.array[1] = left.array[1] | right.array[1];
+  return res;
+}
+
+/* bitwise shift left */
+DEC128_INLINE_FN decimal128_t dec128_bitwise_shift_left(decimal128_t v,
+                                                        uint32_t bits) {
+  decimal128_t res = v;
+  if (bits != 0) {
+    uint64_t result_lo;
+    uint64_t result_hi;
+    if (bits < 64) {
+      result_hi = (uint64_t)dec128_high_bits(v) << bits;
+      result_hi |= (dec128_low_bits(v) >> (64 - bits));
+      result_lo = dec128_low_bits(v) << bits;
+    } else if (bits < 128) {
+      result_hi = dec128_low_bits(v) << (bits - 64);
+      result_lo = 0;
+    } else {
+      result_hi = 0;
+      result_lo = 0;
+    }
+    res = dec128_from_hilo((int64_t)result_hi, result_lo);
+  }
+  return res;
+}
+
+/* bitwise shift right */
+DEC128_INLINE_FN decimal128_t dec128_bitwise_shift_right(decimal128_t v,
+                                                         uint32_t bits) {
+  decimal128_t res = v;
+  if (bits != 0) {
+    uint64_t result_lo;
+    int64_t result_hi;
+    if (bits < 64) {
+      result_lo = dec128_low_bits(v) >> bits;
+      result_lo |= (uint64_t)(dec128_high_bits(v)) << (64 - bits);
+      result_hi = dec128_high_bits(v) >> bits;
+    } else if (bits < 128) {
+      result_lo = (uint64_t)(dec128_high_bits(v) >> (bits - 64));
+      result_hi = dec128_high_bits(v) >> 63;
+    } else {
+      result_hi = dec128_high_bits(v) >> 63;
+      result_lo = (uint64_t)(result_hi);
+    }
+    res = dec128_from_hilo(result_hi, result_lo);
+  }
+  return res;
+}
+
+#endif /* DEC128_INLINE || DEC128_INLINE_FN */
+
+#endif
@@ -17,7 +17,23 @@
     }                                                                          \
   } while (0)
 
-#if 0
+/*
+ * DEC128_CHECK_LEVEL selects the internal consistency checks:
+ *   0  DCHECK_* compile to nothing, as in libdec128.a
+ *   1  DCHECK_* abort on failure, as in libdec128_checked.a and DEBUG builds
+ * It defaults to 0 under NDEBUG and to 1 otherwise. CHECKX and Insist stay at
+ * every level; callers that cannot trust their arguments use the _checked
+ * entry points, which return a status instead.
+ */
+#ifndef DEC128_CHECK_LEVEL
+#ifdef NDEBUG
+#define DEC128_CHECK_LEVEL 0
+#else
+#define DEC128_CHECK_LEVEL 1
+#endif
+#endif
+
+#if DEC128_CHECK_LEVEL == 0
 #define DEC128_IGNORE_EXPR(expr) ((void)(expr))
 
 #define DCHECK(condition) DEC128_IGNORE_EXPR(condition)
@@ -0,0 +1,218 @@
+#include "decimal/narrow_decimal.h"
+#include "decimal/decimal_internal.h"
+#include "decimal/logging.h"
+#include <limits.h>
+
+/* narrowing */
+decimal_status_t dec64_to_dec32(decimal64_t v, decimal32_t *out) {
+  if (v.value < INT32_MIN || v.value > INT32_MAX) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = dec32_from_int32((int32_t)v.value);
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec128_to_dec64(decimal128_t v, decimal64_t *out) {
+  // the high word must be the sign extension of the low word
+  if (dec128_high_bits(v) != ((int64_t)dec128_low_bits(v) >> 63)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = dec64_from_int64((int64_t)dec128_low_bits(v));
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec128_to_dec32(decimal128_t v, decimal32_t *out) {
+  decimal64_t v64;
+  decimal_status_t s = dec128_to_dec64(v, &v64);
+  if (s != DEC128_STATUS_SUCCESS) {
+    return s;
+  }
+  return dec64_to_dec32(v64, out);
+}
+
+/* divide */
+decimal_status_t dec32_divide(decimal32_t dividend, decimal32_t divisor,
+                              decimal32_t *result, decimal32_t *remainder) {
+  if (divisor.value == 0) {
+    return DEC128_STATUS_DIVIDEDBYZERO;
+  }
+  if (dividend.value == INT32_MIN && divisor.value == -1) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  // C division truncates toward zero and the remainder takes the sign of
+  // the dividend, same as dec128_divide
+  *result = dec32_from_int32(dividend.value / divisor.value);
+  *remainder = dec32_from_int32(dividend.value % divisor.value);
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec64_divide(decimal64_t dividend, decimal64_t divisor,
+                              decimal64_t *result, decimal64_t *remainder) {
+  if (divisor.value == 0) {
+    return DEC128_STATUS_DIVIDEDBYZERO;
+  }
+  if (dividend.value == INT64_MIN && divisor.value == -1) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *result = dec64_from_int64(dividend.value / divisor.value);
+  *remainder = dec64_from_int64(dividend.value % divisor.value);
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* fits in precision */
+static inline bool FitsInPrecision(int64_t v, int32_t precision,
+                                   int32_t max_precision) {
+  if (!(precision > 0 && precision <= max_precision)) {
+    return false;
+  }
+  const uint64_t abs = v < 0 ? ~(uint64_t)v + 1 : (uint64_t)v;
+  return abs < kUInt64PowersOfTen[precision];
+}
+
+bool dec32_fits_in_precision(decimal32_t v, int32_t precision) {
+  return FitsInPrecision(v.value, precision, DEC32_MAX_PRECISION);
+}
+
+bool dec64_fits_in_precision(decimal64_t v, int32_t precision) {
+  return FitsInPrecision(v.value, precision, DEC64_MAX_PRECISION);
+}
+
+/* rescale */
+static decimal_status_t Rescale(int64_t v, int32_t delta_scale, int64_t min,
+                                int64_t max, int64_t *out) {
+  if (delta_scale == 0) {
+    *out = v;
+    return DEC128_STATUS_SUCCESS;
+  }
+
+  if (delta_scale > 0) {
+    if (delta_scale > kInt64DecimalDigits) {
+      *out = 0;
+      return v == 0 ? DEC128_STATUS_SUCCESS : DEC128_STATUS_RESCALEDATALOSS;
+    }
+    __int128_t r = (__int128_t)v * (int64_t)kUInt64PowersOfTen[delta_scale];
+    *out = (int64_t)r;
+    return (r < min || r > max) ? DEC128_STATUS_RESCALEDATALOSS
+                                : DEC128_STATUS_SUCCESS;
+  }
+
+  if (-delta_scale > kInt64DecimalDigits) {
+    *out = 0;
+    return v == 0 ? DEC128_STATUS_SUCCESS : DEC128_STATUS_RESCALEDATALOSS;
+  }
+  const int64_t divisor = (int64_t)kUInt64PowersOfTen[-delta_scale];
+  *out = v / divisor;
+  return (v % divisor) != 0 ? DEC128_STATUS_RESCALEDATALOSS
+                            : DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec32_rescale(decimal32_t v, int32_t original_scale,
+                               int32_t new_scale, decimal32_t *out) {
+  DCHECK_NE(out, NULL);
+  int64_t r;
+  decimal_status_t s =
+      Rescale(v.value, new_scale - original_scale, INT32_MIN, INT32_MAX, &r);
+  *out = dec32_from_int32((int32_t)r);
+  return s;
+}
+
+decimal_status_t dec64_rescale(decimal64_t v, int32_t original_scale,
+                               int32_t new_scale, decimal64_t *out) {
+  DCHECK_NE(out, NULL);
+  int64_t r;
+  decimal_status_t s =
+      Rescale(v.value, new_scale - original_scale, INT64_MIN, INT64_MAX, &r);
+  *out = dec64_from_int64(r);
+  return s;
+}
+
+decimal32_t dec32_increase_scale_by(decimal32_t v, int32_t increase_by) {
+  DCHECK_GE(increase_by, 0);
+  DCHECK_LE(increase_by, DEC32_MAX_PRECISION);
+
+  return dec32_multiply(
+      v, dec32_from_int32((int32_t)kUInt64PowersOfTen[increase_by]));
+}
+
+decimal64_t dec64_increase_scale_by(decimal64_t v, int32_t increase_by) {
+  DCHECK_GE(increase_by, 0);
+  DCHECK_LE(increase_by, DEC64_MAX_PRECISION);
+
+  return dec64_multiply(
+      v, dec64_from_int64((int64_t)kUInt64PowersOfTen[increase_by]));
+}
+
+static inline int64_t ReduceScaleBy(int64_t v, int32_t reduce_by, bool round) {
+  if (reduce_by == 0) {
+    return v;
+  }
+  const int64_t divisor = (int64_t)kUInt64PowersOfTen[reduce_by];
+  int64_t result = v / divisor;
+  if (round) {
+    const int64_t remainder = v % divisor;
+    // round half away from zero, same as dec128_reduce_scale_by
+    if ((remainder < 0 ? -remainder : remainder) >= divisor / 2) {
+      result += v < 0 ? -1 : 1;
+    }
+  }
+  return result;
+}
+
+decimal32_t dec32_reduce_scale_by(decimal32_t v, int32_t reduce_by,
+                                  bool round) {
+  DCHECK_GE(reduce_by, 0);
+  DCHECK_LE(reduce_by, DEC32_MAX_PRECISION);
+
+  return dec32_from_int32((int32_t)ReduceScaleBy(v.value, reduce_by, round));
+}
+
+decimal64_t dec64_reduce_scale_by(decimal64_t v, int32_t reduce_by,
+                                  bool round) {
+  DCHECK_GE(reduce_by, 0);
+  DCHECK_LE(reduce_by, DEC64_MAX_PRECISION);
+
+  return dec64_from_int64(ReduceScaleBy(v.value, reduce_by, round));
+}
+
+/* string conversion */
+decimal_status_t dec32_from_string(const char *s, decimal32_t *out,
+                                   int32_t *precision, int32_t *scale) {
+  decimal128_t v;
+  int32_t parsed_precision;
+  decimal_status_t status = dec128_from_string(s, &v, &parsed_precision, scale);
+  if (status != DEC128_STATUS_SUCCESS) {
+    return status;
+  }
+  if (parsed_precision > DEC32_MAX_PRECISION) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  if (precision != NULL) {
+    *precision = parsed_precision;
+  }
+  return out ? dec128_to_dec32(v, out) : DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec64_from_string(const char *s, decimal64_t *out,
+                                   int32_t *precision, int32_t *scale) {
+  decimal128_t v;
+  int32_t parsed_precision;
+  decimal_status_t status = dec128_from_string(s, &v, &parsed_precision, scale);
+  if (status != DEC128_STATUS_SUCCESS) {
+    return status;
+  }
+  if (parsed_precision > DEC64_MAX_PRECISION) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  if (precision != NULL) {
+    *precision = parsed_precision;
+  }
+  return out ? dec128_to_dec64(v, out) : DEC128_STATUS_SUCCESS;
+}
+
+void dec32_to_string(decimal32_t v, char *out, int32_t scale) {
+  dec128_to_string(dec32_to_dec128(v), out, scale);
+}
+
+void dec64_to_string(decimal64_t v, char *out, int32_t scale) {
+  dec128_to_string(dec64_to_dec128(v), out, scale);
+}
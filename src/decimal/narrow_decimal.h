@@ -0,0 +1,201 @@
+#ifndef _NARROW_DECIMAL_H_
+#define _NARROW_DECIMAL_H_
+
+#include "decimal/basic_decimal.h"
+
+DEC128_EXTERN_BEGIN
+
+/*
+ * 32 and 64-bit decimals for DECIMAL(p <= 9, s) and DECIMAL(p <= 18, s)
+ * columns. The value is the unscaled integer, exactly like decimal128_t, and
+ * the result precision and scale of an operation follow the same rules, see
+ * dec128_ADD_SUB_precision_scale() and friends. When the result precision
+ * exceeds DEC32_MAX_PRECISION or DEC64_MAX_PRECISION, use the _wide
+ * variants, which return the next wider type and cannot overflow.
+ */
+#define DEC32_MAX_PRECISION 9
+#define DEC64_MAX_PRECISION 18
+
+typedef struct decimal32_t {
+  int32_t value;
+} decimal32_t;
+
+typedef struct decimal64_t {
+  int64_t value;
+} decimal64_t;
+
+static inline decimal32_t dec32_from_int32(int32_t v) {
+  decimal32_t dec = {v};
+  return dec;
+}
+
+static inline decimal64_t dec64_from_int64(int64_t v) {
+  decimal64_t dec = {v};
+  return dec;
+}
+
+/* widening, always exact */
+static inline decimal64_t dec32_to_dec64(decimal32_t v) {
+  return dec64_from_int64(v.value);
+}
+
+static inline decimal128_t dec32_to_dec128(decimal32_t v) {
+  return dec128_from_int64(v.value);
+}
+
+static inline decimal128_t dec64_to_dec128(decimal64_t v) {
+  return dec128_from_int64(v.value);
+}
+
+/* narrowing, DEC128_STATUS_OVERFLOW if the value does not fit */
+decimal_status_t dec64_to_dec32(decimal64_t v, decimal32_t *out);
+
+decimal_status_t dec128_to_dec32(decimal128_t v, decimal32_t *out);
+
+decimal_status_t dec128_to_dec64(decimal128_t v, decimal64_t *out);
+
+/* comparison */
+static inline bool dec32_cmpeq(decimal32_t left, decimal32_t right) {
+  return left.value == right.value;
+}
+static inline bool dec32_cmpne(decimal32_t left, decimal32_t right) {
+  return left.value != right.value;
+}
+static inline bool dec32_cmplt(decimal32_t left, decimal32_t right) {
+  return left.value < right.value;
+}
+static inline bool dec32_cmpgt(decimal32_t left, decimal32_t right) {
+  return left.value > right.value;
+}
+static inline bool dec32_cmpge(decimal32_t left, decimal32_t right) {
+  return left.value >= right.value;
+}
+static inline bool dec32_cmple(decimal32_t left, decimal32_t right) {
+  return left.value <= right.value;
+}
+
+static inline bool dec64_cmpeq(decimal64_t left, decimal64_t right) {
+  return left.value == right.value;
+}
+static inline bool dec64_cmpne(decimal64_t left, decimal64_t right) {
+  return left.value != right.value;
+}
+static inline bool dec64_cmplt(decimal64_t left, decimal64_t right) {
+  return left.value < right.value;
+}
+static inline bool dec64_cmpgt(decimal64_t left, decimal64_t right) {
+  return left.value > right.value;
+}
+static inline bool dec64_cmpge(decimal64_t left, decimal64_t right) {
+  return left.value >= right.value;
+}
+static inline bool dec64_cmple(decimal64_t left, decimal64_t right) {
+  return left.value <= right.value;
+}
+
+/* arithmetic, truncated to the width of the type like the dec128 versions */
+static inline decimal32_t dec32_sum(decimal32_t left, decimal32_t right) {
+  return dec32_from_int32((int32_t)((uint32_t)left.value + right.value));
+}
+static inline decimal32_t dec32_subtract(decimal32_t left, decimal32_t right) {
+  return dec32_from_int32((int32_t)((uint32_t)left.value - right.value));
+}
+static inline decimal32_t dec32_multiply(decimal32_t left, decimal32_t right) {
+  return dec32_from_int32((int32_t)((uint32_t)left.value * right.value));
+}
+static inline decimal32_t dec32_negate(decimal32_t v) {
+  return dec32_from_int32((int32_t)(~(uint32_t)v.value + 1));
+}
+static inline bool dec32_is_negative(decimal32_t v) { return v.value < 0; }
+static inline decimal32_t dec32_abs(decimal32_t v) {
+  return dec32_is_negative(v) ? dec32_negate(v) : v;
+}
+
+static inline decimal64_t dec64_sum(decimal64_t left, decimal64_t right) {
+  return dec64_from_int64((int64_t)((uint64_t)left.value + right.value));
+}
+static inline decimal64_t dec64_subtract(decimal64_t left, decimal64_t right) {
+  return dec64_from_int64((int64_t)((uint64_t)left.value - right.value));
+}
+static inline decimal64_t dec64_multiply(decimal64_t left, decimal64_t right) {
+  return dec64_from_int64((int64_t)((uint64_t)left.value * right.value));
+}
+static inline decimal64_t dec64_negate(decimal64_t v) {
+  return dec64_from_int64((int64_t)(~(uint64_t)v.value + 1));
+}
+static inline bool dec64_is_negative(decimal64_t v) { return v.value < 0; }
+static inline decimal64_t dec64_abs(decimal64_t v) {
+  return dec64_is_negative(v) ? dec64_negate(v) : v;
+}
+
+/* exact arithmetic into the next wider type */
+static inline decimal64_t dec32_sum_wide(decimal32_t left, decimal32_t right) {
+  return dec64_from_int64((int64_t)left.value + right.value);
+}
+static inline decimal64_t dec32_subtract_wide(decimal32_t left,
+                                              decimal32_t right) {
+  return dec64_from_int64((int64_t)left.value - right.value);
+}
+static inline decimal64_t dec32_multiply_wide(decimal32_t left,
+                                              decimal32_t right) {
+  return dec64_from_int64((int64_t)left.value * right.value);
+}
+
+static inline decimal128_t dec64_sum_wide(decimal64_t left,
+                                          decimal64_t right) {
+  __int128_t r = (__int128_t)left.value + right.value;
+  return dec128_from_int128(r);
+}
+static inline decimal128_t dec64_subtract_wide(decimal64_t left,
+                                               decimal64_t right) {
+  __int128_t r = (__int128_t)left.value - right.value;
+  return dec128_from_int128(r);
+}
+static inline decimal128_t dec64_multiply_wide(decimal64_t left,
+                                               decimal64_t right) {
+  __int128_t r = (__int128_t)left.value * right.value;
+  return dec128_from_int128(r);
+}
+
+decimal_status_t dec32_divide(decimal32_t dividend, decimal32_t divisor,
+                              decimal32_t *result, decimal32_t *remainder);
+
+decimal_status_t dec64_divide(decimal64_t dividend, decimal64_t divisor,
+                              decimal64_t *result, decimal64_t *remainder);
+
+/* precision and scale */
+bool dec32_fits_in_precision(decimal32_t v, int32_t precision);
+
+bool dec64_fits_in_precision(decimal64_t v, int32_t precision);
+
+decimal_status_t dec32_rescale(decimal32_t v, int32_t original_scale,
+                               int32_t new_scale, decimal32_t *out);
+
+decimal_status_t dec64_rescale(decimal64_t v, int32_t original_scale,
+                               int32_t new_scale, decimal64_t *out);
+
+decimal32_t dec32_increase_scale_by(decimal32_t v, int32_t increase_by);
+
+decimal64_t dec64_increase_scale_by(decimal64_t v, int32_t increase_by);
+
+decimal32_t dec32_reduce_scale_by(decimal32_t v, int32_t reduce_by,
+                                  bool round);
+
+decimal64_t dec64_reduce_scale_by(decimal64_t v, int32_t reduce_by,
+                                  bool round);
+
+/* string conversion, DEC128_STATUS_OVERFLOW if the parsed precision does
+ * not fit the type */
+decimal_status_t dec32_from_string(const char *s, decimal32_t *out,
+                                   int32_t *precision, int32_t *scale);
+
+decimal_status_t dec64_from_string(const char *s, decimal64_t *out,
+                                   int32_t *precision, int32_t *scale);
+
+void dec32_to_string(decimal32_t v, char *out, int32_t scale);
+
+void dec64_to_string(decimal64_t v, char *out, int32_t scale);
+
+DEC128_EXTERN_END
+
+#endif
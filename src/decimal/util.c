@@ -8,21 +8,11 @@
 #include <limits.h>
 #include <math.h>
 
-#define NBASE 10000
-#define HALF_NBASE 5000
-#define DEC_DIGITS 4
-#define MUL_GUARD_DIGITS 2
-#define DIV_GUARD_DIGITS 4
-
 #if DEC128_LITTLE_ENDIAN
 // same as kDecimal128PowersOfTen[38] - 1
 static const decimal128_t const_one = {{1, 0}};
-static const decimal128_t const_nbase = {{NBASE, 0}};
-static const decimal128_t const_half_nbase = {{HALF_NBASE, 0}};
 #else
 static const decimal128_t const_one = {{0, 1}};
-static const decimal128_t const_nbase = {{0, NBASE}};
-static const decimal128_t const_half_nbase = {{0, HALF_NBASE}};
 #endif
 
 static const decimal128_t const_zero = {0};
@@ -74,54 +64,77 @@ void dec128_MOD_precision_scale(int p1, int s1, int p2, int s2, int *precision,
 }
 
 // ret_precision and ret_scale must be calculated by dec_DIV_precison_scale
-decimal128_t dec128_divide_exact(decimal128_t A, int32_t Ascale, decimal128_t B,
-                                 int32_t Bscale, int ret_precision,
-                                 int ret_scale) {
-
-  decimal128_t ret, result, remainder0;
-
-  CHECKX(dec128_cmpne(B, const_zero), "division by zero");
-
-  if (dec128_cmpeq(A, const_zero)) {
-    return A;
+decimal_status_t dec128_divide_exact(decimal128_t A, int32_t Ascale,
+                                     decimal128_t B, int32_t Bscale,
+                                     int ret_precision, int ret_scale,
+                                     decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+
+  if (dec128_cmpeq(B, const_zero)) {
+    return DEC128_STATUS_DIVIDEDBYZERO;
   }
 
-  if (Ascale > Bscale) {
-    B = dec128_increase_scale_by(B, Ascale - Bscale);
-  } else if (Bscale > Ascale) {
-    A = dec128_increase_scale_by(A, Bscale - Ascale);
+  if (dec128_cmpeq(A, const_zero)) {
+    *out = A;
+    return DEC128_STATUS_SUCCESS;
   }
 
-  decimal_status_t status = dec128_divide(A, B, &result, &remainder0);
-  DCHECK_EQ(status, DEC128_STATUS_SUCCESS);
-
-  int res_ndigits = (ret_scale + DEC_DIGITS - 1) / DEC_DIGITS;
-  res_ndigits = MAX(res_ndigits, 1);
-  int rscale = res_ndigits * DEC_DIGITS;
-
-  ret = dec128_increase_scale_by(result, rscale);
-
-  for (int i = 0; i < res_ndigits; i++) {
-    decimal128_t remainder = remainder0;
-    remainder = dec128_multiply(remainder, const_nbase);
-    status = dec128_divide(remainder, B, &result, &remainder0);
-    CHECKX(status == DEC128_STATUS_SUCCESS, "division failed");
-
-    decimal128_t q = dec128_multiply(
-        result,
-        dec128_get_scale_multiplier((res_ndigits - i - 1) * DEC_DIGITS));
-    ret = dec128_sum(ret, q);
+  // The result is A * 10^exponent / B rounded half up, with
+  // exponent = ret_scale - (Ascale - Bscale). Scale the dividend (or the
+  // divisor when the exponent is negative) and divide once, in 128 bits when
+  // the scaled operand fits and in 256 bits otherwise.
+  const int32_t exponent = ret_scale + Bscale - Ascale;
+  const int32_t abs_exponent = abs(exponent);
+  // work on the magnitudes so the sign is only looked at once
+  const bool negative = dec128_is_negative(A) != dec128_is_negative(B);
+  A = dec128_abs(A);
+  B = dec128_abs(B);
+  decimal128_t *scaled = exponent > 0 ? &A : &B;
+  decimal128_t result, remainder;
+  decimal_status_t status;
+  if (abs_exponent == 0 ||
+      (abs_exponent < DEC128_MAX_PRECISION &&
+       dec128_fits_in_precision(*scaled,
+                                DEC128_MAX_PRECISION - abs_exponent))) {
+    *scaled = dec128_increase_scale_by(*scaled, abs_exponent);
+    status = dec128_divide(A, B, &result, &remainder);
+    DCHECK_EQ(status, DEC128_STATUS_SUCCESS);
+    // round half up: remainder >= B - remainder, which cannot overflow
+    // unlike 2 * remainder >= B
+    if (dec128_cmpge(remainder, dec128_subtract(B, remainder))) {
+      result = dec128_sum(result, const_one);
+    }
+  } else {
+    decimal256_t dividend = dec256_from_dec128(A);
+    decimal256_t divisor = dec256_from_dec128(B);
+    if (exponent > 0) {
+      // |B| < 10^38, so a dividend of 10^76 or more gives a quotient above
+      // 10^38 anyway
+      if (exponent >= DEC256_MAX_PRECISION ||
+          !dec256_fits_in_precision(dividend,
+                                    DEC256_MAX_PRECISION - exponent)) {
+        return DEC128_STATUS_OVERFLOW;
+      }
+      dividend = dec256_increase_scale_by(dividend, exponent);
+    } else {
+      divisor = dec256_increase_scale_by(divisor, -exponent);
+    }
+    decimal256_t quotient, remainder256;
+    status = dec256_divide(dividend, divisor, &quotient, &remainder256);
+    DCHECK_EQ(status, DEC128_STATUS_SUCCESS);
+    if (dec256_cmpge(dec256_sum(remainder256, remainder256), divisor)) {
+      quotient = dec256_sum(quotient, dec256_from_int64(1));
+    }
+    if (dec256_to_dec128(quotient, &result) != DEC128_STATUS_SUCCESS) {
+      return DEC128_STATUS_OVERFLOW;
+    }
   }
 
-  if (rscale > ret_scale) {
-    ret = dec128_reduce_scale_by(ret, rscale - ret_scale, true);
-  } else if (rscale < ret_scale) {
-    ret = dec128_increase_scale_by(ret, ret_scale - rscale);
+  if (!dec128_fits_in_precision(result, ret_precision)) {
+    return DEC128_STATUS_OVERFLOW;
   }
-
-  CHECKX(dec128_fits_in_precision(ret, ret_precision),
-         "decimal not fit in precision");
-  return ret;
+  *out = negative ? dec128_negate(result) : result;
+  return DEC128_STATUS_SUCCESS;
 }
 
 decimal128_t dec128_floor(decimal128_t A, int scale) {
@@ -178,3 +191,62 @@ decimal128_t dec128_round(decimal128_t A, int32_t Ascale, int32_t rscale) {
   }
   return ret;
 }
+
+decimal_status_t dec128_mod_checked(decimal128_t A, int32_t Ascale,
+                                    decimal128_t B, int32_t Bscale,
+                                    decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+
+  if (dec128_cmpeq(B, const_zero)) {
+    return DEC128_STATUS_DIVIDEDBYZERO;
+  }
+  const int32_t delta = Ascale - Bscale;
+  if (abs(delta) > DEC128_MAX_SCALE) {
+    return DEC128_STATUS_ERROR;
+  }
+
+  decimal128_t scaled, quotient;
+  if (delta > 0 && dec128_multiply_checked(
+                       B, dec128_get_scale_multiplier(delta), &scaled)) {
+    // |B| * 10^delta is past 128 bits, so above |A|
+    *out = A;
+    return DEC128_STATUS_SUCCESS;
+  }
+  if (delta < 0 && dec128_multiply_checked(
+                       A, dec128_get_scale_multiplier(-delta), &scaled)) {
+    // the remainder is below |B|, only the dividend needs 256 bits
+    decimal256_t quotient256, remainder256;
+    decimal_status_t s = dec256_divide(
+        dec256_increase_scale_by(dec256_from_dec128(A), -delta),
+        dec256_from_dec128(B), &quotient256, &remainder256);
+    DCHECK_EQ(s, DEC128_STATUS_SUCCESS);
+    s = dec256_to_dec128(remainder256, out);
+    DCHECK_EQ(s, DEC128_STATUS_SUCCESS);
+    return s;
+  }
+  decimal_status_t s = dec128_divide(delta < 0 ? scaled : A,
+                                     delta > 0 ? scaled : B, &quotient, out);
+  DCHECK_EQ(s, DEC128_STATUS_SUCCESS);
+  return s;
+}
+
+decimal_status_t dec128_round_checked(decimal128_t A, int32_t Ascale,
+                                      int32_t rscale, decimal128_t *out) {
+  DCHECK_NE(out, NULL);
+
+  if (rscale < 0) {
+    return DEC128_STATUS_ERROR;
+  }
+  if (Ascale <= rscale) {
+    *out = A;
+    return DEC128_STATUS_SUCCESS;
+  }
+  const int32_t diff = Ascale - rscale;
+  if (diff > DEC128_MAX_SCALE) {
+    // half of 10^39 is above any 128-bit value
+    *out = const_zero;
+    return DEC128_STATUS_SUCCESS;
+  }
+  return dec128_multiply_checked(dec128_reduce_scale_by(A, diff, true),
+                                 dec128_get_scale_multiplier(diff), out);
+}
@@ -0,0 +1,1297 @@
+#include "decimal/wire_decimal.h"
+#include "decimal/bit_util.h"
+#include "decimal/decimal_internal.h"
+#include "decimal/logging.h"
+#include <string.h>
+
+static inline uint16_t LoadBigEndian16(const uint8_t *p) {
+  return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline void StoreBigEndian16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)(v >> 8);
+  p[1] = (uint8_t)v;
+}
+
+static inline __uint128_t DecimalMagnitude(decimal128_t v, bool *negative) {
+  *negative = dec128_high_bits(v) < 0;
+  const __uint128_t m = (__uint128_t)dec128_to_int128(v);
+  return *negative ? -m : m;
+}
+
+static inline decimal128_t DecimalFromMagnitude(__uint128_t m, bool negative) {
+  if (negative) {
+    m = -m;
+  }
+  return dec128_from_int128((__int128)m);
+}
+
+static inline void SetError(uint8_t *errors, size_t i) {
+  if (errors) {
+    errors[i / 8] |= (uint8_t)(1U << (i % 8));
+  }
+}
+
+static inline bool IsValid(const uint8_t *validity, size_t i) {
+  return !validity || ((validity[i / 8] >> (i % 8)) & 1);
+}
+
+/* PostgreSQL NUMERIC */
+#define kPgNumericHeaderSize 8
+#define kPgNumericBase 10000
+#define kPgNumericDigits 4
+#define kPgNumericPositive 0x0000
+#define kPgNumericNegative 0x4000
+#define kPgNumericDscaleMask 0x3FFF
+
+// A validated NUMERIC without leading or trailing zero digits and with the
+// digits hidden by dscale truncated away, as numeric_recv does. The last
+// digit is kept apart since truncation may change it.
+typedef struct PgNumeric {
+  const uint8_t *digits;
+  int32_t ndigits;
+  int32_t weight;
+  int32_t dscale;
+  uint16_t last;
+  bool negative;
+} PgNumeric;
+
+static bool ParsePgNumeric(const uint8_t *data, size_t length,
+                           PgNumeric *num) {
+  if (length < kPgNumericHeaderSize) {
+    return false;
+  }
+  int32_t ndigits = (int16_t)LoadBigEndian16(data);
+  const uint16_t sign = LoadBigEndian16(data + 4);
+  num->weight = (int16_t)LoadBigEndian16(data + 2);
+  num->dscale = LoadBigEndian16(data + 6);
+  if (ndigits < 0 ||
+      length != kPgNumericHeaderSize + 2 * (size_t)ndigits ||
+      (sign != kPgNumericPositive && sign != kPgNumericNegative) ||
+      (num->dscale & kPgNumericDscaleMask) != num->dscale) {
+    return false;
+  }
+  num->negative = sign == kPgNumericNegative;
+  num->digits = data + kPgNumericHeaderSize;
+
+  // digits entirely below dscale, then the hidden part of the last one
+  const int32_t max_digits =
+      num->weight + 1 + (num->dscale + kPgNumericDigits - 1) / kPgNumericDigits;
+  ndigits = MIN(ndigits, MAX(max_digits, 0));
+  num->last = 0;
+  if (ndigits > 0) {
+    num->last = LoadBigEndian16(num->digits + 2 * (ndigits - 1));
+    const int32_t hidden =
+        -kPgNumericDigits * (num->weight - ndigits + 1) - num->dscale;
+    if (hidden > 0) {
+      num->last -= num->last % kUInt64PowersOfTen[hidden];
+    }
+  }
+  while (ndigits > 0 && num->last == 0) {
+    ndigits--;
+    num->last = ndigits ? LoadBigEndian16(num->digits + 2 * (ndigits - 1)) : 0;
+  }
+  if (num->last >= kPgNumericBase) {
+    return false;
+  }
+  while (ndigits > 1 && LoadBigEndian16(num->digits) == 0) {
+    num->digits += 2;
+    ndigits--;
+    num->weight--;
+  }
+  num->ndigits = ndigits;
+  return true;
+}
+
+// The unscaled value of num at scale
+static decimal_status_t PgNumericToDecimal128(const PgNumeric *num,
+                                              int32_t precision, int32_t scale,
+                                              decimal128_t *out) {
+  if (num->ndigits == 0) {
+    *out = (decimal128_t){0};
+    return DEC128_STATUS_SUCCESS;
+  }
+  // power of ten of the last digit at scale
+  const int32_t k =
+      kPgNumericDigits * (num->weight - num->ndigits + 1) + scale;
+  if (k <= -kPgNumericDigits) {
+    return DEC128_STATUS_RESCALEDATALOSS;
+  }
+  __uint128_t m = 0;
+  for (int32_t i = 0; i < num->ndigits - 1; i++) {
+    const uint16_t digit = LoadBigEndian16(num->digits + 2 * i);
+    if (DEC128_PREDICT_FALSE(digit >= kPgNumericBase)) {
+      return DEC128_STATUS_ERROR;
+    }
+    // at least one more decimal shift follows
+    if (DEC128_PREDICT_FALSE(m >= UInt128PowerOfTen(DEC128_MAX_PRECISION -
+                                                    kPgNumericDigits - 1))) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+    m = m * kPgNumericBase + digit;
+  }
+
+  uint64_t last = num->last;
+  int32_t shift = kPgNumericDigits;
+  if (k < 0) {
+    if (last % kUInt64PowersOfTen[-k] != 0) {
+      return DEC128_STATUS_RESCALEDATALOSS;
+    }
+    last /= kUInt64PowersOfTen[-k];
+    shift += k;
+  }
+  if (m >= UInt128PowerOfTen(DEC128_MAX_PRECISION - shift)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  m = m * kUInt64PowersOfTen[shift] + last;
+  if (k > 0) {
+    if (k >= DEC128_MAX_PRECISION ||
+        m >= UInt128PowerOfTen(DEC128_MAX_PRECISION - k)) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+    m *= UInt128PowerOfTen(k);
+  }
+  if (m >= UInt128PowerOfTen(precision)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = DecimalFromMagnitude(m, num->negative);
+  return DEC128_STATUS_SUCCESS;
+}
+
+decimal_status_t dec128_from_pg_numeric(const uint8_t *data, size_t length,
+                                        decimal128_t *out, int32_t *precision,
+                                        int32_t *scale) {
+  PgNumeric num;
+  if (!ParsePgNumeric(data, length, &num)) {
+    return DEC128_STATUS_ERROR;
+  }
+  if (num.dscale > DEC128_MAX_SCALE) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  decimal_status_t status =
+      PgNumericToDecimal128(&num, DEC128_MAX_PRECISION, num.dscale, out);
+  if (status != DEC128_STATUS_SUCCESS) {
+    return status;
+  }
+  if (precision != NULL) {
+    int32_t whole_digits = 0;
+    if (num.ndigits > 0 && num.weight >= 0) {
+      const uint16_t first =
+          num.ndigits > 1 ? LoadBigEndian16(num.digits) : num.last;
+      whole_digits = kPgNumericDigits * num.weight + 1 + (first >= 10) +
+                     (first >= 100) + (first >= 1000);
+    }
+    *precision = whole_digits + num.dscale;
+  }
+  if (scale != NULL) {
+    *scale = num.dscale;
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+int32_t dec128_to_pg_numeric(decimal128_t v, int32_t scale, uint8_t *out) {
+  DCHECK_GE(scale, 0);
+  DCHECK_LE(scale, DEC128_MAX_SCALE);
+  bool negative;
+  const __uint128_t m = DecimalMagnitude(v, &negative);
+
+  // m * 10^pad has whole base 10000 digits after the decimal point, split it
+  // in three 16 digit chunks without overflowing 128 bits
+  const int32_t pad = (kPgNumericDigits - scale % kPgNumericDigits) %
+                      kPgNumericDigits;
+  __uint128_t remainder;
+  __uint128_t high = UInt128DivideByPowerOfTen(m, 16, &remainder);
+  const uint64_t low = (uint64_t)remainder * kUInt64PowersOfTen[pad];
+  high = high * kUInt64PowersOfTen[pad] + low / kUInt64PowersOfTen[16];
+  uint64_t chunks[3];
+  chunks[0] = low % kUInt64PowersOfTen[16];
+  chunks[2] = (uint64_t)UInt128DivideByPowerOfTen(high, 16, &remainder);
+  chunks[1] = (uint64_t)remainder;
+
+  uint16_t digits[12];
+  // least significant first, top and bottom are the nonzero ones
+  int32_t top = -1, bottom = -1;
+  for (int32_t i = 0; i < 12; i++) {
+    digits[i] = (uint16_t)(chunks[i / 4] % kPgNumericBase);
+    chunks[i / 4] /= kPgNumericBase;
+    if (digits[i] != 0) {
+      top = i;
+      bottom = bottom < 0 ? i : bottom;
+    }
+  }
+
+  int32_t ndigits = 0, weight = 0;
+  if (top >= 0) {
+    ndigits = top - bottom + 1;
+    weight = top - (scale + pad) / kPgNumericDigits;
+  }
+  StoreBigEndian16(out, (uint16_t)ndigits);
+  StoreBigEndian16(out + 2, (uint16_t)weight);
+  StoreBigEndian16(out + 4,
+                   negative ? kPgNumericNegative : kPgNumericPositive);
+  StoreBigEndian16(out + 6, (uint16_t)scale);
+  for (int32_t i = 0; i < ndigits; i++) {
+    StoreBigEndian16(out + kPgNumericHeaderSize + 2 * i, digits[top - i]);
+  }
+  return kPgNumericHeaderSize + 2 * ndigits;
+}
+
+size_t dec128_from_pg_numeric_batch(const int32_t *offsets,
+                                    const uint8_t *data,
+                                    const uint8_t *validity, size_t n,
+                                    int32_t precision, int32_t scale,
+                                    decimal128_t *out, uint8_t *errors) {
+  DCHECK_GT(precision, 0);
+  DCHECK_LE(precision, DEC128_MAX_PRECISION);
+  DCHECK_GE(scale, 0);
+  DCHECK_LE(scale, precision);
+
+  size_t nerrors = 0;
+  if (errors) {
+    memset(errors, 0, (n + 7) / 8);
+  }
+  for (size_t i = 0; i < n; i++) {
+    out[i] = (decimal128_t){0};
+    if (!IsValid(validity, i)) {
+      continue;
+    }
+    PgNumeric num;
+    if (DEC128_PREDICT_FALSE(
+            !ParsePgNumeric(data + offsets[i],
+                            (size_t)(offsets[i + 1] - offsets[i]), &num) ||
+            PgNumericToDecimal128(&num, precision, scale, &out[i]) !=
+                DEC128_STATUS_SUCCESS)) {
+      out[i] = (decimal128_t){0};
+      SetError(errors, i);
+      nerrors++;
+    }
+  }
+  return nerrors;
+}
+
+size_t dec128_to_pg_numeric_batch(const decimal128_t *values,
+                                  const uint8_t *validity, size_t n,
+                                  int32_t scale, int32_t *offsets,
+                                  uint8_t *data) {
+  size_t size = 0;
+  offsets[0] = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (IsValid(validity, i)) {
+      size += (size_t)dec128_to_pg_numeric(values[i], scale, data + size);
+    }
+    offsets[i + 1] = (int32_t)size;
+  }
+  return size;
+}
+
+/* MySQL binary DECIMAL */
+#define kMySqlWordDigits 9
+#define kMySqlWordBytes 4
+
+static const int32_t kMySqlDigitBytes[kMySqlWordDigits + 1] = {
+    0, 1, 1, 2, 2, 3, 3, 4, 4, 4};
+
+// Digits of DECIMAL(precision, scale): leftover whole digits, whole words,
+// fractional words, leftover fractional digits
+typedef struct MySqlLayout {
+  int32_t whole_digits;
+  int32_t words;
+  int32_t fraction_digits;
+  int32_t size;
+} MySqlLayout;
+
+static inline MySqlLayout GetMySqlLayout(int32_t precision, int32_t scale) {
+  DCHECK_GT(precision, 0);
+  DCHECK_LE(precision, DEC128_MAX_PRECISION);
+  DCHECK_GE(scale, 0);
+  DCHECK_LE(scale, precision);
+  const int32_t whole = precision - scale;
+  MySqlLayout layout;
+  layout.whole_digits = whole % kMySqlWordDigits;
+  layout.fraction_digits = scale % kMySqlWordDigits;
+  layout.words = whole / kMySqlWordDigits + scale / kMySqlWordDigits;
+  layout.size = kMySqlDigitBytes[layout.whole_digits] +
+                kMySqlWordBytes * layout.words +
+                kMySqlDigitBytes[layout.fraction_digits];
+  return layout;
+}
+
+// Load a big-endian group of length bytes, inverted by mask
+static inline uint32_t LoadMySqlGroup(const uint8_t *p, int32_t length,
+                                      uint32_t mask) {
+  uint32_t v = 0;
+  for (int32_t i = 0; i < length; i++) {
+    v = (v << 8) | p[i];
+  }
+  return (v ^ mask) & (uint32_t)(0xFFFFFFFFULL >> (32 - 8 * length));
+}
+
+static inline void StoreMySqlGroup(uint8_t *p, int32_t length, uint32_t v) {
+  for (int32_t i = length - 1; i >= 0; i--) {
+    p[i] = (uint8_t)v;
+    v >>= 8;
+  }
+}
+
+// m % 10^k, leaving m / 10^k in m
+static inline uint32_t DivideGroup(__uint128_t *m, int32_t k) {
+  if ((uint64_t)(*m >> 64) == 0) {
+    const uint64_t x = (uint64_t)*m;
+    *m = x / kUInt64PowersOfTen[k];
+    return (uint32_t)(x % kUInt64PowersOfTen[k]);
+  }
+  __uint128_t remainder;
+  *m = UInt128DivideByPowerOfTen(*m, k, &remainder);
+  return (uint32_t)remainder;
+}
+
+static decimal_status_t MySqlBinToDecimal128(const uint8_t *data,
+                                             const MySqlLayout *layout,
+                                             decimal128_t *out) {
+  const bool negative = !(data[0] & 0x80);
+  const uint32_t mask = negative ? 0xFFFFFFFF : 0;
+  uint8_t bytes[DEC128_MYSQL_BIN_MAX_SIZE];
+  memcpy(bytes, data, layout->size);
+  bytes[0] ^= 0x80;
+
+  const uint8_t *p = bytes;
+  int32_t length = kMySqlDigitBytes[layout->whole_digits];
+  uint32_t group = LoadMySqlGroup(p, length, mask);
+  if (group >= kUInt64PowersOfTen[layout->whole_digits]) {
+    return DEC128_STATUS_ERROR;
+  }
+  __uint128_t m = group;
+  p += length;
+  for (int32_t i = 0; i < layout->words; i++, p += kMySqlWordBytes) {
+    group = LoadMySqlGroup(p, kMySqlWordBytes, mask);
+    if (group >= kUInt64PowersOfTen[kMySqlWordDigits]) {
+      return DEC128_STATUS_ERROR;
+    }
+    m = m * kUInt64PowersOfTen[kMySqlWordDigits] + group;
+  }
+  length = kMySqlDigitBytes[layout->fraction_digits];
+  group = LoadMySqlGroup(p, length, mask);
+  if (group >= kUInt64PowersOfTen[layout->fraction_digits]) {
+    return DEC128_STATUS_ERROR;
+  }
+  m = m * kUInt64PowersOfTen[layout->fraction_digits] + group;
+  *out = DecimalFromMagnitude(m, negative);
+  return DEC128_STATUS_SUCCESS;
+}
+
+static void DecimalToMySqlBin(decimal128_t v, const MySqlLayout *layout,
+                              uint8_t *out) {
+  bool negative;
+  __uint128_t m = DecimalMagnitude(v, &negative);
+  const uint32_t mask = negative ? 0xFFFFFFFF : 0;
+  // from the least significant group
+  uint8_t *p = out + layout->size;
+  int32_t length = kMySqlDigitBytes[layout->fraction_digits];
+  p -= length;
+  StoreMySqlGroup(p, length, DivideGroup(&m, layout->fraction_digits) ^ mask);
+  for (int32_t i = 0; i < layout->words; i++) {
+    p -= kMySqlWordBytes;
+    StoreMySqlGroup(p, kMySqlWordBytes,
+                    DivideGroup(&m, kMySqlWordDigits) ^ mask);
+  }
+  StoreMySqlGroup(out, kMySqlDigitBytes[layout->whole_digits],
+                  (uint32_t)m ^ mask);
+  out[0] ^= 0x80;
+}
+
+static inline bool FitsPrecision(decimal128_t v, int32_t precision) {
+  bool negative;
+  return DecimalMagnitude(v, &negative) < UInt128PowerOfTen(precision);
+}
+
+int32_t dec128_mysql_bin_size(int32_t precision, int32_t scale) {
+  return GetMySqlLayout(precision, scale).size;
+}
+
+decimal_status_t dec128_from_mysql_bin(const uint8_t *data, int32_t precision,
+                                       int32_t scale, decimal128_t *out) {
+  const MySqlLayout layout = GetMySqlLayout(precision, scale);
+  return MySqlBinToDecimal128(data, &layout, out);
+}
+
+decimal_status_t dec128_to_mysql_bin(decimal128_t v, int32_t precision,
+                                     int32_t scale, uint8_t *out) {
+  const MySqlLayout layout = GetMySqlLayout(precision, scale);
+  if (!FitsPrecision(v, precision)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  DecimalToMySqlBin(v, &layout, out);
+  return DEC128_STATUS_SUCCESS;
+}
+
+size_t dec128_from_mysql_bin_batch(const uint8_t *data, size_t n,
+                                   int32_t precision, int32_t scale,
+                                   decimal128_t *out, uint8_t *errors) {
+  const MySqlLayout layout = GetMySqlLayout(precision, scale);
+  size_t nerrors = 0;
+  if (errors) {
+    memset(errors, 0, (n + 7) / 8);
+  }
+  for (size_t i = 0; i < n; i++, data += layout.size) {
+    if (DEC128_PREDICT_FALSE(MySqlBinToDecimal128(data, &layout, &out[i]) !=
+                             DEC128_STATUS_SUCCESS)) {
+      out[i] = (decimal128_t){0};
+      SetError(errors, i);
+      nerrors++;
+    }
+  }
+  return nerrors;
+}
+
+decimal_status_t dec128_to_mysql_bin_batch(const decimal128_t *values,
+                                           size_t n, int32_t precision,
+                                           int32_t scale, uint8_t *data) {
+  const MySqlLayout layout = GetMySqlLayout(precision, scale);
+  for (size_t i = 0; i < n; i++) {
+    if (DEC128_PREDICT_FALSE(!FitsPrecision(values[i], precision))) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+  }
+  for (size_t i = 0; i < n; i++, data += layout.size) {
+    DecimalToMySqlBin(values[i], &layout, data);
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* IBM packed and zoned decimal */
+#define kBcdHighNibbles 0x8888888888888888ULL
+
+static inline uint64_t LoadBigEndian64(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+#if DEC128_LITTLE_ENDIAN
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+// 1 to 8 big-endian bytes in the low bytes of a word, loading 8 bytes at
+// once while they stay before limit
+static inline uint64_t LoadBigEndianPartial(const uint8_t *p, int32_t length,
+                                            const uint8_t *limit) {
+  if (DEC128_PREDICT_TRUE(limit - p >= 8)) {
+    return LoadBigEndian64(p) >> (64 - 8 * length);
+  }
+  uint8_t buffer[8] = {0};
+  memcpy(buffer + 8 - length, p, length);
+  return LoadBigEndian64(buffer);
+}
+
+static inline void StoreBigEndian64(uint8_t *p, uint64_t v) {
+#if DEC128_LITTLE_ENDIAN
+  v = __builtin_bswap64(v);
+#endif
+  memcpy(p, &v, sizeof(v));
+}
+
+// Nonzero if one of the 16 nibbles is above 9
+static inline uint64_t BadBcdNibbles(uint64_t x) {
+  return x & ((x << 1) | (x << 2)) & kBcdHighNibbles;
+}
+
+// SWAR conversion of 16 BCD digits, the most significant in the top nibble:
+// merge pairs of 2, 4 and 8 digits by subtracting the excess of their
+// binary weight over the decimal one
+static inline uint64_t BcdToBinary(uint64_t x) {
+  x -= 6 * ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL);
+  x -= 156 * ((x >> 8) & 0x00FF00FF00FF00FFULL);
+  x -= 55536 * ((x >> 16) & 0x0000FFFF0000FFFFULL);
+  x -= 4194967296ULL * (x >> 32);
+  return x;
+}
+
+// SWAR conversion of 8 digits stored one per byte, the most significant in
+// the top byte
+static inline uint64_t DigitBytesToBinary(uint64_t x) {
+  x = ((x >> 8) & 0x00FF00FF00FF00FFULL) * 10 + (x & 0x00FF00FF00FF00FFULL);
+  x = ((x >> 16) & 0x0000FFFF0000FFFFULL) * 100 +
+      (x & 0x0000FFFF0000FFFFULL);
+  return (x >> 32) * 10000 + (x & 0xFFFFFFFFULL);
+}
+
+// SWAR conversion of v < 10^8 to 8 BCD digits: split in two 32-bit lanes
+// below 10^4, four 16-bit lanes below 100, then turn n into n + 6 * (n / 10)
+static inline uint32_t EightDigitsToBcd(uint32_t v) {
+  uint64_t x = ((uint64_t)(v / 10000) << 32) | (v % 10000);
+  uint64_t q = ((x * 5243) >> 19) & 0x0000007F0000007FULL;
+  x = (x - 100 * q) | (q << 16);
+  q = ((x * 103) >> 10) & 0x000F000F000F000FULL;
+  x += 6 * q;
+  x = (x | (x >> 8)) & 0x0000FFFF0000FFFFULL;
+  return (uint32_t)(x | (x >> 16));
+}
+
+static inline uint64_t SixteenDigitsToBcd(uint64_t v) {
+  return ((uint64_t)EightDigitsToBcd((uint32_t)(v / 100000000)) << 32) |
+         EightDigitsToBcd((uint32_t)(v % 100000000));
+}
+
+// One BCD digit per byte, the most significant in the top byte
+static inline uint64_t SpreadBcd(uint32_t bcd) {
+  uint64_t x = bcd;
+  x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+  x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+  return (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+}
+
+// Split m < 10^38 in 16 digit chunks, the most significant first
+static inline void SplitSixteenDigits(__uint128_t m, uint64_t chunks[3]) {
+  if ((uint64_t)(m >> 64) == 0) {
+    chunks[0] = 0;
+    chunks[1] = (uint64_t)m / 10000000000000000ULL;
+    chunks[2] = (uint64_t)m % 10000000000000000ULL;
+    return;
+  }
+  __uint128_t remainder;
+  m = UInt128DivideByPowerOfTen(m, 16, &remainder);
+  chunks[2] = (uint64_t)remainder;
+  chunks[0] = (uint64_t)UInt128DivideByPowerOfTen(m, 16, &remainder);
+  chunks[1] = (uint64_t)remainder;
+}
+
+static inline bool IsValidSign(uint8_t sign) { return sign >= 0xA; }
+
+static inline bool IsNegativeSign(uint8_t sign) {
+  return sign == 0xB || sign == 0xD;
+}
+
+// limit is the end of the readable data
+static bool PackedToDecimal128(const uint8_t *p, int32_t length,
+                               const uint8_t *limit, decimal128_t *out) {
+  const uint8_t last = p[length - 1];
+  const uint8_t *end = p + length - 1;
+  // the digit bytes before the last one, leftover first
+  __uint128_t m = 0;
+  uint64_t bad = (last >> 4) > 9 || !IsValidSign(last & 0x0F);
+  const int32_t leftover = (length - 1) % 8;
+  if (leftover) {
+    const uint64_t x = LoadBigEndianPartial(p, leftover, limit);
+    bad |= BadBcdNibbles(x);
+    m = BcdToBinary(x);
+    p += leftover;
+  }
+  for (; p < end; p += 8) {
+    const uint64_t x = LoadBigEndian64(p);
+    bad |= BadBcdNibbles(x);
+    m = m * 10000000000000000ULL + BcdToBinary(x);
+  }
+  if (DEC128_PREDICT_FALSE(bad ||
+                           m >= UInt128PowerOfTen(DEC128_MAX_PRECISION - 1))) {
+    return false;
+  }
+  m = m * 10 + (last >> 4);
+  *out = DecimalFromMagnitude(m, IsNegativeSign(last & 0x0F));
+  return true;
+}
+
+static void DecimalToPacked(decimal128_t v, int32_t length, uint8_t *out) {
+  bool negative;
+  const __uint128_t m = DecimalMagnitude(v, &negative);
+  // the last digit shares its byte with the sign
+  __uint128_t high, remainder;
+  if ((uint64_t)(m >> 64) == 0) {
+    high = (uint64_t)m / 10;
+    remainder = (uint64_t)m % 10;
+  } else {
+    high = UInt128DivideByPowerOfTen(m, 1, &remainder);
+  }
+  uint64_t chunks[3];
+  SplitSixteenDigits(high, chunks);
+  uint8_t bcd[24];
+  for (int32_t i = 0; i < 3; i++) {
+    StoreBigEndian64(bcd + 8 * i, SixteenDigitsToBcd(chunks[i]));
+  }
+  memcpy(out, bcd + 24 - (length - 1), length - 1);
+  out[length - 1] = (uint8_t)(remainder << 4) | (negative ? 0xD : 0xC);
+}
+
+static bool ZonedToDecimal128(const uint8_t *p, int32_t length,
+                              const uint8_t *limit, decimal128_t *out) {
+  const uint8_t sign = p[length - 1] >> 4;
+  const uint8_t *end = p + length;
+  __uint128_t m = 0;
+  uint64_t bad = !IsValidSign(sign);
+  int32_t chunk = length % 8 ? length % 8 : 8;
+  for (; p < end; p += chunk, chunk = 8) {
+    uint64_t x = LoadBigEndianPartial(p, chunk, limit);
+    if (chunk < 8) {
+      x |= 0xF0F0F0F0F0F0F0F0ULL << (8 * chunk);
+    }
+    if (p + chunk == end) {
+      x |= 0xF0;
+    }
+    // 0xF zones, digits without a carry when adding 6
+    bad |= (x & 0xF0F0F0F0F0F0F0F0ULL) ^ 0xF0F0F0F0F0F0F0F0ULL;
+    x &= 0x0F0F0F0F0F0F0F0FULL;
+    bad |= (x + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL;
+    if (DEC128_PREDICT_FALSE(m >= UInt128PowerOfTen(DEC128_MAX_PRECISION -
+                                                    8))) {
+      return false;
+    }
+    m = m * 100000000 + DigitBytesToBinary(x);
+  }
+  if (DEC128_PREDICT_FALSE(bad)) {
+    return false;
+  }
+  *out = DecimalFromMagnitude(m, IsNegativeSign(sign));
+  return true;
+}
+
+static void DecimalToZoned(decimal128_t v, int32_t length, uint8_t *out) {
+  bool negative;
+  uint64_t chunks[3];
+  SplitSixteenDigits(DecimalMagnitude(v, &negative), chunks);
+  uint8_t zoned[48];
+  for (int32_t i = 0; i < 3; i++) {
+    const uint64_t bcd = SixteenDigitsToBcd(chunks[i]);
+    StoreBigEndian64(zoned + 16 * i,
+                     SpreadBcd((uint32_t)(bcd >> 32)) | 0xF0F0F0F0F0F0F0F0ULL);
+    StoreBigEndian64(zoned + 16 * i + 8,
+                     SpreadBcd((uint32_t)bcd) | 0xF0F0F0F0F0F0F0F0ULL);
+  }
+  memcpy(out, zoned + 48 - length, length);
+  out[length - 1] = (out[length - 1] & 0x0F) | (negative ? 0xD0 : 0xC0);
+}
+
+// Fail with DEC128_STATUS_OVERFLOW before writing anything if a value has
+// more than digits digits, every decimal128_t fits 39
+static decimal_status_t CheckDigits(const decimal128_t *values, size_t n,
+                                    int32_t digits) {
+  if (digits > DEC128_MAX_PRECISION) {
+    return DEC128_STATUS_SUCCESS;
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (DEC128_PREDICT_FALSE(!FitsPrecision(values[i], digits))) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+size_t dec128_from_packed_batch(const uint8_t *data, int32_t byte_length,
+                                size_t n, decimal128_t *out, uint8_t *errors) {
+  DCHECK_GT(byte_length, 0);
+  DCHECK_LE(byte_length, DEC128_PACKED_MAX_LENGTH);
+  size_t nerrors = 0;
+  if (errors) {
+    memset(errors, 0, (n + 7) / 8);
+  }
+  const uint8_t *limit = data + n * byte_length;
+  for (size_t i = 0; i < n; i++, data += byte_length) {
+    if (DEC128_PREDICT_FALSE(
+            !PackedToDecimal128(data, byte_length, limit, &out[i]))) {
+      out[i] = (decimal128_t){0};
+      SetError(errors, i);
+      nerrors++;
+    }
+  }
+  return nerrors;
+}
+
+decimal_status_t dec128_to_packed_batch(const decimal128_t *values, size_t n,
+                                        int32_t byte_length, uint8_t *data) {
+  DCHECK_GT(byte_length, 0);
+  DCHECK_LE(byte_length, DEC128_PACKED_MAX_LENGTH);
+  decimal_status_t status = CheckDigits(values, n, 2 * byte_length - 1);
+  if (status != DEC128_STATUS_SUCCESS) {
+    return status;
+  }
+  for (size_t i = 0; i < n; i++, data += byte_length) {
+    DecimalToPacked(values[i], byte_length, data);
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+size_t dec128_from_zoned_batch(const uint8_t *data, int32_t byte_length,
+                               size_t n, decimal128_t *out, uint8_t *errors) {
+  DCHECK_GT(byte_length, 0);
+  DCHECK_LE(byte_length, DEC128_ZONED_MAX_LENGTH);
+  size_t nerrors = 0;
+  if (errors) {
+    memset(errors, 0, (n + 7) / 8);
+  }
+  const uint8_t *limit = data + n * byte_length;
+  for (size_t i = 0; i < n; i++, data += byte_length) {
+    if (DEC128_PREDICT_FALSE(
+            !ZonedToDecimal128(data, byte_length, limit, &out[i]))) {
+      out[i] = (decimal128_t){0};
+      SetError(errors, i);
+      nerrors++;
+    }
+  }
+  return nerrors;
+}
+
+decimal_status_t dec128_to_zoned_batch(const decimal128_t *values, size_t n,
+                                       int32_t byte_length, uint8_t *data) {
+  DCHECK_GT(byte_length, 0);
+  DCHECK_LE(byte_length, DEC128_ZONED_MAX_LENGTH);
+  decimal_status_t status = CheckDigits(values, n, byte_length);
+  if (status != DEC128_STATUS_SUCCESS) {
+    return status;
+  }
+  for (size_t i = 0; i < n; i++, data += byte_length) {
+    DecimalToZoned(values[i], byte_length, data);
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* IEEE 754 decimal128 */
+// 10 bit declets to their 3 digits, non-canonical declets included
+static const uint16_t kDpdToBinary[1024] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 80, 81, 800, 801, 880, 881, 10, 11, 12, 13,
+    14, 15, 16, 17, 18, 19, 90, 91, 810, 811, 890, 891, 20, 21, 22, 23, 24, 25,
+    26, 27, 28, 29, 82, 83, 820, 821, 808, 809, 30, 31, 32, 33, 34, 35, 36, 37,
+    38, 39, 92, 93, 830, 831, 818, 819, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49,
+    84, 85, 840, 841, 88, 89, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 94, 95,
+    850, 851, 98, 99, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 86, 87, 860, 861,
+    888, 889, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 96, 97, 870, 871, 898,
+    899, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 180, 181, 900, 901,
+    980, 981, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 190, 191, 910,
+    911, 990, 991, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 182, 183,
+    920, 921, 908, 909, 130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 192,
+    193, 930, 931, 918, 919, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149,
+    184, 185, 940, 941, 188, 189, 150, 151, 152, 153, 154, 155, 156, 157, 158,
+    159, 194, 195, 950, 951, 198, 199, 160, 161, 162, 163, 164, 165, 166, 167,
+    168, 169, 186, 187, 960, 961, 988, 989, 170, 171, 172, 173, 174, 175, 176,
+    177, 178, 179, 196, 197, 970, 971, 998, 999, 200, 201, 202, 203, 204, 205,
+    206, 207, 208, 209, 280, 281, 802, 803, 882, 883, 210, 211, 212, 213, 214,
+    215, 216, 217, 218, 219, 290, 291, 812, 813, 892, 893, 220, 221, 222, 223,
+    224, 225, 226, 227, 228, 229, 282, 283, 822, 823, 828, 829, 230, 231, 232,
+    233, 234, 235, 236, 237, 238, 239, 292, 293, 832, 833, 838, 839, 240, 241,
+    242, 243, 244, 245, 246, 247, 248, 249, 284, 285, 842, 843, 288, 289, 250,
+    251, 252, 253, 254, 255, 256, 257, 258, 259, 294, 295, 852, 853, 298, 299,
+    260, 261, 262, 263, 264, 265, 266, 267, 268, 269, 286, 287, 862, 863, 888,
+    889, 270, 271, 272, 273, 274, 275, 276, 277, 278, 279, 296, 297, 872, 873,
+    898, 899, 300, 301, 302, 303, 304, 305, 306, 307, 308, 309, 380, 381, 902,
+    903, 982, 983, 310, 311, 312, 313, 314, 315, 316, 317, 318, 319, 390, 391,
+    912, 913, 992, 993, 320, 321, 322, 323, 324, 325, 326, 327, 328, 329, 382,
+    383, 922, 923, 928, 929, 330, 331, 332, 333, 334, 335, 336, 337, 338, 339,
+    392, 393, 932, 933, 938, 939, 340, 341, 342, 343, 344, 345, 346, 347, 348,
+    349, 384, 385, 942, 943, 388, 389, 350, 351, 352, 353, 354, 355, 356, 357,
+    358, 359, 394, 395, 952, 953, 398, 399, 360, 361, 362, 363, 364, 365, 366,
+    367, 368, 369, 386, 387, 962, 963, 988, 989, 370, 371, 372, 373, 374, 375,
+    376, 377, 378, 379, 396, 397, 972, 973, 998, 999, 400, 401, 402, 403, 404,
+    405, 406, 407, 408, 409, 480, 481, 804, 805, 884, 885, 410, 411, 412, 413,
+    414, 415, 416, 417, 418, 419, 490, 491, 814, 815, 894, 895, 420, 421, 422,
+    423, 424, 425, 426, 427, 428, 429, 482, 483, 824, 825, 848, 849, 430, 431,
+    432, 433, 434, 435, 436, 437, 438, 439, 492, 493, 834, 835, 858, 859, 440,
+    441, 442, 443, 444, 445, 446, 447, 448, 449, 484, 485, 844, 845, 488, 489,
+    450, 451, 452, 453, 454, 455, 456, 457, 458, 459, 494, 495, 854, 855, 498,
+    499, 460, 461, 462, 463, 464, 465, 466, 467, 468, 469, 486, 487, 864, 865,
+    888, 889, 470, 471, 472, 473, 474, 475, 476, 477, 478, 479, 496, 497, 874,
+    875, 898, 899, 500, 501, 502, 503, 504, 505, 506, 507, 508, 509, 580, 581,
+    904, 905, 984, 985, 510, 511, 512, 513, 514, 515, 516, 517, 518, 519, 590,
+    591, 914, 915, 994, 995, 520, 521, 522, 523, 524, 525, 526, 527, 528, 529,
+    582, 583, 924, 925, 948, 949, 530, 531, 532, 533, 534, 535, 536, 537, 538,
+    539, 592, 593, 934, 935, 958, 959, 540, 541, 542, 543, 544, 545, 546, 547,
+    548, 549, 584, 585, 944, 945, 588, 589, 550, 551, 552, 553, 554, 555, 556,
+    557, 558, 559, 594, 595, 954, 955, 598, 599, 560, 561, 562, 563, 564, 565,
+    566, 567, 568, 569, 586, 587, 964, 965, 988, 989, 570, 571, 572, 573, 574,
+    575, 576, 577, 578, 579, 596, 597, 974, 975, 998, 999, 600, 601, 602, 603,
+    604, 605, 606, 607, 608, 609, 680, 681, 806, 807, 886, 887, 610, 611, 612,
+    613, 614, 615, 616, 617, 618, 619, 690, 691, 816, 817, 896, 897, 620, 621,
+    622, 623, 624, 625, 626, 627, 628, 629, 682, 683, 826, 827, 868, 869, 630,
+    631, 632, 633, 634, 635, 636, 637, 638, 639, 692, 693, 836, 837, 878, 879,
+    640, 641, 642, 643, 644, 645, 646, 647, 648, 649, 684, 685, 846, 847, 688,
+    689, 650, 651, 652, 653, 654, 655, 656, 657, 658, 659, 694, 695, 856, 857,
+    698, 699, 660, 661, 662, 663, 664, 665, 666, 667, 668, 669, 686, 687, 866,
+    867, 888, 889, 670, 671, 672, 673, 674, 675, 676, 677, 678, 679, 696, 697,
+    876, 877, 898, 899, 700, 701, 702, 703, 704, 705, 706, 707, 708, 709, 780,
+    781, 906, 907, 986, 987, 710, 711, 712, 713, 714, 715, 716, 717, 718, 719,
+    790, 791, 916, 917, 996, 997, 720, 721, 722, 723, 724, 725, 726, 727, 728,
+    729, 782, 783, 926, 927, 968, 969, 730, 731, 732, 733, 734, 735, 736, 737,
+    738, 739, 792, 793, 936, 937, 978, 979, 740, 741, 742, 743, 744, 745, 746,
+    747, 748, 749, 784, 785, 946, 947, 788, 789, 750, 751, 752, 753, 754, 755,
+    756, 757, 758, 759, 794, 795, 956, 957, 798, 799, 760, 761, 762, 763, 764,
+    765, 766, 767, 768, 769, 786, 787, 966, 967, 988, 989, 770, 771, 772, 773,
+    774, 775, 776, 777, 778, 779, 796, 797, 976, 977, 998, 999,};
+
+// 3 digits to their canonical declet
+static const uint16_t kBinaryToDpd[1000] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 32,
+    33, 34, 35, 36, 37, 38, 39, 40, 41, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57,
+    64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 80, 81, 82, 83, 84, 85, 86, 87, 88,
+    89, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 112, 113, 114, 115, 116,
+    117, 118, 119, 120, 121, 10, 11, 42, 43, 74, 75, 106, 107, 78, 79, 26, 27,
+    58, 59, 90, 91, 122, 123, 94, 95, 128, 129, 130, 131, 132, 133, 134, 135,
+    136, 137, 144, 145, 146, 147, 148, 149, 150, 151, 152, 153, 160, 161, 162,
+    163, 164, 165, 166, 167, 168, 169, 176, 177, 178, 179, 180, 181, 182, 183,
+    184, 185, 192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 208, 209, 210,
+    211, 212, 213, 214, 215, 216, 217, 224, 225, 226, 227, 228, 229, 230, 231,
+    232, 233, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249, 138, 139, 170,
+    171, 202, 203, 234, 235, 206, 207, 154, 155, 186, 187, 218, 219, 250, 251,
+    222, 223, 256, 257, 258, 259, 260, 261, 262, 263, 264, 265, 272, 273, 274,
+    275, 276, 277, 278, 279, 280, 281, 288, 289, 290, 291, 292, 293, 294, 295,
+    296, 297, 304, 305, 306, 307, 308, 309, 310, 311, 312, 313, 320, 321, 322,
+    323, 324, 325, 326, 327, 328, 329, 336, 337, 338, 339, 340, 341, 342, 343,
+    344, 345, 352, 353, 354, 355, 356, 357, 358, 359, 360, 361, 368, 369, 370,
+    371, 372, 373, 374, 375, 376, 377, 266, 267, 298, 299, 330, 331, 362, 363,
+    334, 335, 282, 283, 314, 315, 346, 347, 378, 379, 350, 351, 384, 385, 386,
+    387, 388, 389, 390, 391, 392, 393, 400, 401, 402, 403, 404, 405, 406, 407,
+    408, 409, 416, 417, 418, 419, 420, 421, 422, 423, 424, 425, 432, 433, 434,
+    435, 436, 437, 438, 439, 440, 441, 448, 449, 450, 451, 452, 453, 454, 455,
+    456, 457, 464, 465, 466, 467, 468, 469, 470, 471, 472, 473, 480, 481, 482,
+    483, 484, 485, 486, 487, 488, 489, 496, 497, 498, 499, 500, 501, 502, 503,
+    504, 505, 394, 395, 426, 427, 458, 459, 490, 491, 462, 463, 410, 411, 442,
+    443, 474, 475, 506, 507, 478, 479, 512, 513, 514, 515, 516, 517, 518, 519,
+    520, 521, 528, 529, 530, 531, 532, 533, 534, 535, 536, 537, 544, 545, 546,
+    547, 548, 549, 550, 551, 552, 553, 560, 561, 562, 563, 564, 565, 566, 567,
+    568, 569, 576, 577, 578, 579, 580, 581, 582, 583, 584, 585, 592, 593, 594,
+    595, 596, 597, 598, 599, 600, 601, 608, 609, 610, 611, 612, 613, 614, 615,
+    616, 617, 624, 625, 626, 627, 628, 629, 630, 631, 632, 633, 522, 523, 554,
+    555, 586, 587, 618, 619, 590, 591, 538, 539, 570, 571, 602, 603, 634, 635,
+    606, 607, 640, 641, 642, 643, 644, 645, 646, 647, 648, 649, 656, 657, 658,
+    659, 660, 661, 662, 663, 664, 665, 672, 673, 674, 675, 676, 677, 678, 679,
+    680, 681, 688, 689, 690, 691, 692, 693, 694, 695, 696, 697, 704, 705, 706,
+    707, 708, 709, 710, 711, 712, 713, 720, 721, 722, 723, 724, 725, 726, 727,
+    728, 729, 736, 737, 738, 739, 740, 741, 742, 743, 744, 745, 752, 753, 754,
+    755, 756, 757, 758, 759, 760, 761, 650, 651, 682, 683, 714, 715, 746, 747,
+    718, 719, 666, 667, 698, 699, 730, 731, 762, 763, 734, 735, 768, 769, 770,
+    771, 772, 773, 774, 775, 776, 777, 784, 785, 786, 787, 788, 789, 790, 791,
+    792, 793, 800, 801, 802, 803, 804, 805, 806, 807, 808, 809, 816, 817, 818,
+    819, 820, 821, 822, 823, 824, 825, 832, 833, 834, 835, 836, 837, 838, 839,
+    840, 841, 848, 849, 850, 851, 852, 853, 854, 855, 856, 857, 864, 865, 866,
+    867, 868, 869, 870, 871, 872, 873, 880, 881, 882, 883, 884, 885, 886, 887,
+    888, 889, 778, 779, 810, 811, 842, 843, 874, 875, 846, 847, 794, 795, 826,
+    827, 858, 859, 890, 891, 862, 863, 896, 897, 898, 899, 900, 901, 902, 903,
+    904, 905, 912, 913, 914, 915, 916, 917, 918, 919, 920, 921, 928, 929, 930,
+    931, 932, 933, 934, 935, 936, 937, 944, 945, 946, 947, 948, 949, 950, 951,
+    952, 953, 960, 961, 962, 963, 964, 965, 966, 967, 968, 969, 976, 977, 978,
+    979, 980, 981, 982, 983, 984, 985, 992, 993, 994, 995, 996, 997, 998, 999,
+    1000, 1001, 1008, 1009, 1010, 1011, 1012, 1013, 1014, 1015, 1016, 1017, 906,
+    907, 938, 939, 970, 971, 1002, 1003, 974, 975, 922, 923, 954, 955, 986, 987,
+    1018, 1019, 990, 991, 12, 13, 268, 269, 524, 525, 780, 781, 46, 47, 28, 29,
+    284, 285, 540, 541, 796, 797, 62, 63, 44, 45, 300, 301, 556, 557, 812, 813,
+    302, 303, 60, 61, 316, 317, 572, 573, 828, 829, 318, 319, 76, 77, 332, 333,
+    588, 589, 844, 845, 558, 559, 92, 93, 348, 349, 604, 605, 860, 861, 574,
+    575, 108, 109, 364, 365, 620, 621, 876, 877, 814, 815, 124, 125, 380, 381,
+    636, 637, 892, 893, 830, 831, 14, 15, 270, 271, 526, 527, 782, 783, 110,
+    111, 30, 31, 286, 287, 542, 543, 798, 799, 126, 127, 140, 141, 396, 397,
+    652, 653, 908, 909, 174, 175, 156, 157, 412, 413, 668, 669, 924, 925, 190,
+    191, 172, 173, 428, 429, 684, 685, 940, 941, 430, 431, 188, 189, 444, 445,
+    700, 701, 956, 957, 446, 447, 204, 205, 460, 461, 716, 717, 972, 973, 686,
+    687, 220, 221, 476, 477, 732, 733, 988, 989, 702, 703, 236, 237, 492, 493,
+    748, 749, 1004, 1005, 942, 943, 252, 253, 508, 509, 764, 765, 1020, 1021,
+    958, 959, 142, 143, 398, 399, 654, 655, 910, 911, 238, 239, 158, 159, 414,
+    415, 670, 671, 926, 927, 254, 255,};
+
+#define kIeeeBias 6176
+#define kIeeeMaxBiasedExponent 12287
+#define kIeeeDigits 34
+#define kIeeeSpecial 0x1E // 11110 infinity, 11111 NaN
+
+static inline __uint128_t IeeeBits(ieee_decimal128_t x) {
+#if DEC128_LITTLE_ENDIAN
+  return ((__uint128_t)x.array[1] << 64) | x.array[0];
+#else
+  return ((__uint128_t)x.array[0] << 64) | x.array[1];
+#endif
+}
+
+static inline ieee_decimal128_t IeeeFromBits(__uint128_t bits) {
+  ieee_decimal128_t x;
+#if DEC128_LITTLE_ENDIAN
+  x.array[0] = (uint64_t)bits;
+  x.array[1] = (uint64_t)(bits >> 64);
+#else
+  x.array[0] = (uint64_t)(bits >> 64);
+  x.array[1] = (uint64_t)bits;
+#endif
+  return x;
+}
+
+// Coefficient of 11 declets in the low 110 bits and a leading digit
+static inline __uint128_t DpdToBinary(__uint128_t bits, uint32_t leading) {
+  // 6 declets below 10^18, 5 declets and the leading digit below 10^16
+  uint64_t low = 0, high = leading;
+  for (int32_t i = 10; i >= 6; i--) {
+    high = high * 1000 + kDpdToBinary[(uint32_t)(bits >> (10 * i)) & 0x3FF];
+  }
+  for (int32_t i = 5; i >= 0; i--) {
+    low = low * 1000 + kDpdToBinary[(uint32_t)(bits >> (10 * i)) & 0x3FF];
+  }
+  return (__uint128_t)high * 1000000000000000000ULL + low;
+}
+
+// The 11 declets of c < 10^34 and its leading digit
+static inline __uint128_t BinaryToDpd(__uint128_t c, uint32_t *leading) {
+  __uint128_t remainder;
+  uint64_t high = (uint64_t)UInt128DivideByPowerOfTen(c, 18, &remainder);
+  uint64_t low = (uint64_t)remainder;
+  __uint128_t bits = 0;
+  for (int32_t i = 0; i < 6; i++, low /= 1000) {
+    bits |= (__uint128_t)kBinaryToDpd[low % 1000] << (10 * i);
+  }
+  for (int32_t i = 6; i < 11; i++, high /= 1000) {
+    bits |= (__uint128_t)kBinaryToDpd[high % 1000] << (10 * i);
+  }
+  *leading = (uint32_t)high;
+  return bits;
+}
+
+// Sign, coefficient and biased exponent, false for NaN and infinities
+static inline bool DecodeIeee(ieee_decimal128_t x,
+                              dec128_ieee_encoding_t encoding, bool *negative,
+                              __uint128_t *coefficient, int32_t *exponent) {
+  const __uint128_t bits = IeeeBits(x);
+  const uint64_t high = (uint64_t)(bits >> 64);
+  const uint32_t combination = (uint32_t)(high >> 58) & 0x1F;
+  *negative = high >> 63;
+  if (DEC128_PREDICT_FALSE((combination & kIeeeSpecial) == kIeeeSpecial)) {
+    return false;
+  }
+  if (encoding == DEC128_IEEE_BID) {
+    if (DEC128_PREDICT_TRUE((combination >> 3) != 3)) {
+      *exponent = (int32_t)(high >> 49) & 0x3FFF;
+      *coefficient = bits & ((((__uint128_t)1) << 113) - 1);
+      if (*coefficient >= UInt128PowerOfTen(kIeeeDigits)) {
+        *coefficient = 0;
+      }
+    } else {
+      // the coefficient would be 2^113 or more, non-canonical
+      *exponent = (int32_t)(high >> 47) & 0x3FFF;
+      *coefficient = 0;
+    }
+  } else {
+    const uint32_t continuation = (uint32_t)(high >> 46) & 0xFFF;
+    uint32_t leading;
+    if ((combination >> 3) != 3) {
+      *exponent = (int32_t)(((combination >> 3) << 12) | continuation);
+      leading = combination & 0x7;
+    } else {
+      *exponent = (int32_t)((((combination >> 1) & 0x3) << 12) | continuation);
+      leading = 8 + (combination & 0x1);
+    }
+    *coefficient = DpdToBinary(bits, leading);
+  }
+  return *exponent <= kIeeeMaxBiasedExponent;
+}
+
+static inline __uint128_t EncodeIeee(bool negative, __uint128_t coefficient,
+                                     int32_t exponent,
+                                     dec128_ieee_encoding_t encoding) {
+  __uint128_t bits = (__uint128_t)negative << 127;
+  if (encoding == DEC128_IEEE_BID) {
+    return bits | ((__uint128_t)exponent << 113) | coefficient;
+  }
+  uint32_t leading;
+  bits |= BinaryToDpd(coefficient, &leading);
+  const uint32_t msbs = (uint32_t)exponent >> 12;
+  const uint32_t combination = leading < 8 ? (msbs << 3) | leading
+                                           : 0x18 | (msbs << 1) | (leading - 8);
+  return bits | ((__uint128_t)combination << 122) |
+         ((__uint128_t)(exponent & 0xFFF) << 110);
+}
+
+static inline decimal_status_t IeeeToDecimal128(ieee_decimal128_t x,
+                                                dec128_ieee_encoding_t encoding,
+                                                int32_t precision,
+                                                int32_t scale,
+                                                decimal128_t *out) {
+  bool negative;
+  __uint128_t c;
+  int32_t exponent;
+  if (!DecodeIeee(x, encoding, &negative, &c, &exponent)) {
+    return DEC128_STATUS_ERROR;
+  }
+  if (c == 0) {
+    *out = (decimal128_t){0};
+    return DEC128_STATUS_SUCCESS;
+  }
+  // power of ten of the coefficient at scale
+  const int32_t k = exponent - kIeeeBias + scale;
+  if (k > 0) {
+    if (k >= precision || c >= UInt128PowerOfTen(precision - k)) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+    c *= UInt128PowerOfTen(k);
+  } else if (k < 0) {
+    __uint128_t remainder;
+    if (-k > kIeeeDigits) {
+      return DEC128_STATUS_RESCALEDATALOSS;
+    }
+    c = UInt128DivideByPowerOfTen(c, -k, &remainder);
+    if (remainder != 0) {
+      return DEC128_STATUS_RESCALEDATALOSS;
+    }
+  }
+  if (c >= UInt128PowerOfTen(precision)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = DecimalFromMagnitude(c, negative);
+  return DEC128_STATUS_SUCCESS;
+}
+
+// Coefficient below 10^34 and biased exponent of v at scale
+static inline bool DecimalToIeeeParts(decimal128_t v, int32_t scale,
+                                      bool *negative, __uint128_t *coefficient,
+                                      int32_t *exponent) {
+  __uint128_t c = DecimalMagnitude(v, negative);
+  int64_t biased = (int64_t)kIeeeBias - scale;
+  while (DEC128_PREDICT_FALSE(c >= UInt128PowerOfTen(kIeeeDigits))) {
+    __uint128_t remainder;
+    const __uint128_t q = UInt128DivideByPowerOfTen(c, 1, &remainder);
+    if (remainder != 0) {
+      return false;
+    }
+    c = q;
+    biased++;
+  }
+  if (biased < 0 || biased > kIeeeMaxBiasedExponent) {
+    return false;
+  }
+  *coefficient = c;
+  *exponent = (int32_t)biased;
+  return true;
+}
+
+decimal_status_t dec128_from_ieee(ieee_decimal128_t x,
+                                  dec128_ieee_encoding_t encoding,
+                                  int32_t precision, int32_t scale,
+                                  decimal128_t *out) {
+  DCHECK_GT(precision, 0);
+  DCHECK_LE(precision, DEC128_MAX_PRECISION);
+  return IeeeToDecimal128(x, encoding, precision, scale, out);
+}
+
+decimal_status_t dec128_to_ieee(decimal128_t v, int32_t scale,
+                                dec128_ieee_encoding_t encoding,
+                                ieee_decimal128_t *out) {
+  bool negative;
+  __uint128_t c;
+  int32_t exponent;
+  if (!DecimalToIeeeParts(v, scale, &negative, &c, &exponent)) {
+    return DEC128_STATUS_OVERFLOW;
+  }
+  *out = IeeeFromBits(EncodeIeee(negative, c, exponent, encoding));
+  return DEC128_STATUS_SUCCESS;
+}
+
+size_t dec128_from_ieee_batch(const ieee_decimal128_t *values, size_t n,
+                              dec128_ieee_encoding_t encoding,
+                              int32_t precision, int32_t scale,
+                              decimal128_t *out, uint8_t *errors) {
+  DCHECK_GT(precision, 0);
+  DCHECK_LE(precision, DEC128_MAX_PRECISION);
+  size_t nerrors = 0;
+  if (errors) {
+    memset(errors, 0, (n + 7) / 8);
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (DEC128_PREDICT_FALSE(IeeeToDecimal128(values[i], encoding, precision,
+                                              scale, &out[i]) !=
+                             DEC128_STATUS_SUCCESS)) {
+      out[i] = (decimal128_t){0};
+      SetError(errors, i);
+      nerrors++;
+    }
+  }
+  return nerrors;
+}
+
+decimal_status_t dec128_to_ieee_batch(const decimal128_t *values, size_t n,
+                                      int32_t scale,
+                                      dec128_ieee_encoding_t encoding,
+                                      ieee_decimal128_t *out) {
+  bool negative;
+  __uint128_t c;
+  int32_t exponent;
+  for (size_t i = 0; i < n; i++) {
+    if (DEC128_PREDICT_FALSE(
+            !DecimalToIeeeParts(values[i], scale, &negative, &c, &exponent))) {
+      return DEC128_STATUS_OVERFLOW;
+    }
+  }
+  for (size_t i = 0; i < n; i++) {
+    DecimalToIeeeParts(values[i], scale, &negative, &c, &exponent);
+    out[i] = IeeeFromBits(EncodeIeee(negative, c, exponent, encoding));
+  }
+  return DEC128_STATUS_SUCCESS;
+}
+
+/* ORC zigzag varints */
+#define kVarintContinuation 0x8080808080808080ULL
+
+static inline uint64_t LoadLittleEndian64(const uint8_t *p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+#if !DEC128_LITTLE_ENDIAN
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+static inline void StoreLittleEndian64(uint8_t *p, uint64_t v) {
+#if !DEC128_LITTLE_ENDIAN
+  v = __builtin_bswap64(v);
+#endif
+  memcpy(p, &v, sizeof(v));
+}
+
+// SWAR spread of z < 2^56 in 7 bit groups, one per byte
+static inline uint64_t SpreadVarint(uint64_t z) {
+  uint64_t x = (z & 0x000000000FFFFFFFULL) | ((z & 0x00FFFFFFF0000000ULL) << 4);
+  x = (x & 0x00003FFF00003FFFULL) | ((x & 0x0FFFC0000FFFC000ULL) << 2);
+  return (x & 0x007F007F007F007FULL) | ((x & 0x3F803F803F803F80ULL) << 1);
+}
+
+// Inverse of SpreadVarint for the 7 bit groups of up to 8 bytes
+static inline uint64_t CompressVarint(uint64_t x) {
+  x &= 0x7F7F7F7F7F7F7F7FULL;
+  x = (x & 0x007F007F007F007FULL) | ((x & 0x7F007F007F007F00ULL) >> 1);
+  x = (x & 0x00003FFF00003FFFULL) | ((x & 0x3FFF00003FFF0000ULL) >> 2);
+  return (x & 0x000000000FFFFFFFULL) | ((x & 0x0FFFFFFF00000000ULL) >> 4);
+}
+
+// Continuation bits of a word holding the last length bytes of a varint
+static inline uint64_t ContinuationBits(size_t length) {
+  return kVarintContinuation & ((1ULL << (8 * (length - 1))) - 1);
+}
+
+// The first length bytes of a word
+static inline uint64_t FirstBytes(uint64_t word, size_t length) {
+  return length < 8 ? word & ((1ULL << (8 * length)) - 1) : word;
+}
+
+#define kVarintWordBits 56
+#define kVarintWordMask ((1ULL << kVarintWordBits) - 1)
+
+static inline size_t EncodeVarint(decimal128_t v, uint8_t *out) {
+  const uint64_t sign = (uint64_t)(dec128_high_bits(v) >> 63);
+  const uint64_t high =
+      (((uint64_t)dec128_high_bits(v) << 1) | (dec128_low_bits(v) >> 63)) ^
+      sign;
+  const uint64_t low = (dec128_low_bits(v) << 1) ^ sign;
+  // out has room for whole words except past the 16th byte
+  if (DEC128_PREDICT_TRUE(high == 0 && low <= kVarintWordMask)) {
+    const size_t length = (size_t)(64 - CountLeadingZerosInt64(low | 1) + 6) / 7;
+    StoreLittleEndian64(out, SpreadVarint(low) | ContinuationBits(length));
+    return length;
+  }
+  const size_t bits = high ? 128 - (size_t)CountLeadingZerosInt64(high)
+                           : 64 - (size_t)CountLeadingZerosInt64(low);
+  const size_t length = (bits + 6) / 7;
+  const __uint128_t z = ((__uint128_t)high << 64) | low;
+  StoreLittleEndian64(out, SpreadVarint(low & kVarintWordMask) |
+                               kVarintContinuation);
+  const uint64_t middle = (uint64_t)(z >> kVarintWordBits) & kVarintWordMask;
+  if (length <= 16) {
+    StoreLittleEndian64(out + 8,
+                        SpreadVarint(middle) | ContinuationBits(length - 8));
+    return length;
+  }
+  StoreLittleEndian64(out + 8, SpreadVarint(middle) | kVarintContinuation);
+  const uint64_t top = SpreadVarint((uint64_t)(z >> (2 * kVarintWordBits))) |
+                       ContinuationBits(length - 16);
+  for (size_t i = 0; i < length - 16; i++) {
+    out[16 + i] = (uint8_t)(top >> (8 * i));
+  }
+  return length;
+}
+
+// Decode a varint at p, returns its length or 0 if invalid
+static inline size_t DecodeVarint(const uint8_t *p, size_t available,
+                                  decimal128_t *out) {
+  __uint128_t z = 0;
+  size_t length;
+  uint64_t stops = 0;
+  if (DEC128_PREDICT_TRUE(available >= 8)) {
+    const uint64_t word = LoadLittleEndian64(p);
+    stops = ~word & kVarintContinuation;
+    if (DEC128_PREDICT_TRUE(stops != 0)) {
+      length = (size_t)__builtin_ctzll(stops) / 8 + 1;
+      z = CompressVarint(FirstBytes(word, length));
+    } else if (available >= 16) {
+      z = CompressVarint(word);
+      const uint64_t word1 = LoadLittleEndian64(p + 8);
+      stops = ~word1 & kVarintContinuation;
+      if (stops != 0) {
+        length = (size_t)__builtin_ctzll(stops) / 8 + 1;
+        z |= (__uint128_t)CompressVarint(FirstBytes(word1, length))
+             << kVarintWordBits;
+        length += 8;
+      } else if (available >= 24) {
+        z |= (__uint128_t)CompressVarint(word1) << kVarintWordBits;
+        const uint64_t word2 = LoadLittleEndian64(p + 16);
+        stops = ~word2 & kVarintContinuation & 0xFFFFFF;
+        if (stops == 0) {
+          return 0;
+        }
+        length = (size_t)__builtin_ctzll(stops) / 8 + 1;
+        // 16 bits are left above the first 112
+        const uint64_t top = CompressVarint(FirstBytes(word2, length));
+        if (top >> 16) {
+          return 0;
+        }
+        z |= (__uint128_t)top << (2 * kVarintWordBits);
+        length += 16;
+      }
+    }
+  }
+  if (DEC128_PREDICT_FALSE(stops == 0)) {
+    // close to the end of the data
+    z = 0;
+    for (length = 0;; length++) {
+      if (length >= available || length >= DEC128_VARINT_MAX_SIZE) {
+        return 0;
+      }
+      const uint8_t byte = p[length];
+      // the last byte holds the top 2 bits
+      if (length == DEC128_VARINT_MAX_SIZE - 1 && byte > 0x03) {
+        return 0;
+      }
+      z |= (__uint128_t)(byte & 0x7F) << (7 * length);
+      if (!(byte & 0x80)) {
+        length++;
+        break;
+      }
+    }
+  }
+  const __uint128_t u = (z >> 1) ^ -(z & 1);
+  *out = dec128_from_int128((__int128)u);
+  return length;
+}
+
+size_t dec128_to_varint_batch(const decimal128_t *values,
+                              const uint8_t *validity, size_t n,
+                              uint8_t *data) {
+  size_t size = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (IsValid(validity, i)) {
+      size += EncodeVarint(values[i], data + size);
+    }
+  }
+  return size;
+}
+
+decimal_status_t dec128_from_varint_batch(const uint8_t *data, size_t size,
+                                          const uint8_t *validity, size_t n,
+                                          decimal128_t *out,
+                                          size_t *consumed) {
+  size_t position = 0;
+  decimal_status_t status = DEC128_STATUS_SUCCESS;
+  for (size_t i = 0; i < n; i++) {
+    out[i] = (decimal128_t){0};
+    if (!IsValid(validity, i)) {
+      continue;
+    }
+    const size_t length =
+        DecodeVarint(data + position, size - position, &out[i]);
+    if (DEC128_PREDICT_FALSE(length == 0)) {
+      memset(out + i, 0, (n - i) * sizeof(decimal128_t));
+      status = DEC128_STATUS_ERROR;
+      break;
+    }
+    position += length;
+  }
+  if (consumed) {
+    *consumed = position;
+  }
+  return status;
+}
@@ -0,0 +1,179 @@
+#ifndef _WIRE_DECIMAL_H_
+#define _WIRE_DECIMAL_H_
+
+#include "decimal/basic_decimal.h"
+
+DEC128_EXTERN_BEGIN
+
+/*
+ * Binary decimal encodings of databases and file formats.
+ *
+ * Batch decoders follow dec128_from_string_batch: row i is
+ * data[offsets[i], offsets[i + 1]), rows that do not decode or do not fit
+ * DECIMAL(precision, scale) are zero and get their bit set in errors (may
+ * be NULL), rows with a 0 validity bit are zero and not errors. They return
+ * the number of errors. Batch encoders fill n + 1 offsets, leave null rows
+ * empty and return the number of bytes used.
+ */
+
+/*
+ * PostgreSQL NUMERIC in binary format (numeric_send/numeric_recv, binary
+ * COPY): int16 ndigits, int16 weight, uint16 sign, uint16 dscale and
+ * ndigits base 10000 digits, all big-endian, the first digit weighing
+ * 10000^weight. NaN and infinities do not decode.
+ */
+#define DEC128_PG_NUMERIC_MAX_SIZE 32
+
+/* The value at scale dscale, its precision counts the whole digits and
+ * dscale like dec128_from_string. DEC128_STATUS_OVERFLOW if it needs more
+ * than DEC128_MAX_PRECISION digits. */
+decimal_status_t dec128_from_pg_numeric(const uint8_t *data, size_t length,
+                                        decimal128_t *out, int32_t *precision,
+                                        int32_t *scale);
+
+/* Encode v of scale (0 to DEC128_MAX_SCALE) with dscale = scale. out must
+ * hold DEC128_PG_NUMERIC_MAX_SIZE bytes, returns the number written. */
+int32_t dec128_to_pg_numeric(decimal128_t v, int32_t scale, uint8_t *out);
+
+size_t dec128_from_pg_numeric_batch(const int32_t *offsets,
+                                    const uint8_t *data,
+                                    const uint8_t *validity, size_t n,
+                                    int32_t precision, int32_t scale,
+                                    decimal128_t *out, uint8_t *errors);
+
+/* data must hold DEC128_PG_NUMERIC_MAX_SIZE * n bytes. */
+size_t dec128_to_pg_numeric_batch(const decimal128_t *values,
+                                  const uint8_t *validity, size_t n,
+                                  int32_t scale, int32_t *offsets,
+                                  uint8_t *data);
+
+/*
+ * MySQL binary DECIMAL (decimal2bin/bin2decimal, row images in InnoDB and
+ * binlogs): the whole and fractional digits in big-endian groups of 9
+ * digits per 4 bytes, leftover digits in 1 to 4 bytes at both ends, every
+ * byte inverted for negative values and the sign bit of the first byte
+ * flipped. The width only depends on precision and scale.
+ */
+#define DEC128_MYSQL_BIN_MAX_SIZE 18
+
+/* Bytes of DECIMAL(precision, scale) values, precision up to
+ * DEC128_MAX_PRECISION. */
+int32_t dec128_mysql_bin_size(int32_t precision, int32_t scale);
+
+/* Read dec128_mysql_bin_size(precision, scale) bytes, DEC128_STATUS_ERROR
+ * if a digit group is out of range. */
+decimal_status_t dec128_from_mysql_bin(const uint8_t *data, int32_t precision,
+                                       int32_t scale, decimal128_t *out);
+
+/* DEC128_STATUS_OVERFLOW and nothing written if v has more than precision
+ * digits. */
+decimal_status_t dec128_to_mysql_bin(decimal128_t v, int32_t precision,
+                                     int32_t scale, uint8_t *out);
+
+/* n values of dec128_mysql_bin_size(precision, scale) bytes each. Invalid
+ * rows are zero and set in errors (may be NULL), returns their count. */
+size_t dec128_from_mysql_bin_batch(const uint8_t *data, size_t n,
+                                   int32_t precision, int32_t scale,
+                                   decimal128_t *out, uint8_t *errors);
+
+/* DEC128_STATUS_OVERFLOW and nothing written if a value does not fit. */
+decimal_status_t dec128_to_mysql_bin_batch(const decimal128_t *values,
+                                           size_t n, int32_t precision,
+                                           int32_t scale, uint8_t *data);
+
+/*
+ * IBM packed decimal (COBOL COMP-3) and zoned decimal (EBCDIC DISPLAY)
+ * fields of byte_length bytes. Packed fields hold two BCD digits per byte
+ * and a sign nibble in the low half of the last byte, 2 * byte_length - 1
+ * digits in all. Zoned fields hold one digit per byte under an 0xF zone,
+ * except the last byte whose zone is the sign. Signs A, C, E and F are
+ * positive, B and D negative; encoders write C and D. The unscaled value is
+ * the digit string, so values keep the implied scale of the field, s in
+ * PIC S9(p)V9(s).
+ *
+ * Decoders set invalid digits or signs and values that do not fit
+ * DEC128_MAX_PRECISION in errors (may be NULL), zero those rows and return
+ * their count. Encoders return DEC128_STATUS_OVERFLOW and write nothing if
+ * a value has more digits than the field.
+ */
+#define DEC128_PACKED_MAX_LENGTH 20
+#define DEC128_ZONED_MAX_LENGTH 39
+
+size_t dec128_from_packed_batch(const uint8_t *data, int32_t byte_length,
+                                size_t n, decimal128_t *out, uint8_t *errors);
+
+decimal_status_t dec128_to_packed_batch(const decimal128_t *values, size_t n,
+                                        int32_t byte_length, uint8_t *data);
+
+size_t dec128_from_zoned_batch(const uint8_t *data, int32_t byte_length,
+                               size_t n, decimal128_t *out, uint8_t *errors);
+
+decimal_status_t dec128_to_zoned_batch(const decimal128_t *values, size_t n,
+                                       int32_t byte_length, uint8_t *data);
+
+/*
+ * IEEE 754-2008 decimal128: a coefficient below 10^34 and an exponent in
+ * [-6176, 6111], with the coefficient in binary (BID, Intel's library and
+ * GCC on x86) or densely packed decimal (DPD, IBM). The bits have the memory
+ * layout of a native 128-bit integer, as _Decimal128 does.
+ */
+typedef struct ieee_decimal128_t {
+  uint64_t array[NWORDS];
+} ieee_decimal128_t;
+
+typedef enum dec128_ieee_encoding_t {
+  DEC128_IEEE_BID = 0,
+  DEC128_IEEE_DPD = 1,
+} dec128_ieee_encoding_t;
+
+/* Convert to DECIMAL(precision, scale). DEC128_STATUS_ERROR for NaN and
+ * infinities, DEC128_STATUS_RESCALEDATALOSS for nonzero digits below scale,
+ * DEC128_STATUS_OVERFLOW for more than precision digits. Non-canonical BID
+ * coefficients read as zero. */
+decimal_status_t dec128_from_ieee(ieee_decimal128_t x,
+                                  dec128_ieee_encoding_t encoding,
+                                  int32_t precision, int32_t scale,
+                                  decimal128_t *out);
+
+/* Exponent -scale, trailing zeros are dropped from coefficients over 34
+ * digits. DEC128_STATUS_OVERFLOW if that does not make the coefficient fit. */
+decimal_status_t dec128_to_ieee(decimal128_t v, int32_t scale,
+                                dec128_ieee_encoding_t encoding,
+                                ieee_decimal128_t *out);
+
+size_t dec128_from_ieee_batch(const ieee_decimal128_t *values, size_t n,
+                              dec128_ieee_encoding_t encoding,
+                              int32_t precision, int32_t scale,
+                              decimal128_t *out, uint8_t *errors);
+
+/* DEC128_STATUS_OVERFLOW and nothing written if a value does not fit. */
+decimal_status_t dec128_to_ieee_batch(const decimal128_t *values, size_t n,
+                                      int32_t scale,
+                                      dec128_ieee_encoding_t encoding,
+                                      ieee_decimal128_t *out);
+
+/*
+ * ORC decimal DATA streams: unscaled values zigzag encoded as base 128
+ * varints (LEB128, low groups first, the high bit of every byte but the last
+ * set), up to DEC128_VARINT_MAX_SIZE bytes. Rows with a 0 validity bit
+ * (may be NULL) are not in the stream, as with ORC's PRESENT stream.
+ */
+#define DEC128_VARINT_MAX_SIZE 19
+
+/* data must hold DEC128_VARINT_MAX_SIZE * n bytes, returns the number
+ * written. */
+size_t dec128_to_varint_batch(const decimal128_t *values,
+                              const uint8_t *validity, size_t n,
+                              uint8_t *data);
+
+/* Decode the values of n rows from size bytes, null rows are zero. Sets
+ * consumed (may be NULL) to the bytes read, DEC128_STATUS_ERROR if the data
+ * ends early or a varint does not fit in 128 bits. */
+decimal_status_t dec128_from_varint_batch(const uint8_t *data, size_t size,
+                                          const uint8_t *validity, size_t n,
+                                          decimal128_t *out,
+                                          size_t *consumed);
+
+DEC128_EXTERN_END
+
+#endif
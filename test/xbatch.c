@@ -0,0 +1,678 @@
+#include "decimal/arrow_decimal.h"
+#include "decimal/batch_decimal.h"
+#include "decimal/hash_groupby.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N 1027
+
+static uint64_t seed = 88172645463325252ULL;
+
+static uint64_t next_random() {
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  return seed;
+}
+
+// mix of small, 64-bit and full 128-bit values of both signs
+static decimal128_t random_decimal() {
+  uint64_t r = next_random();
+  switch (r % 4) {
+  case 0:
+    return dec128_from_int64((int64_t)(next_random() % 100000) - 50000);
+  case 1:
+    return dec128_from_int64((int64_t)next_random());
+  case 2:
+    return dec128_from_hilo(-1, next_random());
+  default:
+    return dec128_from_hilo((int64_t)next_random(), next_random());
+  }
+}
+
+static void count_release(void *owner) { (*(int32_t *)owner)++; }
+
+static int check(const char *name, const decimal128_t *got,
+                 const decimal128_t *expected, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (dec128_cmpne(got[i], expected[i])) {
+      fprintf(stderr, "%s: mismatch at row %zu\n", name, i);
+      return 1;
+    }
+  }
+  printf("%s OK\n", name);
+  return 0;
+}
+
+// expected row of a checked kernel from the exact result, true on error
+static bool checked_row(decimal256_t exact, int32_t precision,
+                        decimal128_t *expected) {
+  if (dec256_to_dec128(exact, expected) != DEC128_STATUS_SUCCESS ||
+      !dec128_fits_in_precision(*expected, precision)) {
+    *expected = dec128_from_int64(0);
+    return true;
+  }
+  return false;
+}
+
+static int check_checked(const char *name, const decimal128_t *got,
+                         const uint8_t *errors, size_t nerrors,
+                         const decimal128_t *expected, const bool *error,
+                         size_t n) {
+  size_t count = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (((errors[i / 8] >> (i % 8)) & 1) != error[i]) {
+      fprintf(stderr, "%s: error bit mismatch at row %zu\n", name, i);
+      return 1;
+    }
+    count += error[i];
+  }
+  if (count != nerrors || (n % 8 && errors[n / 8] >> (n % 8))) {
+    fprintf(stderr, "%s: error count %zu, expected %zu\n", name, nerrors,
+            count);
+    return 1;
+  }
+  return check(name, got, expected, n);
+}
+
+static bool cmp_scalar(dec128_cmp_op_t op, decimal128_t a, decimal128_t b) {
+  switch (op) {
+  case DEC128_CMP_EQ:
+    return dec128_cmpeq(a, b);
+  case DEC128_CMP_NE:
+    return dec128_cmpne(a, b);
+  case DEC128_CMP_LT:
+    return dec128_cmplt(a, b);
+  case DEC128_CMP_LE:
+    return dec128_cmple(a, b);
+  case DEC128_CMP_GT:
+    return dec128_cmpgt(a, b);
+  case DEC128_CMP_GE:
+    return dec128_cmpge(a, b);
+  }
+  return false;
+}
+
+static int check_filter(const char *name, const uint8_t *bitmap,
+                        const uint32_t *sel, size_t nsel, const bool *expected,
+                        size_t n) {
+  size_t k = 0;
+  for (size_t i = 0; i < n; i++) {
+    bool bit = (bitmap[i / 8] >> (i % 8)) & 1;
+    if (bit != expected[i]) {
+      fprintf(stderr, "%s: bitmap mismatch at row %zu\n", name, i);
+      return 1;
+    }
+    if (expected[i] && (k >= nsel || sel[k++] != i)) {
+      fprintf(stderr, "%s: selection mismatch at row %zu\n", name, i);
+      return 1;
+    }
+  }
+  if (k != nsel || (n % 8 && bitmap[n / 8] >> (n % 8))) {
+    fprintf(stderr, "%s: trailing output\n", name);
+    return 1;
+  }
+  printf("%s OK\n", name);
+  return 0;
+}
+
+int main() {
+  static decimal128_t a[N], b[N], out[N], expected[N];
+  int failed = 0;
+
+  for (int i = 0; i < N; i++) {
+    a[i] = random_decimal();
+    b[i] = random_decimal();
+  }
+  decimal128_t c = random_decimal();
+
+  dec128_sum_batch(a, b, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_sum(a[i], b[i]);
+  }
+  failed |= check("sum_batch", out, expected, N);
+
+  dec128_sum_batch_scalar(a, c, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_sum(a[i], c);
+  }
+  failed |= check("sum_batch_scalar", out, expected, N);
+
+  dec128_subtract_batch(a, b, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_subtract(a[i], b[i]);
+  }
+  failed |= check("subtract_batch", out, expected, N);
+
+  dec128_subtract_batch_scalar(a, c, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_subtract(a[i], c);
+  }
+  failed |= check("subtract_batch_scalar", out, expected, N);
+
+  dec128_subtract_scalar_batch(c, b, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_subtract(c, b[i]);
+  }
+  failed |= check("subtract_scalar_batch", out, expected, N);
+
+  dec128_multiply_batch(a, b, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_multiply(a[i], b[i]);
+  }
+  failed |= check("multiply_batch", out, expected, N);
+
+  dec128_multiply_batch_scalar(a, c, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_multiply(a[i], c);
+  }
+  failed |= check("multiply_batch_scalar", out, expected, N);
+
+  dec128_negate_batch(a, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_negate(a[i]);
+  }
+  failed |= check("negate_batch", out, expected, N);
+
+  // in-place
+  memcpy(out, a, sizeof(a));
+  dec128_abs_batch(out, out, N);
+  for (int i = 0; i < N; i++) {
+    expected[i] = dec128_abs(a[i]);
+  }
+  failed |= check("abs_batch", out, expected, N);
+
+  // checked kernels against exact decimal256 results
+  static uint8_t errors[(N + 7) / 8];
+  static bool error[N];
+  size_t nerrors;
+  for (int32_t precision = 18; precision <= 38; precision += 20) {
+    char name[64];
+    const decimal256_t wc = dec256_from_dec128(c);
+    nerrors = dec128_sum_batch_checked(a, b, N, precision, out, errors);
+    for (int i = 0; i < N; i++) {
+      error[i] = checked_row(
+          dec256_sum(dec256_from_dec128(a[i]), dec256_from_dec128(b[i])),
+          precision, &expected[i]);
+    }
+    sprintf(name, "sum_batch_checked(%d)", precision);
+    failed |= check_checked(name, out, errors, nerrors, expected, error, N);
+
+    nerrors = dec128_sum_batch_scalar_checked(a, c, N, precision, out, errors);
+    for (int i = 0; i < N; i++) {
+      error[i] = checked_row(dec256_sum(dec256_from_dec128(a[i]), wc),
+                             precision, &expected[i]);
+    }
+    sprintf(name, "sum_batch_scalar_checked(%d)", precision);
+    failed |= check_checked(name, out, errors, nerrors, expected, error, N);
+
+    nerrors = dec128_subtract_batch_checked(a, b, N, precision, out, errors);
+    for (int i = 0; i < N; i++) {
+      error[i] = checked_row(
+          dec256_subtract(dec256_from_dec128(a[i]), dec256_from_dec128(b[i])),
+          precision, &expected[i]);
+    }
+    sprintf(name, "subtract_batch_checked(%d)", precision);
+    failed |= check_checked(name, out, errors, nerrors, expected, error, N);
+
+    nerrors =
+        dec128_subtract_batch_scalar_checked(a, c, N, precision, out, errors);
+    for (int i = 0; i < N; i++) {
+      error[i] = checked_row(dec256_subtract(dec256_from_dec128(a[i]), wc),
+                             precision, &expected[i]);
+    }
+    sprintf(name, "subtract_batch_scalar_checked(%d)", precision);
+    failed |= check_checked(name, out, errors, nerrors, expected, error, N);
+
+    nerrors =
+        dec128_subtract_scalar_batch_checked(c, b, N, precision, out, errors);
+    for (int i = 0; i < N; i++) {
+      error[i] = checked_row(dec256_subtract(wc, dec256_from_dec128(b[i])),
+                             precision, &expected[i]);
+    }
+    sprintf(name, "subtract_scalar_batch_checked(%d)", precision);
+    failed |= check_checked(name, out, errors, nerrors, expected, error, N);
+
+    nerrors = dec128_multiply_batch_checked(a, b, N, precision, out, errors);
+    for (int i = 0; i < N; i++) {
+      error[i] = checked_row(dec128_multiply_wide(a[i], b[i]), precision,
+                             &expected[i]);
+    }
+    sprintf(name, "multiply_batch_checked(%d)", precision);
+    failed |= check_checked(name, out, errors, nerrors, expected, error, N);
+
+    nerrors = dec128_multiply_batch_scalar_checked(a, b[7], N, precision, out,
+                                                   errors);
+    for (int i = 0; i < N; i++) {
+      error[i] = checked_row(dec128_multiply_wide(a[i], b[7]), precision,
+                             &expected[i]);
+    }
+    sprintf(name, "multiply_batch_scalar_checked(%d)", precision);
+    failed |= check_checked(name, out, errors, nerrors, expected, error, N);
+  }
+
+  // comparisons, with repeated values so the low word compare is exercised
+  static uint8_t bitmap[(N + 7) / 8];
+  static uint32_t sel[N];
+  static bool pass[N];
+  size_t nsel;
+  for (int i = 0; i < N; i++) {
+    if (i % 3 == 0) {
+      b[i] = a[i];
+    } else if (i % 3 == 1) {
+      b[i] = dec128_from_hilo(dec128_high_bits(a[i]), next_random());
+    }
+  }
+  c = a[5];
+  for (int op = DEC128_CMP_EQ; op <= DEC128_CMP_GE; op++) {
+    char name[64];
+    dec128_cmp_batch_bitmap(op, a, b, N, bitmap);
+    nsel = dec128_cmp_batch_sel(op, a, b, N, sel);
+    for (int i = 0; i < N; i++) {
+      pass[i] = cmp_scalar(op, a[i], b[i]);
+    }
+    sprintf(name, "cmp_batch op %d", op);
+    failed |= check_filter(name, bitmap, sel, nsel, pass, N);
+
+    dec128_cmp_batch_scalar_bitmap(op, a, c, N, bitmap);
+    nsel = dec128_cmp_batch_scalar_sel(op, a, c, N, sel);
+    for (int i = 0; i < N; i++) {
+      pass[i] = cmp_scalar(op, a[i], c);
+    }
+    sprintf(name, "cmp_batch_scalar op %d", op);
+    failed |= check_filter(name, bitmap, sel, nsel, pass, N);
+  }
+
+  decimal128_t lo = dec128_from_int64(-20000);
+  decimal128_t hi = dec128_from_int64(INT64_MAX);
+  dec128_between_batch_bitmap(a, lo, hi, N, bitmap);
+  nsel = dec128_between_batch_sel(a, lo, hi, N, sel);
+  for (int i = 0; i < N; i++) {
+    pass[i] = dec128_cmpge(a[i], lo) && dec128_cmple(a[i], hi);
+  }
+  failed |= check_filter("between_batch", bitmap, sel, nsel, pass, N);
+
+  decimal128_t list[] = {a[3], a[100], dec128_from_int64(7), a[N - 1]};
+  const size_t nlist = sizeof(list) / sizeof(list[0]);
+  dec128_in_batch_bitmap(a, list, nlist, N, bitmap);
+  nsel = dec128_in_batch_sel(a, list, nlist, N, sel);
+  for (int i = 0; i < N; i++) {
+    pass[i] = false;
+    for (size_t k = 0; k < nlist; k++) {
+      pass[i] |= dec128_cmpeq(a[i], list[k]);
+    }
+  }
+  failed |= check_filter("in_batch", bitmap, sel, nsel, pass, N);
+
+  // aggregation: the running sum must survive leaving the 128-bit range
+  dec128_agg_t agg, agg2;
+  decimal128_t sum, avg;
+  decimal128_t big = dec128_max(38);
+  for (int i = 0; i < N; i++) {
+    out[i] = (i < N / 2) ? big : dec128_negate(big);
+  }
+  dec128_agg_init(&agg);
+  dec128_agg_update_batch(&agg, out, NULL, N / 2);
+  if (dec128_agg_sum(&agg, 38, &sum) != DEC128_STATUS_OVERFLOW) {
+    fprintf(stderr, "agg_sum: overflow not detected\n");
+    failed = 1;
+  }
+  dec128_agg_init(&agg2);
+  dec128_agg_update_batch(&agg2, out + N / 2, NULL, N - N / 2);
+  dec128_agg_combine(&agg, &agg2);
+  if (dec128_agg_sum(&agg, 38, &sum) != DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(sum, dec128_negate(big)) || agg.count != N ||
+      dec128_cmpne(agg.min, dec128_negate(big)) ||
+      dec128_cmpne(agg.max, big)) {
+    fprintf(stderr, "agg_combine: wrong result\n");
+    failed = 1;
+  }
+  decimal128_t min, max;
+  if (dec128_agg_min(&agg, &min) || dec128_agg_max(&agg, &max) ||
+      dec128_cmpne(min, dec128_negate(big)) || dec128_cmpne(max, big)) {
+    fprintf(stderr, "agg_min/max: wrong result\n");
+    failed = 1;
+  }
+  dec128_agg_init(&agg2);
+  if (dec128_agg_sum(&agg2, 38, &sum) != DEC128_STATUS_ERROR ||
+      dec128_agg_min(&agg2, &min) != DEC128_STATUS_ERROR ||
+      dec128_agg_max(&agg2, &max) != DEC128_STATUS_ERROR) {
+    fprintf(stderr, "agg_sum/min/max: empty group not reported\n");
+    failed = 1;
+  }
+  // -2^126 + -2^126 is INT128_MIN, in 128 bits but not in 38 digits
+  out[0] = out[1] = dec128_from_hilo(-((int64_t)1 << 62), 0);
+  dec128_agg_init(&agg);
+  dec128_agg_update_batch(&agg, out, NULL, 2);
+  if (dec128_agg_sum(&agg, 38, &sum) != DEC128_STATUS_OVERFLOW) {
+    fprintf(stderr, "agg_sum: INT128_MIN not rejected\n");
+    failed = 1;
+  }
+
+  // 1.5 and -1.5 round away from zero
+  for (int i = 0; i < 8; i++) {
+    out[i] = dec128_from_int64(i % 2 ? 2 : 1);
+  }
+  bitmap[0] = 0x0F;
+  dec128_agg_init(&agg);
+  dec128_agg_update_batch(&agg, out, bitmap, 8);
+  dec128_agg_avg(&agg, 0, 10, 0, &avg);
+  failed |= dec128_cmpne(avg, dec128_from_int64(2));
+  dec128_agg_avg(&agg, 0, 10, 2, &avg);
+  failed |= dec128_cmpne(avg, dec128_from_int64(150));
+  dec128_negate_batch(out, out, 8);
+  dec128_agg_init(&agg);
+  dec128_agg_update_batch(&agg, out, bitmap, 8);
+  dec128_agg_avg(&agg, 0, 10, 0, &avg);
+  failed |= dec128_cmpne(avg, dec128_from_int64(-2)) || agg.count != 4;
+  printf("agg %s\n", failed ? "FAILED" : "OK");
+
+  // group by: key i % 97, two aggregated columns, accumulated in two halves
+  // into separate tables that are then merged
+  static decimal128_t keys[N], sums[2 * 97];
+  for (int i = 0; i < N; i++) {
+    keys[i] = dec128_from_hilo(i % 2, (uint64_t)(i % 97));
+    a[i] = dec128_from_int64(i);
+  }
+  const decimal128_t *columns[] = {a, b};
+  dec128_groupby_t *gb = dec128_groupby_create(2, 0);
+  dec128_groupby_t *gb2 = dec128_groupby_create(2, 0);
+  const decimal128_t *columns2[] = {a + N / 2, b + N / 2};
+  bool gb_ok =
+      dec128_groupby_accumulate_batch(gb, keys, columns, NULL, N / 2) ==
+          DEC128_STATUS_SUCCESS &&
+      dec128_groupby_accumulate_batch(gb2, keys + N / 2, columns2, NULL,
+                                      N - N / 2) == DEC128_STATUS_SUCCESS &&
+      dec128_groupby_merge(gb, gb2) == DEC128_STATUS_SUCCESS;
+  size_t ngroups = dec128_groupby_ngroups(gb);
+  const decimal128_t *gkeys = dec128_groupby_keys(gb);
+  const dec128_agg_t *gaggs = dec128_groupby_aggs(gb, 0);
+  gb_ok &= dec128_groupby_finalize_sum(gb, 0, 38, sums, NULL, NULL) == 0 &&
+           ngroups == 194;
+  for (size_t g = 0; g < ngroups && gb_ok; g++) {
+    int64_t expected_sum = 0, expected_count = 0;
+    for (int i = 0; i < N; i++) {
+      if (dec128_cmpeq(keys[i], gkeys[g])) {
+        expected_sum += i;
+        expected_count++;
+      }
+    }
+    gb_ok = dec128_cmpeq(sums[g], dec128_from_int64(expected_sum)) &&
+            gaggs[g].count == expected_count;
+  }
+  dec128_groupby_destroy(gb);
+  dec128_groupby_destroy(gb2);
+
+  // key 2 only has NULL rows, so its SUM is NULL and not an overflow
+  const decimal128_t null_keys[] = {dec128_from_int64(1), dec128_from_int64(2),
+                                    dec128_from_int64(1)};
+  const decimal128_t null_values[] = {dec128_from_int64(5),
+                                      dec128_from_int64(6),
+                                      dec128_from_int64(7)};
+  const decimal128_t *null_columns[] = {null_values};
+  const uint8_t null_bitmap[] = {0x5};
+  const uint8_t *null_validity[] = {null_bitmap};
+  uint8_t sums_validity[1], sums_overflow[1];
+  gb = dec128_groupby_create(1, 0);
+  gb_ok &= dec128_groupby_accumulate_batch(gb, null_keys, null_columns,
+                                           null_validity, 3) ==
+               DEC128_STATUS_SUCCESS &&
+           dec128_groupby_finalize_sum(gb, 0, 38, sums, sums_validity,
+                                       sums_overflow) == 0 &&
+           sums_validity[0] == 0x1 && sums_overflow[0] == 0 &&
+           dec128_cmpeq(sums[0], dec128_from_int64(12)) &&
+           dec128_cmpeq(sums[1], dec128_from_int64(0));
+  dec128_groupby_destroy(gb);
+
+  // far more groups than the initial table holds, so the slots and the
+  // group arrays grow both while accumulating and while merging
+  enum { kGrowRows = 80000, kGrowKeys = 35000 };
+  static decimal128_t grow_keys[kGrowRows], grow_values[kGrowRows];
+  static decimal128_t grow_sums[kGrowKeys];
+  static int64_t ref_sum[kGrowKeys], ref_count[kGrowKeys];
+  for (int i = 0; i < kGrowRows; i++) {
+    // keys 0..19999 in the first half, then 5000..34999 and 0..9999
+    const int64_t k = i < kGrowRows / 2 ? i % 20000 : i % kGrowKeys;
+    grow_keys[i] = dec128_from_int64(k);
+    grow_values[i] = dec128_from_int64(i);
+    ref_sum[k] += i;
+    ref_count[k]++;
+  }
+  gb = dec128_groupby_create(1, 4);
+  gb2 = dec128_groupby_create(1, 4);
+  const decimal128_t *grow_columns[] = {grow_values};
+  const decimal128_t *grow_columns2[] = {grow_values + kGrowRows / 2};
+  gb_ok &= dec128_groupby_accumulate_batch(gb, grow_keys, grow_columns, NULL,
+                                           kGrowRows / 2) ==
+               DEC128_STATUS_SUCCESS &&
+           dec128_groupby_accumulate_batch(gb2, grow_keys + kGrowRows / 2,
+                                           grow_columns2, NULL,
+                                           kGrowRows / 2) ==
+               DEC128_STATUS_SUCCESS &&
+           dec128_groupby_merge(gb, gb2) == DEC128_STATUS_SUCCESS &&
+           dec128_groupby_ngroups(gb) == kGrowKeys &&
+           dec128_groupby_finalize_sum(gb, 0, 38, grow_sums, NULL, NULL) == 0;
+  if (gb_ok) {
+    gkeys = dec128_groupby_keys(gb);
+    gaggs = dec128_groupby_aggs(gb, 0);
+    for (size_t g = 0; g < kGrowKeys && gb_ok; g++) {
+      const int64_t k = dec128_to_int64(gkeys[g]);
+      gb_ok = k >= 0 && k < kGrowKeys &&
+              dec128_cmpeq(grow_sums[g], dec128_from_int64(ref_sum[k])) &&
+              gaggs[g].count == ref_count[k];
+    }
+  }
+  dec128_groupby_destroy(gb);
+  dec128_groupby_destroy(gb2);
+  printf("groupby %s\n", gb_ok ? "OK" : "FAILED");
+  failed |= !gb_ok;
+
+  // string parsing: Arrow utf8 column, expected value at scale 2 or NULL
+  // for an error
+  static const char *strings[][2] = {
+      {"123.45", "12345"},
+      {"-0.5", "-50"},
+      {"1e2", "10000"},
+      {"+7", "700"},
+      {".25", "25"},
+      {"5.", "500"},
+      {"1.2500000000000000000000000000000000000000000", "125"},
+      {"0000000000000000000000000000000000000000000012.3", "1230"},
+      {"-1.5E-1", "-15"},
+      {"12345678901234567890123456789012345678E-2",
+       "12345678901234567890123456789012345678"},
+      {"0e99999999999", "0"},
+      {"", NULL},
+      {"abc", NULL},
+      {"1.234", NULL},
+      {"1e40", NULL},
+      {"12a", NULL},
+      {"-", NULL},
+      {".", NULL},
+      {"1e", NULL},
+      {"1.2.3", NULL},
+      {"1 ", NULL},
+      {"123456789012345678901234567890123456789", NULL},
+  };
+  const size_t nstrings = sizeof(strings) / sizeof(strings[0]);
+  static char data[N * DEC128_MAX_STRLEN];
+  static int32_t offsets[N + 1];
+  offsets[0] = 0;
+  for (size_t i = 0; i < nstrings; i++) {
+    size_t len = strlen(strings[i][0]);
+    memcpy(data + offsets[i], strings[i][0], len);
+    offsets[i + 1] = offsets[i] + (int32_t)len;
+  }
+  nerrors = dec128_from_string_batch(offsets, data, NULL, nstrings, 38, 2,
+                                     out, errors);
+  bool parse_ok = true;
+  size_t expected_errors = 0;
+  for (size_t i = 0; i < nstrings; i++) {
+    bool error = (errors[i / 8] >> (i % 8)) & 1;
+    decimal128_t value = {0};
+    if (strings[i][1]) {
+      dec128_from_string(strings[i][1], &value, NULL, NULL);
+    } else {
+      expected_errors++;
+    }
+    if (error != (strings[i][1] == NULL) || dec128_cmpne(out[i], value)) {
+      fprintf(stderr, "from_string_batch: wrong result for '%s'\n",
+              strings[i][0]);
+      parse_ok = false;
+    }
+  }
+  parse_ok &= nerrors == expected_errors;
+
+  // round trip of random values at scale 10, with nulls
+  for (int i = 0; i < N; i++) {
+    a[i] = dec128_reduce_scale_by(random_decimal(), 1, false);
+    dec128_to_string(a[i], data + offsets[i], 10);
+    offsets[i + 1] = offsets[i] + (int32_t)strlen(data + offsets[i]);
+    bitmap[i / 8] = (uint8_t)next_random();
+  }
+  nerrors =
+      dec128_from_string_batch(offsets, data, bitmap, N, 38, 10, out, errors);
+  for (int i = 0; i < N && parse_ok; i++) {
+    bool valid = (bitmap[i / 8] >> (i % 8)) & 1;
+    parse_ok = dec128_cmpeq(out[i], valid ? a[i] : dec128_from_int64(0)) &&
+               !((errors[i / 8] >> (i % 8)) & 1);
+  }
+  parse_ok &= nerrors == 0;
+  printf("from_string_batch %s\n", parse_ok ? "OK" : "FAILED");
+  failed |= !parse_ok;
+
+  // formatting the same values and nulls, plain and scientific notation
+  static const int32_t format_scales[] = {10, 0, -3, 30};
+  bool format_ok = true;
+  for (size_t k = 0; k < sizeof(format_scales) / sizeof(int32_t); k++) {
+    const int32_t scale = format_scales[k];
+    size_t total = dec128_to_string_batch_length(a, bitmap, N, scale);
+    char *formatted = malloc(total);
+    format_ok &= dec128_to_string_batch(a, bitmap, N, scale, offsets,
+                                        formatted, total) ==
+                     DEC128_STATUS_SUCCESS &&
+                 offsets[N] == (int32_t)total;
+    for (int i = 0; i < N && format_ok; i++) {
+      bool valid = (bitmap[i / 8] >> (i % 8)) & 1;
+      char expected[DEC128_MAX_STRLEN] = "";
+      if (valid) {
+        dec128_to_string(a[i], expected, scale);
+      }
+      format_ok = offsets[i + 1] - offsets[i] == (int32_t)strlen(expected) &&
+                  memcmp(formatted + offsets[i], expected,
+                         strlen(expected)) == 0;
+    }
+    format_ok &= total == 0 ||
+                 dec128_to_string_batch(a, bitmap, N, scale, offsets,
+                                        formatted, total - 1) ==
+                     DEC128_STATUS_ERROR;
+    free(formatted);
+  }
+  printf("to_string_batch %s\n", format_ok ? "OK" : "FAILED");
+  failed |= !format_ok;
+
+  // Arrow C Data Interface round trip, zero copy
+  struct ArrowSchema schema;
+  struct ArrowArray array;
+  const decimal128_t *values;
+  const uint8_t *validity;
+  size_t length;
+  int32_t precision, scale, released = 0;
+  int64_t nulls = 0;
+  for (int i = 0; i < N; i++) {
+    nulls += !((bitmap[i / 8] >> (i % 8)) & 1);
+  }
+  bool arrow_ok =
+      dec128_export_arrow_schema(38, 10, &schema) == DEC128_STATUS_SUCCESS &&
+      strcmp(schema.format, "d:38,10") == 0 &&
+      dec128_export_arrow_array(a, bitmap, N, count_release, &released,
+                                &array) == DEC128_STATUS_SUCCESS &&
+      array.null_count == nulls &&
+      dec128_import_arrow(&schema, &array, &values, &validity, &length,
+                          &precision, &scale) == DEC128_STATUS_SUCCESS &&
+      values == a && validity == bitmap && length == N && precision == 38 &&
+      scale == 10;
+  // a slice, then one whose validity bitmap is not byte aligned
+  array.offset = 16;
+  array.length = N - 16;
+  arrow_ok &= dec128_import_arrow(&schema, &array, &values, &validity,
+                                  &length, NULL, NULL) ==
+                  DEC128_STATUS_SUCCESS &&
+              values == a + 16 && validity == bitmap + 2 && length == N - 16;
+  array.offset = 3;
+  arrow_ok &= dec128_import_arrow(&schema, &array, &values, &validity,
+                                  &length, NULL, NULL) == DEC128_STATUS_ERROR;
+  array.release(&array);
+  schema.release(&schema);
+  arrow_ok &= released == 1 &&
+              dec128_import_arrow(&schema, &array, &values, &validity,
+                                  &length, NULL, NULL) == DEC128_STATUS_ERROR;
+  printf("arrow %s\n", arrow_ok ? "OK" : "FAILED");
+  failed |= !arrow_ok;
+
+  // big-endian two's complement, minimal width and fixed width
+  static const struct {
+    uint8_t bytes[17];
+    int32_t length;
+    int64_t value;
+  } big_endian[] = {
+      {{0x00, 0xFF}, 2, 255},
+      {{0xFF}, 1, -1},
+      {{0x80}, 1, -128},
+      {{0xFF, 0x7F}, 2, -129},
+      {{0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 8, 1LL << 56},
+  };
+  bool big_endian_ok = true;
+  for (size_t k = 0; k < sizeof(big_endian) / sizeof(big_endian[0]); k++) {
+    decimal128_t value;
+    uint8_t bytes[16];
+    big_endian_ok &=
+        dec128_from_big_endian(big_endian[k].bytes, big_endian[k].length,
+                               &value) == DEC128_STATUS_SUCCESS &&
+        dec128_cmpeq(value, dec128_from_int64(big_endian[k].value)) &&
+        dec128_to_big_endian(value, bytes) == big_endian[k].length &&
+        memcmp(bytes, big_endian[k].bytes, big_endian[k].length) == 0;
+  }
+  static uint8_t encoded[16 * N];
+  size_t size = dec128_to_big_endian_batch(a, bitmap, N, offsets, encoded);
+  big_endian_ok &= size == (size_t)offsets[N];
+  nerrors = dec128_from_big_endian_batch(offsets, encoded, bitmap, N, out,
+                                         errors);
+  for (int i = 0; i < N && big_endian_ok; i++) {
+    bool valid = (bitmap[i / 8] >> (i % 8)) & 1;
+    uint8_t bytes[16];
+    big_endian_ok =
+        dec128_cmpeq(out[i], valid ? a[i] : dec128_from_int64(0)) &&
+        offsets[i + 1] - offsets[i] ==
+            (valid ? dec128_to_big_endian(a[i], bytes) : 0);
+  }
+  // null rows are empty and every other length is an error
+  big_endian_ok &= nerrors == 0;
+  nerrors = dec128_from_big_endian_batch(offsets, encoded, NULL, N, out,
+                                         errors);
+  big_endian_ok &= nerrors == (size_t)nulls;
+  // fixed widths, with values that fit in 9 bytes at width 9
+  for (int32_t width = 9; width <= 16; width += 7) {
+    for (int i = 0; i < N; i++) {
+      int64_t high = width == 16 ? dec128_high_bits(a[i])
+                                 : (int8_t)dec128_high_bits(a[i]);
+      expected[i] = dec128_from_hilo(high, dec128_low_bits(a[i]));
+    }
+    big_endian_ok &= dec128_to_big_endian_fixed_batch(expected, N, width,
+                                                      encoded) ==
+                         DEC128_STATUS_SUCCESS &&
+                     dec128_from_big_endian_fixed_batch(encoded, width, N,
+                                                        out) ==
+                         DEC128_STATUS_SUCCESS;
+    failed |= check(width == 16 ? "big_endian_fixed_batch 16"
+                                : "big_endian_fixed_batch 9",
+                    out, expected, N);
+  }
+  big_endian_ok &= dec128_to_big_endian_fixed_batch(a, N, 8, encoded) ==
+                   DEC128_STATUS_OVERFLOW;
+  printf("big_endian_batch %s\n", big_endian_ok ? "OK" : "FAILED");
+  failed |= !big_endian_ok;
+
+  return failed;
+}
@@ -0,0 +1,610 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "decimal/basic_decimal.h"
+#include "decimal/batch_decimal.h"
+#include "decimal/wire_decimal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define N 4096
+#define REPEAT 200
+
+static uint64_t seed = 88172645463325252ULL;
+
+static uint64_t next_random() {
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  return seed;
+}
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// random value with at most precision digits
+static decimal128_t random_decimal(int32_t precision) {
+  decimal128_t v = dec128_from_hilo((int64_t)(next_random() >> 1),
+                                    next_random());
+  decimal128_t whole, fraction;
+  dec128_get_whole_and_fraction(v, precision, &whole, &fraction);
+  return (next_random() & 1) ? dec128_negate(fraction) : fraction;
+}
+
+// DECIMAL(20, 4) / DECIMAL(10, 2) at every result scale
+static void bench_divide_exact() {
+  static decimal128_t a[N], b[N];
+  const int32_t s1 = 4, s2 = 2;
+  for (int i = 0; i < N; i++) {
+    a[i] = random_decimal(20);
+    do {
+      b[i] = random_decimal(10);
+    } while (dec128_cmpeq(b[i], dec128_from_int64(0)));
+  }
+
+  printf("dec128_divide_exact DECIMAL(20,4) / DECIMAL(10,2)\n");
+  printf("%9s %9s %9s\n", "scale", "ns/op", "overflow");
+  for (int32_t scale = 0; scale <= DEC128_MAX_SCALE; scale += 2) {
+    decimal128_t out, check = {0};
+    size_t noverflow = 0;
+    double start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      for (int i = 0; i < N; i++) {
+        if (dec128_divide_exact(a[i], s1, b[i], s2, DEC128_MAX_PRECISION,
+                                scale, &out) == DEC128_STATUS_SUCCESS) {
+          check = dec128_sum(check, out);
+        } else {
+          noverflow++;
+        }
+      }
+    }
+    double elapsed = now() - start;
+    printf("%9d %9.1f %9zu\n", scale, elapsed * 1e9 / (REPEAT * N),
+           noverflow / REPEAT);
+    // keep the results alive
+    if (dec128_low_bits(check) == 42) {
+      printf(" ");
+    }
+  }
+}
+
+// DECIMAL(20, 4) strings, one at a time and as an Arrow utf8 column
+static void bench_from_string() {
+  static char data[N * DEC128_MAX_STRLEN];
+  static int32_t offsets[N + 1];
+  static decimal128_t out[N];
+  static uint8_t errors[(N + 7) / 8];
+  offsets[0] = 0;
+  for (int i = 0; i < N; i++) {
+    dec128_to_string(random_decimal(20), data + offsets[i], 4);
+    offsets[i + 1] = offsets[i] + (int32_t)strlen(data + offsets[i]) + 1;
+  }
+
+  printf("from string DECIMAL(20,4)\n");
+  decimal128_t check = {0};
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      int32_t precision, scale;
+      dec128_from_string(data + offsets[i], &out[i], &precision, &scale);
+      dec128_rescale(out[i], scale, 4, &out[i]);
+      check = dec128_sum(check, out[i]);
+    }
+  }
+  printf("%-24s %9.1f ns/row\n", "dec128_from_string",
+         (now() - start) * 1e9 / (REPEAT * N));
+
+  // the same strings packed without NUL terminators
+  static char packed[N * DEC128_MAX_STRLEN];
+  static int32_t packed_offsets[N + 1];
+  packed_offsets[0] = 0;
+  for (int i = 0; i < N; i++) {
+    int32_t len = offsets[i + 1] - offsets[i] - 1;
+    memcpy(packed + packed_offsets[i], data + offsets[i], len);
+    packed_offsets[i + 1] = packed_offsets[i] + len;
+  }
+  start = now();
+  size_t nerrors = 0;
+  for (int r = 0; r < REPEAT; r++) {
+    nerrors += dec128_from_string_batch(packed_offsets, packed, NULL, N, 20, 4,
+                                        out, errors);
+    check = dec128_sum(check, out[r]);
+  }
+  printf("%-24s %9.1f ns/row %zu errors\n", "dec128_from_string_batch",
+         (now() - start) * 1e9 / (REPEAT * N), nerrors);
+  if (dec128_low_bits(check) == 42) {
+    printf(" ");
+  }
+}
+
+// DECIMAL(20, 4) and DECIMAL(38, 10) values formatted at their scale
+static void bench_to_string() {
+  static decimal128_t values[N];
+  static char buf[DEC128_MAX_STRLEN];
+  const int32_t precisions[] = {20, 38}, scales[] = {4, 10};
+
+  printf("to string\n");
+  for (int k = 0; k < 2; k++) {
+    for (int i = 0; i < N; i++) {
+      values[i] = random_decimal(precisions[k]);
+    }
+    size_t total = 0;
+    double start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      for (int i = 0; i < N; i++) {
+        dec128_to_string(values[i], buf, scales[k]);
+        total += (size_t)buf[1];
+      }
+    }
+    double string_elapsed = now() - start;
+    start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      for (int i = 0; i < N; i++) {
+        total += (size_t)dec128_to_chars(values[i], buf, buf + sizeof(buf),
+                                         scales[k]);
+      }
+    }
+    double chars_elapsed = now() - start;
+    static char data[N * DEC128_MAX_STRLEN];
+    static int32_t offsets[N + 1];
+    start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      size_t size = dec128_to_string_batch_length(values, NULL, N, scales[k]);
+      dec128_to_string_batch(values, NULL, N, scales[k], offsets, data, size);
+      total += (size_t)offsets[N];
+    }
+    double batch_elapsed = now() - start;
+    printf("DECIMAL(%d,%d) %-16s %9.1f ns/row\n", precisions[k], scales[k],
+           "dec128_to_string", string_elapsed * 1e9 / (REPEAT * N));
+    printf("DECIMAL(%d,%d) %-16s %9.1f ns/row\n", precisions[k], scales[k],
+           "dec128_to_chars", chars_elapsed * 1e9 / (REPEAT * N));
+    printf("DECIMAL(%d,%d) %-16s %9.1f ns/row\n", precisions[k], scales[k],
+           "to_string_batch", batch_elapsed * 1e9 / (REPEAT * N));
+    if (total == 42) {
+      printf(" ");
+    }
+  }
+}
+
+// Parquet decimal pages: DECIMAL(38, 10) as FIXED_LEN_BYTE_ARRAY(16) and
+// as minimal width BYTE_ARRAY
+static void bench_big_endian() {
+  static decimal128_t values[N], out[N];
+  static uint8_t data[16 * N];
+  static int32_t offsets[N + 1];
+  for (int i = 0; i < N; i++) {
+    values[i] = random_decimal(next_random() % 38 + 1);
+  }
+
+  printf("big-endian decode\n");
+  dec128_to_big_endian_fixed_batch(values, N, 16, data);
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      dec128_from_big_endian(data + 16 * i, 16, &out[i]);
+    }
+  }
+  printf("%-32s %9.1f ns/row\n", "dec128_from_big_endian 16",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_from_big_endian_fixed_batch(data, 16, N, out);
+  }
+  printf("%-32s %9.1f ns/row\n", "from_big_endian_fixed_batch 16",
+         (now() - start) * 1e9 / (REPEAT * N));
+
+  dec128_to_big_endian_batch(values, NULL, N, offsets, data);
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_from_big_endian_batch(offsets, data, NULL, N, out, NULL);
+  }
+  printf("%-32s %9.1f ns/row %.1f bytes/row\n", "from_big_endian_batch",
+         (now() - start) * 1e9 / (REPEAT * N), (double)offsets[N] / N);
+  if (dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+// PostgreSQL binary COPY of NUMERIC(38, 10)
+static void bench_pg_numeric() {
+  static decimal128_t values[N], out[N];
+  static uint8_t data[DEC128_PG_NUMERIC_MAX_SIZE * N];
+  static int32_t offsets[N + 1];
+  for (int i = 0; i < N; i++) {
+    values[i] = random_decimal(next_random() % 38 + 1);
+  }
+
+  printf("pg numeric\n");
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_to_pg_numeric_batch(values, NULL, N, 10, offsets, data);
+  }
+  printf("%-32s %9.1f ns/row %.1f bytes/row\n", "to_pg_numeric_batch",
+         (now() - start) * 1e9 / (REPEAT * N), (double)offsets[N] / N);
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_from_pg_numeric_batch(offsets, data, NULL, N, 38, 10, out, NULL);
+  }
+  printf("%-32s %9.1f ns/row\n", "from_pg_numeric_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  if (dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+// binlog row images of DECIMAL(30, 12)
+static void bench_mysql_bin() {
+  static decimal128_t values[N], out[N];
+  static uint8_t data[DEC128_MYSQL_BIN_MAX_SIZE * N];
+  for (int i = 0; i < N; i++) {
+    values[i] = random_decimal(30);
+  }
+
+  printf("mysql binary decimal\n");
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_to_mysql_bin_batch(values, N, 30, 12, data);
+  }
+  printf("%-32s %9.1f ns/row\n", "to_mysql_bin_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_from_mysql_bin_batch(data, N, 30, 12, out, NULL);
+  }
+  printf("%-32s %9.1f ns/row\n", "from_mysql_bin_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  if (dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+// COMP-3 PIC S9(15)V9(4) fields, 10 bytes, and zoned 19 byte fields
+static void bench_packed_zoned() {
+  static decimal128_t values[N], out[N];
+  static uint8_t data[19 * N];
+  for (int i = 0; i < N; i++) {
+    values[i] = random_decimal(19);
+  }
+
+  printf("packed and zoned decimal\n");
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_to_packed_batch(values, N, 10, data);
+  }
+  printf("%-32s %9.1f ns/row\n", "to_packed_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_from_packed_batch(data, 10, N, out, NULL);
+  }
+  printf("%-32s %9.1f ns/row\n", "from_packed_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_to_zoned_batch(values, N, 19, data);
+  }
+  printf("%-32s %9.1f ns/row\n", "to_zoned_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_from_zoned_batch(data, 19, N, out, NULL);
+  }
+  printf("%-32s %9.1f ns/row\n", "from_zoned_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  if (dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+// DECIMAL(34, 8) exchanged as IEEE decimal128
+static void bench_ieee() {
+  static decimal128_t values[N], out[N];
+  static ieee_decimal128_t encoded[N];
+  for (int i = 0; i < N; i++) {
+    values[i] = random_decimal(34);
+  }
+
+  printf("ieee decimal128\n");
+  const char *names[] = {"BID", "DPD"};
+  for (int e = 0; e < 2; e++) {
+    const dec128_ieee_encoding_t encoding = e ? DEC128_IEEE_DPD
+                                              : DEC128_IEEE_BID;
+    double start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      dec128_to_ieee_batch(values, N, 8, encoding, encoded);
+    }
+    printf("%s %-28s %9.1f ns/row\n", names[e], "to_ieee_batch",
+           (now() - start) * 1e9 / (REPEAT * N));
+    start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      dec128_from_ieee_batch(encoded, N, encoding, 34, 8, out, NULL);
+    }
+    printf("%s %-28s %9.1f ns/row\n", names[e], "from_ieee_batch",
+           (now() - start) * 1e9 / (REPEAT * N));
+  }
+  if (dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+// ORC decimal DATA streams of small amounts and of any DECIMAL(38)
+static void bench_varint() {
+  static decimal128_t values[N], out[N];
+  static uint8_t data[DEC128_VARINT_MAX_SIZE * N];
+  const int32_t precisions[] = {9, 38};
+
+  printf("zigzag varint\n");
+  for (int k = 0; k < 2; k++) {
+    for (int i = 0; i < N; i++) {
+      values[i] = random_decimal(next_random() % precisions[k] + 1);
+    }
+    size_t size = 0;
+    double start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      size = dec128_to_varint_batch(values, NULL, N, data);
+    }
+    printf("DECIMAL(%d) %-20s %9.1f ns/row %.1f bytes/row\n", precisions[k],
+           "to_varint_batch", (now() - start) * 1e9 / (REPEAT * N),
+           (double)size / N);
+    start = now();
+    for (int r = 0; r < REPEAT; r++) {
+      dec128_from_varint_batch(data, size, NULL, N, out, NULL);
+    }
+    printf("DECIMAL(%d) %-20s %9.1f ns/row\n", precisions[k],
+           "from_varint_batch", (now() - start) * 1e9 / (REPEAT * N));
+  }
+  if (dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+// DECIMAL(18) columns, wrapping against checked kernels
+static void bench_checked() {
+  static decimal128_t a[N], b[N], out[N];
+  static uint8_t errors[(N + 7) / 8];
+  for (int i = 0; i < N; i++) {
+    a[i] = random_decimal(18);
+    b[i] = random_decimal(18);
+  }
+
+  printf("checked kernels DECIMAL(18) op DECIMAL(18)\n");
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_sum_batch(a, b, out, N);
+  }
+  printf("%-30s %9.1f ns/row\n", "sum_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  size_t nerrors = 0;
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    nerrors += dec128_sum_batch_checked(a, b, N, 19, out, errors);
+  }
+  printf("%-30s %9.1f ns/row\n", "sum_batch_checked",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    dec128_multiply_batch(a, b, out, N);
+  }
+  printf("%-30s %9.1f ns/row\n", "multiply_batch",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    nerrors += dec128_multiply_batch_checked(a, b, N, 36, out, errors);
+  }
+  printf("%-30s %9.1f ns/row\n", "multiply_batch_checked",
+         (now() - start) * 1e9 / (REPEAT * N));
+  if (nerrors || dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+// The DCHECK heavy scalar paths, run this and xbench_checked to compare
+static void bench_scalar_ops() {
+  static decimal128_t a[N], b[N];
+  static char strings[N][DEC128_MAX_STRLEN];
+  for (int i = 0; i < N; i++) {
+    a[i] = random_decimal(20);
+    do {
+      b[i] = random_decimal(10);
+    } while (dec128_cmpeq(b[i], dec128_from_int64(0)));
+    dec128_to_string(a[i], strings[i], 4);
+  }
+
+  printf("scalar ops DECIMAL(20,4)\n");
+  decimal128_t check = {0}, out, rem;
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      dec128_rescale(a[i], 4, 6 + (i & 7), &out);
+      check = dec128_sum(check, out);
+    }
+  }
+  printf("%-30s %9.1f ns/op\n", "dec128_rescale",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      out = dec128_reduce_scale_by(a[i], 1 + (i & 7), true);
+      check = dec128_sum(check, out);
+    }
+  }
+  printf("%-30s %9.1f ns/op\n", "dec128_reduce_scale_by",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      dec128_get_whole_and_fraction(a[i], 4, &out, &rem);
+      check = dec128_sum(check, rem);
+    }
+  }
+  printf("%-30s %9.1f ns/op\n", "dec128_get_whole_and_fraction",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      dec128_divide(a[i], b[i], &out, &rem);
+      check = dec128_sum(check, out);
+    }
+  }
+  printf("%-30s %9.1f ns/op\n", "dec128_divide",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      dec128_divide_exact(a[i], 4, b[i], 2, DEC128_MAX_PRECISION, 8, &out);
+      check = dec128_sum(check, out);
+    }
+  }
+  printf("%-30s %9.1f ns/op\n", "dec128_divide_exact",
+         (now() - start) * 1e9 / (REPEAT * N));
+  char buffer[DEC128_MAX_STRLEN];
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      dec128_to_string(a[i], buffer, 4);
+      check.array[0] += (uint8_t)buffer[1];
+    }
+  }
+  printf("%-30s %9.1f ns/op\n", "dec128_to_string",
+         (now() - start) * 1e9 / (REPEAT * N));
+  int32_t precision, scale;
+  start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      dec128_from_string(strings[i], &out, &precision, &scale);
+      check = dec128_sum(check, out);
+    }
+  }
+  printf("%-30s %9.1f ns/op\n", "dec128_from_string",
+         (now() - start) * 1e9 / (REPEAT * N));
+  if (dec128_low_bits(check) == 42) {
+    printf(" ");
+  }
+}
+
+static int compare_decimals(const void *a, const void *b) {
+  const decimal128_t *x = a, *y = b;
+  return dec128_cmplt(*x, *y) ? -1 : dec128_cmpgt(*x, *y);
+}
+
+// Expression loop and sort made of the trivial operations, run this and
+// xbench_inline (built with DEC128_INLINE) to compare
+static void bench_expression() {
+  static decimal128_t a[N], b[N], c[N], out[N];
+  for (int i = 0; i < N; i++) {
+    a[i] = random_decimal(18);
+    b[i] = random_decimal(10);
+    c[i] = random_decimal(28);
+  }
+
+  printf("expression DECIMAL(18) * DECIMAL(10) + DECIMAL(28)\n");
+  const decimal128_t threshold = dec128_from_int64(0);
+  size_t count = 0;
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      out[i] = dec128_abs(dec128_sum(dec128_multiply(out[i], b[i]), c[i]));
+      count += dec128_cmpgt(dec128_subtract(out[i], c[i]), threshold);
+    }
+  }
+  printf("%-30s %9.1f ns/row\n", "abs(a * b + c), a * b + c > 0",
+         (now() - start) * 1e9 / (REPEAT * N));
+  start = now();
+  for (int r = 0; r < REPEAT / 10; r++) {
+    memcpy(out, a, sizeof(a));
+    qsort(out, N, sizeof(out[0]), compare_decimals);
+  }
+  printf("%-30s %9.1f ns/row\n", "qsort",
+         (now() - start) * 1e9 / (REPEAT / 10 * N));
+  if (count == 42 || dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+// Per operation cost of the inline_decimal.h backends, __int128 in
+// xbench_inline and 64-bit words in xbench_words
+#ifndef DEC128_INLINE
+#define BACKEND "out of line"
+#elif DEC128_USE_INT128
+#define BACKEND "inline __int128"
+#else
+#define BACKEND "inline 64-bit words"
+#endif
+
+static void bench_backend() {
+  static decimal128_t a[N], b[N], out[N];
+  for (int i = 0; i < N; i++) {
+    a[i] = random_decimal(38);
+    b[i] = random_decimal(38);
+  }
+
+  printf("backend " BACKEND "\n");
+  size_t count = 0;
+  double start = now();
+  for (int r = 0; r < REPEAT; r++) {
+    for (int i = 0; i < N; i++) {
+      const decimal128_t x = a[(i + r) % N];
+      count += dec128_cmplt(x, b[i]) + dec128_cmpeq(x, b[i]);
+    }
+  }
+  printf("%-30s %9.2f ns/op\n", "dec128_cmplt + dec128_cmpeq",
+         (now() - start) * 1e9 / (REPEAT * N));
+  // every repeat continues from the previous results
+#define BENCH_BACKEND_OP(NAME, EXPR)                                           \
+  memcpy(out, a, sizeof(a));                                                   \
+  start = now();                                                               \
+  for (int r = 0; r < REPEAT; r++) {                                           \
+    for (int i = 0; i < N; i++) {                                              \
+      out[i] = EXPR;                                                           \
+    }                                                                          \
+  }                                                                            \
+  printf("%-30s %9.2f ns/op\n", NAME, (now() - start) * 1e9 / (REPEAT * N));
+  BENCH_BACKEND_OP("dec128_sum", dec128_sum(out[i], b[i]));
+  BENCH_BACKEND_OP("dec128_subtract", dec128_subtract(out[i], b[i]));
+  BENCH_BACKEND_OP("dec128_negate + dec128_sum",
+                   dec128_sum(dec128_negate(out[i]), a[(i + r) % N]));
+  BENCH_BACKEND_OP("dec128_abs + dec128_subtract",
+                   dec128_abs(dec128_subtract(out[i], b[i])));
+  BENCH_BACKEND_OP("dec128_multiply", dec128_multiply(out[i], b[i]));
+#undef BENCH_BACKEND_OP
+  if (count == 42 || dec128_low_bits(out[N - 1]) == 42) {
+    printf(" ");
+  }
+}
+
+static const struct {
+  const char *name;
+  void (*run)(void);
+} benchmarks[] = {
+    {"divide_exact", bench_divide_exact},
+    {"from_string", bench_from_string},
+    {"to_string", bench_to_string},
+    {"big_endian", bench_big_endian},
+    {"pg_numeric", bench_pg_numeric},
+    {"mysql_bin", bench_mysql_bin},
+    {"packed_zoned", bench_packed_zoned},
+    {"ieee", bench_ieee},
+    {"varint", bench_varint},
+    {"checked", bench_checked},
+    {"scalar_ops", bench_scalar_ops},
+    {"expression", bench_expression},
+    {"backend", bench_backend},
+};
+
+// xbench [name...] runs the named benchmarks, all of them by default
+int main(int argc, char **argv) {
+  for (size_t k = 0; k < sizeof(benchmarks) / sizeof(benchmarks[0]); k++) {
+    bool selected = argc < 2;
+    for (int j = 1; j < argc; j++) {
+      selected |= strcmp(argv[j], benchmarks[k].name) == 0;
+    }
+    if (selected) {
+      benchmarks[k].run();
+    }
+  }
+  return 0;
+}
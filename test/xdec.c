@@ -1,4 +1,5 @@
 #include "decimal/basic_decimal.h"
+#include "decimal/narrow_decimal.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -110,6 +111,16 @@ int main() {
   decimal128_t smallint = dec128_from_int64(-123);
   dec128_to_string(smallint, output, 6);
   printf("dec128_to_string %s\n", output);
+  {
+    // no NUL terminator, and nothing useful written when too small
+    char chars[9];
+    if (dec128_to_chars(smallint, chars, chars + 9, 6) != 9 ||
+        memcmp(chars, "-0.000123", 9) != 0 ||
+        dec128_to_chars(smallint, chars, chars + 8, 6) != -1) {
+      printf("dec128_to_chars: wrong result\n");
+      return 1;
+    }
+  }
 
   int precision, scale;
   decimal128_t from;
@@ -121,6 +132,39 @@ int main() {
   s = dec128_from_string("-12345678901234.9876543", &from, &precision, &scale);
   dec128_print(stdout, from, precision, scale);
 
+  printf("from chars\n");
+  {
+    // not NUL terminated, the number stops at the comma
+    const char buf[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9',
+                        '0', '1', '2', '.', '5', '0', 'e', '2', ','};
+    const char *end;
+    s = dec128_from_chars(buf, buf + sizeof(buf), &from, &precision, &scale,
+                          &end);
+    if (s || end != buf + sizeof(buf) - 1 || precision != 14 || scale != 0 ||
+        dec128_cmpne(from, dec128_from_int64(123456789012LL * 100 + 50))) {
+      printf("dec128_from_chars: wrong result\n");
+      return 1;
+    }
+    // the whole range must be consumed without an end pointer
+    if (dec128_from_chars(buf, buf + sizeof(buf), &from, &precision, &scale,
+                          NULL) != DEC128_STATUS_ERROR) {
+      printf("dec128_from_chars: trailing characters accepted\n");
+      return 1;
+    }
+    // 39 significant digits, trailing fractional zeros are dropped
+    const char *big = "123456789012345678901234567890123456789";
+    const char *zeros = "12345678901234567890123456789012345678.000";
+    if (dec128_from_chars(big, big + strlen(big), &from, &precision, &scale,
+                          NULL) != DEC128_STATUS_OVERFLOW ||
+        dec128_from_chars(zeros, zeros + strlen(zeros), &from, &precision,
+                          &scale, NULL) != DEC128_STATUS_SUCCESS ||
+        precision != 38 || scale != 0) {
+      printf("dec128_from_chars: wrong overflow handling\n");
+      return 1;
+    }
+  }
+  printf("OK\n");
+
   printf("from float\n");
   float f = 123.456;
   precision = 10;
@@ -166,13 +210,259 @@ int main() {
   printf("p1 = %d, p2 = %d, p3 = %d, s1 = %d, s2= %d, s3 = %d\n", p1, p2, p3,
          s1, s2, s3);
 
-  div3 = dec128_divide_exact(div1, s1, div2, s2, p3, s3);
+  s = dec128_divide_exact(div1, s1, div2, s2, p3, s3, &div3);
+  if (s) {
+    return 1;
+  }
 
   dec128_print(stdout, div3, p3, s3);
 
+  // precision 38 is valid, but INT128_MIN has 39 digits
+  if (!dec128_fits_in_precision(dec128_max(38), 38) ||
+      !dec128_fits_in_precision(dec128_negate(dec128_max(38)), 38) ||
+      dec128_fits_in_precision(dec128_from_hilo(INT64_MIN, 0), 38)) {
+    printf("fits_in_precision(38) FAILED\n");
+    return 1;
+  }
+
   printf("to_int64\n");
   i64 = dec128_to_int64(div1);
   printf("i64=%ld\n", i64);
 
+  printf("divide by powers of ten\n");
+  decimal128_t pow_values[] = {v1, v2, v3, dec128_max_value(),
+                               dec128_negate(dec128_max_value()),
+                               dec128_from_hilo(INT64_MIN, 0)};
+  for (size_t i = 0; i < sizeof(pow_values) / sizeof(pow_values[0]); i++) {
+    for (int32_t k = 0; k <= DEC128_MAX_SCALE; k++) {
+      decimal128_t q1, r1, q2, r2;
+      dec128_divide(pow_values[i], dec128_get_scale_multiplier(k), &q1, &r1);
+      dec128_get_whole_and_fraction(pow_values[i], k, &q2, &r2);
+      if (dec128_cmpne(q1, q2) || dec128_cmpne(r1, r2)) {
+        printf("get_whole_and_fraction mismatch at k=%d\n", k);
+        return 1;
+      }
+    }
+  }
+  printf("OK\n");
+
+  printf("divide\n");
+  // 64-bit divisor fast path
+  s = dec128_from_string("303138835749319919912165524561313", &div1, &p1, &s1);
+  s |= dec128_from_string("16048036342", &div2, &p2, &s2);
+  s |= dec128_from_string("18889465931477382736859", &v3, &p3, &s3);
+  if (s || dec128_divide(div1, div2, &v1, &v2) || dec128_cmpne(v1, v3) ||
+      dec128_cmpne(v2, dec128_from_int64(8869631535L))) {
+    printf("dec128_divide: wrong result\n");
+    return 1;
+  }
+  printf("OK\n");
+
+  printf("decimal64\n");
+  decimal64_t n1, n2, nq, nr;
+  s = dec64_from_string("-1234567.89", &n1, &p1, &s1);
+  if (s) {
+    return 1;
+  }
+  s = dec64_from_string("12.5", &n2, &p2, &s2);
+  if (s) {
+    return 1;
+  }
+  dec128_MUL_precision_scale(p1, s1, p2, s2, &p3, &s3);
+  decimal128_t wide = dec64_multiply_wide(n1, n2);
+  printf("p3 = %d, s3 = %d\n", p3, s3);
+  dec128_print(stdout, wide, p3, s3);
+  dec64_to_string(dec64_reduce_scale_by(n1, 1, true), output, s1 - 1);
+  printf("dec64_reduce_scale_by %s\n", output);
+  s = dec64_rescale(n2, s2, s1, &n2);
+  if (s || dec64_divide(n1, n2, &nq, &nr)) {
+    return 1;
+  }
+  printf("dec64_divide %ld %ld\n", nq.value, nr.value);
+
+  printf("decimal32\n");
+  decimal32_t m1;
+  s = dec32_from_string("12345678901", &m1, &p1, &s1);
+  if (s != DEC128_STATUS_OVERFLOW) {
+    return 1;
+  }
+  s = dec32_from_string("-99.995", &m1, &p1, &s1);
+  if (s) {
+    return 1;
+  }
+  dec32_to_string(dec32_reduce_scale_by(m1, 2, true), output, s1 - 2);
+  printf("dec32_reduce_scale_by %s\n", output);
+
+  printf("decimal256\n");
+  decimal256_t w1, w2, wq, wr;
+  char output256[DEC256_MAX_STRLEN];
+  // the quotient digit guess is clamped to UINT_MAX in the long division
+  s = dec256_from_string(
+      "6277101734833788281543214670199827537042284396838198369039", &w1, &p1,
+      &s1);
+  s |= dec256_from_string("340282366890966101942926499328444192121", &w2, &p2,
+                          &s2);
+  if (s || dec256_divide(w1, w2, &wq, &wr)) {
+    return 1;
+  }
+  dec256_to_string(wq, output256, 0);
+  printf("dec256_divide %s", output256);
+  dec256_to_string(wr, output256, 0);
+  printf(" rem %s\n", output256);
+  // two 38 digit values multiply exactly into decimal256
+  s = dec128_from_string("99999999999999999999999999999999999999", &v1, &p1,
+                         &s1);
+  if (s) {
+    return 1;
+  }
+  w1 = dec128_multiply_wide(v1, dec128_negate(v1));
+  dec256_to_string(w1, output256, 0);
+  printf("dec128_multiply_wide %s\n", output256);
+  if (dec256_to_dec128(w1, &v2) != DEC128_STATUS_OVERFLOW) {
+    return 1;
+  }
+  s = dec256_from_string("123456789012345678901234567890123456789012.345678",
+                         &w2, &p2, &s2);
+  if (s) {
+    return 1;
+  }
+  printf("p2 = %d, s2 = %d\n", p2, s2);
+  if (dec256_divide(w1, w2, &wq, &wr)) {
+    return 1;
+  }
+  dec256_to_string(wq, output256, 0);
+  printf("dec256_divide %s", output256);
+  dec256_to_string(wr, output256, 0);
+  printf(" rem %s\n", output256);
+  s = dec256_rescale(w2, s2, s2 + 20, &w2);
+  if (s) {
+    return 1;
+  }
+  dec256_to_string(w2, output256, s2 + 20);
+  printf("dec256_rescale %s\n", output256);
+  w2 = dec256_reduce_scale_by(w2, 24, true);
+  dec256_to_string(w2, output256, s2 - 4);
+  printf("dec256_reduce_scale_by %s\n", output256);
+  s = dec256_from_double(-1.5e60, &w1, 76, 10);
+  if (s) {
+    return 1;
+  }
+  dec256_to_string(w1, output256, 10);
+  printf("dec256_from_double %s to_double %g\n", output256,
+         dec256_to_double(w1, 10));
+  if (dec256_to_dec128(dec256_from_dec128(v1), &v2) ||
+      dec128_cmpne(v1, v2)) {
+    return 1;
+  }
+
+  // checked arithmetic at the edges of 128 bits
+  const decimal128_t max128 = dec128_from_hilo(INT64_MAX, UINT64_MAX);
+  const decimal128_t min128 = dec128_from_hilo(INT64_MIN, 0);
+  const decimal128_t one = dec128_from_int64(1);
+  if (dec128_sum_checked(max128, one, &v2) != DEC128_STATUS_OVERFLOW ||
+      dec128_cmpne(v2, min128) ||
+      dec128_sum_checked(min128, max128, &v2) ||
+      dec128_cmpne(v2, dec128_from_int64(-1)) ||
+      dec128_subtract_checked(min128, one, &v2) != DEC128_STATUS_OVERFLOW ||
+      dec128_subtract_checked(dec128_from_int64(-1), max128, &v2) ||
+      dec128_cmpne(v2, min128) ||
+      dec128_negate_checked(min128, &v2) != DEC128_STATUS_OVERFLOW ||
+      dec128_abs_checked(min128, &v2) != DEC128_STATUS_OVERFLOW ||
+      dec128_abs_checked(dec128_negate(max128), &v2) ||
+      dec128_cmpne(v2, max128)) {
+    fprintf(stderr, "checked sum/subtract/negate\n");
+    return 1;
+  }
+  // 2^64 * -2^63 is exactly the smallest value, 2^64 * 2^63 one past it
+  const decimal128_t two64 = dec128_from_hilo(1, 0);
+  const decimal128_t two63 = dec128_from_hilo(0, 1ULL << 63);
+  if (dec128_multiply_checked(two64, dec128_negate(two63), &v2) ||
+      dec128_cmpne(v2, min128) ||
+      dec128_multiply_checked(two64, two63, &v2) != DEC128_STATUS_OVERFLOW ||
+      dec128_cmpne(v2, dec128_multiply(two64, two63)) ||
+      dec128_multiply_checked(two64, two64, &v2) != DEC128_STATUS_OVERFLOW ||
+      dec128_multiply_checked(min128, dec128_from_int64(-1), &v2) !=
+          DEC128_STATUS_OVERFLOW ||
+      dec128_multiply_checked(max128, dec128_from_int64(-1), &v2) ||
+      dec128_cmpne(v2, dec128_negate(max128))) {
+    fprintf(stderr, "checked multiply\n");
+    return 1;
+  }
+  for (int i = 0; i < 1000; i++) {
+    v1 = dec128_from_hilo((int64_t)(i * 0x9E3779B97F4A7C15ULL) >> (i % 64),
+                          i * 0xD1B54A32D192ED03ULL);
+    v2 = dec128_from_hilo((int64_t)(i * 0xC2B2AE3D27D4EB4FULL) >> (i % 61),
+                          i * 0x165667B19E3779F9ULL);
+    decimal128_t product;
+    s = dec128_multiply_checked(v1, v2, &product);
+    const bool fits =
+        dec256_to_dec128(dec128_multiply_wide(v1, v2), &v3) ==
+        DEC128_STATUS_SUCCESS;
+    if ((s == DEC128_STATUS_SUCCESS) != fits ||
+        dec128_cmpne(product, dec128_multiply(v1, v2))) {
+      fprintf(stderr, "checked multiply mismatch at %d\n", i);
+      return 1;
+    }
+  }
+  printf("checked arithmetic OK\n");
+
+  // mod and round without aborting
+  if (dec128_mod_checked(one, 0, dec128_from_int64(0), 2, &v2) !=
+      DEC128_STATUS_DIVIDEDBYZERO) {
+    return 1;
+  }
+  // 10^37 at scale 0 mod 3 at scale 2: 10^39 mod 3 needs 256 bits
+  s = dec128_mod_checked(dec128_get_scale_multiplier(37), 0,
+                         dec128_from_int64(3), 2, &v2);
+  if (s || dec128_cmpne(v2, one)) {
+    fprintf(stderr, "mod_checked wide dividend\n");
+    return 1;
+  }
+  // 1.23 mod 10^37 at scale 0: the scaled divisor is past 128 bits
+  s = dec128_mod_checked(dec128_from_int64(123), 2,
+                         dec128_get_scale_multiplier(37), 0, &v2);
+  if (s || dec128_cmpne(v2, dec128_from_int64(123)) ||
+      dec128_mod_checked(dec128_from_int64(-17), 1, dec128_from_int64(5), 1,
+                         &v2) ||
+      dec128_cmpne(v2, dec128_negate(dec128_from_int64(2))) ||
+      dec128_cmpne(dec128_mod(dec128_from_int64(-17), 1, dec128_from_int64(5),
+                              1),
+                   v2)) {
+    fprintf(stderr, "mod_checked\n");
+    return 1;
+  }
+  if (dec128_round_checked(dec128_from_int64(-1250), 3, 1, &v2) ||
+      dec128_cmpne(v2, dec128_from_int64(-1300)) ||
+      dec128_round_checked(dec128_from_int64(1549), 3, 0, &v2) ||
+      dec128_cmpne(v2, dec128_from_int64(2000)) ||
+      dec128_round_checked(max128, 1, 0, &v2) != DEC128_STATUS_OVERFLOW ||
+      dec128_round_checked(max128, 40, 0, &v2) ||
+      dec128_cmpne(v2, dec128_from_int64(0)) ||
+      dec128_round_checked(one, 2, -1, &v2) != DEC128_STATUS_ERROR) {
+    fprintf(stderr, "round_checked\n");
+    return 1;
+  }
+  printf("mod/round checked OK\n");
+
+  // scale changes validated in every build
+  if (dec128_rescale_checked(one, 0, 39, &v2) != DEC128_STATUS_ERROR ||
+      dec128_rescale_checked(one, INT32_MIN, INT32_MAX, &v2) !=
+          DEC128_STATUS_ERROR ||
+      dec128_rescale_checked(dec128_from_int64(1230), 3, 2, &v2) ||
+      dec128_cmpne(v2, dec128_from_int64(123)) ||
+      dec128_increase_scale_by_checked(one, -1, &v2) != DEC128_STATUS_ERROR ||
+      dec128_increase_scale_by_checked(one, 38, &v2) ||
+      dec128_cmpne(v2, dec128_get_scale_multiplier(38)) ||
+      dec128_increase_scale_by_checked(dec128_from_int64(2), 38, &v2) !=
+          DEC128_STATUS_OVERFLOW ||
+      dec128_reduce_scale_by_checked(one, 39, true, &v2) !=
+          DEC128_STATUS_ERROR ||
+      dec128_reduce_scale_by_checked(dec128_from_int64(-15), 1, true, &v2) ||
+      dec128_cmpne(v2, dec128_from_int64(-2))) {
+    fprintf(stderr, "scale checked\n");
+    return 1;
+  }
+  printf("scale checked OK\n");
+
   return 0;
 }
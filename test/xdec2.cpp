@@ -1,5 +1,165 @@
 #include "decimal/decimal_wrapper.hpp"
 #include <iostream>
+#include <unordered_map>
+
+// compile-time precision and scale
+static_assert(sizeof(Decimal<9, 2>) == sizeof(int32_t), "DECIMAL(9, 2) width");
+static_assert(sizeof(Decimal<18, 2>) == sizeof(int64_t),
+              "DECIMAL(18, 2) width");
+static_assert(sizeof(Decimal<19, 2>) == sizeof(decimal128_t),
+              "DECIMAL(19, 2) width");
+static_assert(std::is_same<decltype(Decimal<7, 2>() + Decimal<5, 3>()),
+                           Decimal<9, 3>>::value,
+              "ADD precision and scale");
+static_assert(std::is_same<decltype(Decimal<7, 2>() * Decimal<5, 3>()),
+                           Decimal<13, 5>>::value,
+              "MUL precision and scale");
+static_assert(std::is_same<decltype(Decimal<7, 2>() / Decimal<5, 3>()),
+                           Decimal<13, 5>>::value,
+              "DIV precision and scale");
+static_assert(std::is_same<decltype(Decimal<7, 2>() % Decimal<5, 3>()),
+                           Decimal<7, 3>>::value,
+              "MOD precision and scale");
+
+static int typed_errors = 0;
+
+static void check_typed(const char *what, const std::string &got,
+                        const std::string &expected) {
+  if (got != expected) {
+    printf("FAILED %s: %s, expected %s\n", what, got.c_str(),
+           expected.c_str());
+    typed_errors++;
+  }
+}
+
+// the typed operators against the runtime precision/scale API
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+static void check_typed_ops(const char *a, const char *b) {
+  Decimal<P1, S1> x;
+  Decimal<P2, S2> y;
+  if (Decimal<P1, S1>::FromString(a, &x) ||
+      Decimal<P2, S2>::FromString(b, &y)) {
+    printf("FAILED FromString(%s, %s)\n", a, b);
+    typed_errors++;
+    return;
+  }
+  const decimal128_t l = x.ToDecimal128().dec, r = y.ToDecimal128().dec;
+  int32_t p, s;
+
+  dec128_ADD_SUB_precision_scale(P1, S1, P2, S2, &p, &s);
+  decimal128_t sum = dec128_sum(dec128_increase_scale_by(l, s - S1),
+                                dec128_increase_scale_by(r, s - S2));
+  decimal128_t diff = dec128_subtract(dec128_increase_scale_by(l, s - S1),
+                                      dec128_increase_scale_by(r, s - S2));
+  check_typed("+", (x + y).ToString(), Decimal128(sum).ToString(s));
+  check_typed("-", (x - y).ToString(), Decimal128(diff).ToString(s));
+  if ((x < y) != dec128_is_negative(diff) ||
+      (x == y) != dec128_cmpeq(diff, dec128_from_int64(0))) {
+    printf("FAILED compare(%s, %s)\n", a, b);
+    typed_errors++;
+  }
+
+  dec128_MUL_precision_scale(P1, S1, P2, S2, &p, &s);
+  check_typed("*", (x * y).ToString(),
+              Decimal128(dec128_multiply(l, r)).ToString(s));
+
+  dec128_DIV_precision_scale(P1, S1, P2, S2, &p, &s);
+  decimal128_t quotient;
+  if (dec128_divide_exact(l, S1, r, S2, p, s, &quotient)) {
+    printf("FAILED dec128_divide_exact(%s, %s)\n", a, b);
+    typed_errors++;
+  } else {
+    check_typed("/", (x / y).ToString(), Decimal128(quotient).ToString(s));
+  }
+
+  dec128_MOD_precision_scale(P1, S1, P2, S2, &p, &s);
+  check_typed("%", (x % y).ToString(),
+              Decimal128(dec128_mod(l, S1, r, S2)).ToString(s));
+}
+
+// operator% alone, for operands whose other results need more than 38
+// digits. expected is the remainder at the result scale, or NULL to compare
+// against dec128_mod, which only works while the scaled operands fit.
+template <int32_t P1, int32_t S1, int32_t P2, int32_t S2>
+static void check_typed_mod(const char *a, const char *b,
+                            const char *expected) {
+  Decimal<P1, S1> x;
+  Decimal<P2, S2> y;
+  if (Decimal<P1, S1>::FromString(a, &x) ||
+      Decimal<P2, S2>::FromString(b, &y)) {
+    printf("FAILED FromString(%s, %s)\n", a, b);
+    typed_errors++;
+    return;
+  }
+  int32_t p, s;
+  dec128_MOD_precision_scale(P1, S1, P2, S2, &p, &s);
+  Decimal128 reference;
+  if (expected) {
+    int32_t expected_precision, expected_scale;
+    Decimal128::FromString(expected, &reference, &expected_precision,
+                           &expected_scale);
+    reference.Rescale(expected_scale, s, &reference);
+  } else {
+    reference = dec128_mod(x.ToDecimal128().dec, S1, y.ToDecimal128().dec, S2);
+  }
+  check_typed("%", (x % y).ToString(), reference.ToString(s));
+}
+
+static int test_typed() {
+  check_typed_ops<7, 2, 5, 3>("12345.67", "12.345");
+  check_typed_ops<7, 2, 5, 3>("-12345.67", "12.345");
+  check_typed_ops<7, 2, 5, 3>("12345.67", "-0.007");
+  check_typed_ops<18, 4, 9, 2>("12345678901234.5678", "-1234567.89");
+  check_typed_ops<12, 2, 20, 6>("-9999999999.99", "99999999999999.999999");
+  check_typed_ops<4, 0, 2, 2>("1", "0.03");
+
+  // 48 digits at the common scale 10, beyond the native path of operator%
+  check_typed_mod<38, 0, 20, 10>("12345678901234567890123456", "1.2345678901",
+                                 NULL);
+  check_typed_mod<38, 0, 20, 10>("-12345678901234567890123456",
+                                 "0.0000000007", NULL);
+  check_typed_mod<38, 0, 20, 10>("99999999999999999999999999999999999999",
+                                 "1234567890.0123456789",
+                                 "307510919.0030761092");
+  check_typed_mod<38, 0, 20, 10>("-99999999999999999999999999999999999999",
+                                 "0.0000000007", "-0.0000000004");
+
+  Decimal<5, 2> a, b;
+  Decimal<9, 4> c;
+  Decimal<5, 2>::FromString("123.45", &a);
+  Decimal<5, 2>::FromString("-0.05", &b);
+  Decimal<9, 4>::FromString("123.4500", &c);
+  check_typed("rescale up", a.Rescale<4>().ToString(), "123.4500");
+  check_typed("rescale down", a.Rescale<1>().ToString(), "123.5");
+  check_typed("rescale down neg", b.Rescale<1>().ToString(), "-0.1");
+  check_typed("rescale carry",
+              Decimal<3, 2>::FromNative(999).Rescale<0>().ToString(), "10");
+  check_typed("negate", (-a).ToString(), "-123.45");
+  check_typed("abs", Abs(b).ToString(), "0.05");
+  // exact widening into a column type
+  Decimal<12, 4> wide = a;
+  check_typed("widen", wide.ToString(), "123.4500");
+  if (!(a == c) || a != c || !(b < a) || !(a >= c) || a > c || !(b <= c)) {
+    printf("FAILED compare\n");
+    typed_errors++;
+  }
+
+  if (Decimal<5, 2>::FromString("1234.5", &a) != DEC128_STATUS_OVERFLOW ||
+      Decimal<5, 2>::FromString("1.234", &a) != DEC128_STATUS_RESCALEDATALOSS) {
+    printf("FAILED FromString status\n");
+    typed_errors++;
+  }
+
+  try {
+    (void)(c / Decimal<5, 2>());
+    printf("FAILED divide by zero\n");
+    typed_errors++;
+  } catch (const std::runtime_error &) {
+  }
+
+  printf("typed decimal: %s\n", typed_errors ? "FAILED" : "OK");
+  return typed_errors;
+}
 
 int main() {
 
@@ -121,5 +281,11 @@ int main() {
 
   std::cout << "zero: " << zero.ToString(0) << std::endl;
 
-  return 0;
+  std::unordered_map<Decimal128, int> counts;
+  counts[d3]++;
+  counts[d4]++;
+  counts[zero]++;
+  std::cout << "distinct: " << counts.size() << std::endl;
+
+  return test_typed() ? 1 : 0;
 }
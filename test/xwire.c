@@ -0,0 +1,696 @@
+#include "decimal/wire_decimal.h"
+#include <stdio.h>
+#include <string.h>
+
+#define N 1027
+
+static uint64_t seed = 88172645463325252ULL;
+
+static uint64_t next_random() {
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  return seed;
+}
+
+// random value with at most precision digits
+static decimal128_t random_decimal(int32_t precision) {
+  decimal128_t v = dec128_from_hilo((int64_t)(next_random() >> 1),
+                                    next_random());
+  decimal128_t whole, fraction;
+  dec128_get_whole_and_fraction(v, precision, &whole, &fraction);
+  return (next_random() & 1) ? dec128_negate(fraction) : fraction;
+}
+
+static int check_bytes(const char *name, const uint8_t *got, int32_t length,
+                       const uint8_t *expected, int32_t expected_length) {
+  if (length != expected_length || memcmp(got, expected, length) != 0) {
+    fprintf(stderr, "%s: got %d bytes, expected %d\n", name, length,
+            expected_length);
+    return 1;
+  }
+  return 0;
+}
+
+static int check_decimals(const char *name, const decimal128_t *got,
+                          const decimal128_t *expected, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (dec128_cmpne(got[i], expected[i])) {
+      if (name) {
+        fprintf(stderr, "%s: mismatch at row %zu\n", name, i);
+      }
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* PostgreSQL NUMERIC */
+typedef struct PgCase {
+  const char *name;
+  int64_t value;
+  int32_t scale;
+  int32_t precision;
+  uint8_t bytes[DEC128_PG_NUMERIC_MAX_SIZE];
+  int32_t length;
+} PgCase;
+
+static int test_pg_numeric() {
+  int failed = 0;
+  // as sent by PostgreSQL for the literals
+  static const PgCase cases[] = {
+      {"12345.678", 12345678, 3, 8,
+       {0, 3, 0, 1, 0, 0, 0, 3, 0x00, 0x01, 0x09, 0x29, 0x1a, 0x7c}, 14},
+      {"-0.0001", -1, 4, 4, {0, 1, 0xff, 0xff, 0x40, 0, 0, 4, 0, 1}, 10},
+      {"0.00", 0, 2, 2, {0, 0, 0, 0, 0, 0, 0, 2}, 8},
+      {"1000000", 1000000, 0, 7, {0, 1, 0, 1, 0, 0, 0, 0, 0, 100}, 10},
+      {"-20000.5", -200005, 1, 6,
+       {0, 3, 0, 1, 0x40, 0, 0, 1, 0, 2, 0, 0, 0x13, 0x88}, 14},
+  };
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    uint8_t buf[DEC128_PG_NUMERIC_MAX_SIZE];
+    int32_t length = dec128_to_pg_numeric(dec128_from_int64(cases[c].value),
+                                          cases[c].scale, buf);
+    failed |= check_bytes(cases[c].name, buf, length, cases[c].bytes,
+                          cases[c].length);
+    decimal128_t v;
+    int32_t precision, scale;
+    if (dec128_from_pg_numeric(cases[c].bytes, cases[c].length, &v,
+                               &precision, &scale) != DEC128_STATUS_SUCCESS ||
+        dec128_cmpne(v, dec128_from_int64(cases[c].value)) ||
+        precision != cases[c].precision || scale != cases[c].scale) {
+      fprintf(stderr, "%s: decoded %lld precision %d scale %d\n",
+              cases[c].name, (long long)dec128_to_int64(v), precision, scale);
+      failed = 1;
+    }
+  }
+
+  // other encoders may keep zero digits, digits hidden by dscale are
+  // truncated like numeric_recv does
+  static const uint8_t padded[] = {0, 4, 0, 1, 0, 0, 0, 1, 0, 0,
+                                   0, 1, 0x16, 0x2e, 0, 0};
+  static const uint8_t hidden[] = {0, 2, 0, 0, 0, 0, 0, 1, 0, 1, 0x16, 0x2e};
+  decimal128_t v;
+  int32_t precision, scale;
+  if (dec128_from_pg_numeric(padded, sizeof(padded), &v, &precision, &scale) !=
+          DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(v, dec128_from_int64(15)) || scale != 1 || precision != 2) {
+    fprintf(stderr, "pg padded digits\n");
+    failed = 1;
+  }
+  if (dec128_from_pg_numeric(hidden, sizeof(hidden), &v, &precision, &scale) !=
+          DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(v, dec128_from_int64(15)) || scale != 1) {
+    fprintf(stderr, "pg hidden digits\n");
+    failed = 1;
+  }
+
+  static const uint8_t nan[] = {0, 0, 0, 0, 0xc0, 0, 0, 0};
+  static const uint8_t bad_digit[] = {0, 1, 0, 0, 0, 0, 0, 0, 0x27, 0x10};
+  static const uint8_t short_digits[] = {0, 2, 0, 0, 0, 0, 0, 0, 0, 1};
+  // 10^38
+  static const uint8_t too_large[] = {0, 1, 0, 9, 0, 0, 0, 0, 0, 100};
+  if (dec128_from_pg_numeric(nan, sizeof(nan), &v, NULL, NULL) !=
+          DEC128_STATUS_ERROR ||
+      dec128_from_pg_numeric(bad_digit, sizeof(bad_digit), &v, NULL, NULL) !=
+          DEC128_STATUS_ERROR ||
+      dec128_from_pg_numeric(short_digits, sizeof(short_digits), &v, NULL,
+                             NULL) != DEC128_STATUS_ERROR ||
+      dec128_from_pg_numeric(too_large, sizeof(too_large), &v, NULL, NULL) !=
+          DEC128_STATUS_OVERFLOW) {
+    fprintf(stderr, "pg invalid input\n");
+    failed = 1;
+  }
+
+  // round trips of full width values at every scale
+  for (int32_t s = 0; s <= DEC128_MAX_SCALE; s++) {
+    for (int i = 0; i < 200; i++) {
+      decimal128_t x = random_decimal(next_random() % 38 + 1);
+      uint8_t buf[DEC128_PG_NUMERIC_MAX_SIZE];
+      int32_t length = dec128_to_pg_numeric(x, s, buf);
+      if (dec128_from_pg_numeric(buf, length, &v, NULL, &scale) !=
+              DEC128_STATUS_SUCCESS ||
+          dec128_cmpne(v, x) || scale != s) {
+        fprintf(stderr, "pg round trip at scale %d\n", s);
+        failed = 1;
+        break;
+      }
+    }
+  }
+
+  static decimal128_t values[N], out[N];
+  static uint8_t data[DEC128_PG_NUMERIC_MAX_SIZE * N];
+  static int32_t offsets[N + 1];
+  static uint8_t validity[(N + 7) / 8], errors[(N + 7) / 8];
+  for (int i = 0; i < N; i++) {
+    values[i] = random_decimal(i % 38 + 1);
+  }
+  memset(validity, 0xff, sizeof(validity));
+  validity[3] = 0x0f;
+  dec128_to_pg_numeric_batch(values, validity, N, 6, offsets, data);
+  size_t nerrors = dec128_from_pg_numeric_batch(offsets, data, validity, N, 38,
+                                                6, out, errors);
+  for (int i = 0; i < N; i++) {
+    const bool valid = (validity[i / 8] >> (i % 8)) & 1;
+    if (valid ? dec128_cmpne(out[i], values[i])
+              : offsets[i] != offsets[i + 1] || dec128_low_bits(out[i])) {
+      fprintf(stderr, "pg batch round trip at row %d\n", i);
+      failed = 1;
+      break;
+    }
+  }
+  // DECIMAL(20, 8) rejects more than 12 whole digits, rescaling adds zeros
+  size_t expected_errors = 0;
+  for (int i = 0; i < N; i++) {
+    decimal128_t whole, fraction;
+    dec128_get_whole_and_fraction(dec128_abs(values[i]), 6, &whole, &fraction);
+    expected_errors += ((validity[i / 8] >> (i % 8)) & 1) &&
+                       dec128_cmpge(whole, dec128_from_int64(1000000000000));
+  }
+  nerrors += dec128_from_pg_numeric_batch(offsets, data, validity, N, 20, 8,
+                                          out, errors);
+  if (nerrors != expected_errors || expected_errors == 0) {
+    fprintf(stderr, "pg batch: %zu errors, expected %zu\n", nerrors,
+            expected_errors);
+    failed = 1;
+  }
+  if (!failed) {
+    printf("pg_numeric OK\n");
+  }
+  return failed;
+}
+
+/* MySQL binary DECIMAL */
+static int test_mysql_bin() {
+  int failed = 0;
+  // DECIMAL(14, 4) examples from the comments of MySQL's decimal.c
+  static const uint8_t positive[] = {0x81, 0x0d, 0xfb, 0x38, 0xd2, 0x04, 0xd2};
+  static const uint8_t negative[] = {0x7e, 0xf2, 0x04, 0xc7, 0x2d, 0xfb, 0x2d};
+  const decimal128_t x = dec128_from_int64(12345678901234);
+  uint8_t buf[DEC128_MYSQL_BIN_MAX_SIZE];
+  decimal128_t v;
+  if (dec128_mysql_bin_size(14, 4) != 7 ||
+      dec128_to_mysql_bin(x, 14, 4, buf) != DEC128_STATUS_SUCCESS) {
+    fprintf(stderr, "mysql size\n");
+    failed = 1;
+  }
+  failed |= check_bytes("mysql 1234567890.1234", buf, 7, positive, 7);
+  dec128_to_mysql_bin(dec128_negate(x), 14, 4, buf);
+  failed |= check_bytes("mysql -1234567890.1234", buf, 7, negative, 7);
+  if (dec128_from_mysql_bin(positive, 14, 4, &v) != DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(v, x) ||
+      dec128_from_mysql_bin(negative, 14, 4, &v) != DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(v, dec128_negate(x))) {
+    fprintf(stderr, "mysql decode\n");
+    failed = 1;
+  }
+
+  // a 10^9 word, 10 in a one digit group, a value over precision
+  static const uint8_t bad_word[] = {0x81, 0x3b, 0x9a, 0xca, 0x00, 0x00, 0x00};
+  static const uint8_t bad_leftover[] = {0x8a, 0, 0, 0, 0, 0, 0};
+  if (dec128_from_mysql_bin(bad_word, 14, 4, &v) != DEC128_STATUS_ERROR ||
+      dec128_from_mysql_bin(bad_leftover, 14, 4, &v) != DEC128_STATUS_ERROR ||
+      dec128_to_mysql_bin(dec128_from_int64(100000000000000), 14, 4, buf) !=
+          DEC128_STATUS_OVERFLOW) {
+    fprintf(stderr, "mysql invalid input\n");
+    failed = 1;
+  }
+
+  // round trips for every precision and scale
+  for (int32_t p = 1; p <= DEC128_MAX_PRECISION && !failed; p++) {
+    for (int32_t s = 0; s <= p; s++) {
+      for (int i = 0; i < 20; i++) {
+        const decimal128_t y = random_decimal(p);
+        if (dec128_to_mysql_bin(y, p, s, buf) != DEC128_STATUS_SUCCESS ||
+            dec128_from_mysql_bin(buf, p, s, &v) != DEC128_STATUS_SUCCESS ||
+            dec128_cmpne(v, y)) {
+          fprintf(stderr, "mysql round trip DECIMAL(%d,%d)\n", p, s);
+          failed = 1;
+          break;
+        }
+      }
+    }
+  }
+
+  static decimal128_t values[N], out[N];
+  static uint8_t data[DEC128_MYSQL_BIN_MAX_SIZE * N];
+  static uint8_t errors[(N + 7) / 8];
+  for (int i = 0; i < N; i++) {
+    values[i] = random_decimal(30);
+  }
+  const int32_t size = dec128_mysql_bin_size(30, 12);
+  if (dec128_to_mysql_bin_batch(values, N, 30, 12, data) !=
+      DEC128_STATUS_SUCCESS) {
+    fprintf(stderr, "mysql batch encode\n");
+    failed = 1;
+  }
+  data[5 * size] = 0xff;
+  size_t nerrors = dec128_from_mysql_bin_batch(data, N, 30, 12, out, errors);
+  for (int i = 0; i < N; i++) {
+    const bool error = (errors[i / 8] >> (i % 8)) & 1;
+    if (error != (i == 5) ||
+        dec128_cmpne(out[i], i == 5 ? dec128_from_int64(0) : values[i])) {
+      fprintf(stderr, "mysql batch round trip at row %d\n", i);
+      failed = 1;
+      break;
+    }
+  }
+  // 10^30 has 31 digits
+  dec128_from_string("1000000000000000000000000000000", &values[7], NULL,
+                     NULL);
+  if (nerrors != 1 || dec128_to_mysql_bin_batch(values, N, 30, 12, data) !=
+                          DEC128_STATUS_OVERFLOW) {
+    fprintf(stderr, "mysql batch errors\n");
+    failed = 1;
+  }
+  if (!failed) {
+    printf("mysql_bin OK\n");
+  }
+  return failed;
+}
+
+/* IBM packed and zoned decimal */
+// byte at a time reference encodings from the decimal digits
+static void reference_packed(decimal128_t v, int32_t length, uint8_t *out) {
+  char digits[DEC128_MAX_STRLEN];
+  dec128_to_integer_string(dec128_abs(v), digits);
+  const int32_t ndigits = (int32_t)strlen(digits);
+  memset(out, 0, length);
+  for (int32_t i = 0; i < ndigits; i++) {
+    // nibble position counted from the sign nibble
+    const int32_t k = ndigits - i;
+    const uint8_t d = (uint8_t)(digits[i] - '0');
+    out[length - 1 - k / 2] |= (uint8_t)(k % 2 ? d << 4 : d);
+  }
+  out[length - 1] |= dec128_high_bits(v) < 0 ? 0x0d : 0x0c;
+}
+
+static void reference_zoned(decimal128_t v, int32_t length, uint8_t *out) {
+  char digits[DEC128_MAX_STRLEN];
+  dec128_to_integer_string(dec128_abs(v), digits);
+  const int32_t ndigits = (int32_t)strlen(digits);
+  memset(out, 0xf0, length);
+  for (int32_t i = 0; i < ndigits; i++) {
+    out[length - ndigits + i] = (uint8_t)(0xf0 | (digits[i] - '0'));
+  }
+  out[length - 1] =
+      (uint8_t)((out[length - 1] & 0x0f) | (dec128_high_bits(v) < 0 ? 0xd0
+                                                                     : 0xc0));
+}
+
+static int test_packed_zoned() {
+  int failed = 0;
+  static const uint8_t packed[] = {0x12, 0x34, 0x5c, 0x12, 0x34, 0x5d,
+                                   0x12, 0x34, 0x5f, 0x00, 0x00, 0x0c};
+  static const uint8_t zoned[] = {0xf0, 0xf1, 0xf2, 0xf3, 0xc4,
+                                  0xf0, 0xf1, 0xf2, 0xf3, 0xd4,
+                                  0xf0, 0xf1, 0xf2, 0xf3, 0xf4};
+  const decimal128_t expected[] = {dec128_from_int64(12345),
+                                   dec128_from_int64(-12345),
+                                   dec128_from_int64(12345),
+                                   dec128_from_int64(0)};
+  const decimal128_t expected_zoned[] = {dec128_from_int64(1234),
+                                         dec128_from_int64(-1234),
+                                         dec128_from_int64(1234)};
+  decimal128_t out[4];
+  uint8_t errors[1];
+  uint8_t buf[3 * 5];
+  if (dec128_from_packed_batch(packed, 3, 4, out, errors) != 0 ||
+      check_decimals("packed decode", out, expected, 4) ||
+      dec128_to_packed_batch(expected, 2, 3, buf) != DEC128_STATUS_SUCCESS ||
+      check_bytes("packed encode", buf, 6, packed, 6) ||
+      dec128_from_zoned_batch(zoned, 5, 3, out, errors) != 0 ||
+      check_decimals("zoned decode", out, expected_zoned, 3) ||
+      dec128_to_zoned_batch(expected_zoned, 2, 5, buf) !=
+          DEC128_STATUS_SUCCESS ||
+      check_bytes("zoned encode", buf, 10, zoned, 10)) {
+    failed = 1;
+  }
+
+  // bad digit, bad sign, 39 digits of packed and zoned
+  static uint8_t bad_packed[4 * 20] = {0x1a, 0x2c, 0, 0, 0x12, 0x34};
+  static uint8_t bad_zoned[4 * 39] = {0xf1, 0xfa, 0xc0, 0, 0, 0,
+                                      0xf1, 0xe2, 0xc3};
+  memset(bad_packed + 40, 0x99, 20);
+  bad_packed[59] = 0x9c;
+  memset(bad_packed + 60, 0x99, 20);
+  bad_packed[60] = 0x09;
+  bad_packed[79] = 0x9c;
+  memset(bad_zoned + 78, 0xf9, 39);
+  memset(bad_zoned + 117, 0xf9, 39);
+  bad_zoned[117] = 0xf0;
+  dec128_from_packed_batch(bad_packed, 2, 2, out, errors);
+  if (errors[0] != 0x3) {
+    fprintf(stderr, "packed bad digit or sign\n");
+    failed = 1;
+  }
+  dec128_from_packed_batch(bad_packed + 40, 20, 2, out, errors);
+  if (errors[0] != 0x1 || dec128_cmpne(out[1], dec128_subtract(
+                                                   dec128_from_hilo(
+                                                       0x4b3b4ca85a86c47a,
+                                                       0x098a224000000000),
+                                                   dec128_from_int64(1)))) {
+    fprintf(stderr, "packed 39 digits\n");
+    failed = 1;
+  }
+  dec128_from_zoned_batch(bad_zoned, 3, 3, out, errors);
+  if (errors[0] != 0x7) {
+    fprintf(stderr, "zoned bad digit or zone\n");
+    failed = 1;
+  }
+  dec128_from_zoned_batch(bad_zoned + 78, 39, 2, out, errors);
+  if (errors[0] != 0x1) {
+    fprintf(stderr, "zoned 39 digits\n");
+    failed = 1;
+  }
+  const decimal128_t thousand = dec128_from_int64(-1000);
+  if (dec128_to_packed_batch(&thousand, 1, 2, buf) !=
+          DEC128_STATUS_OVERFLOW ||
+      dec128_to_zoned_batch(&thousand, 1, 3, buf) != DEC128_STATUS_OVERFLOW) {
+    fprintf(stderr, "packed or zoned overflow\n");
+    failed = 1;
+  }
+  // 10^38 + 1 has 39 digits, one more than a 38 byte zoned field
+  const decimal128_t digits39 =
+      dec128_sum(dec128_increase_scale_by(dec128_from_int64(1), 38),
+                 dec128_from_int64(1));
+  uint8_t zoned38[38];
+  if (dec128_to_zoned_batch(&digits39, 1, 38, zoned38) !=
+      DEC128_STATUS_OVERFLOW) {
+    fprintf(stderr, "zoned 38 bytes overflow\n");
+    failed = 1;
+  }
+
+  // every length against the reference encoders
+  static decimal128_t values[N], decoded[N];
+  static uint8_t data[DEC128_ZONED_MAX_LENGTH * N];
+  static uint8_t errors_n[(N + 7) / 8];
+  for (int32_t length = 1; length <= DEC128_ZONED_MAX_LENGTH; length++) {
+    for (int zoned_format = 0; zoned_format < 2; zoned_format++) {
+      if (!zoned_format && length > DEC128_PACKED_MAX_LENGTH) {
+        continue;
+      }
+      const int32_t digits = zoned_format ? length : 2 * length - 1;
+      for (int i = 0; i < N; i++) {
+        values[i] = random_decimal(digits < 38 ? digits : 38);
+      }
+      size_t nerrors;
+      if (zoned_format) {
+        dec128_to_zoned_batch(values, N, length, data);
+        nerrors = dec128_from_zoned_batch(data, length, N, decoded, errors_n);
+      } else {
+        dec128_to_packed_batch(values, N, length, data);
+        nerrors = dec128_from_packed_batch(data, length, N, decoded, errors_n);
+      }
+      for (int i = 0; i < N; i++) {
+        uint8_t expected_bytes[DEC128_ZONED_MAX_LENGTH];
+        if (zoned_format) {
+          reference_zoned(values[i], length, expected_bytes);
+        } else {
+          reference_packed(values[i], length, expected_bytes);
+        }
+        if (memcmp(data + i * length, expected_bytes, length) != 0) {
+          fprintf(stderr, "%s encode length %d row %d\n",
+                  zoned_format ? "zoned" : "packed", length, i);
+          failed = 1;
+          break;
+        }
+      }
+      if (nerrors != 0 || check_decimals(NULL, decoded, values, N)) {
+        fprintf(stderr, "%s round trip length %d\n",
+                zoned_format ? "zoned" : "packed", length);
+        failed = 1;
+      }
+    }
+  }
+  if (!failed) {
+    printf("packed_zoned OK\n");
+  }
+  return failed;
+}
+
+/* IEEE 754 decimal128 */
+static ieee_decimal128_t ieee(uint64_t high, uint64_t low) {
+  // same memory layout as a native 128-bit integer
+  const decimal128_t bits = dec128_from_hilo((int64_t)high, low);
+  ieee_decimal128_t x;
+  memcpy(&x, &bits, sizeof(x));
+  return x;
+}
+
+static int ieee_equal(ieee_decimal128_t a, ieee_decimal128_t b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static int test_ieee() {
+  int failed = 0;
+  typedef struct IeeeCase {
+    const char *name;
+    dec128_ieee_encoding_t encoding;
+    uint64_t high, low;
+    int32_t scale;
+    const char *value;
+  } IeeeCase;
+  static const IeeeCase cases[] = {
+      {"bid 1", DEC128_IEEE_BID, 0x3040000000000000ULL, 1, 0, "1"},
+      {"bid 123.45", DEC128_IEEE_BID, 0x303c000000000000ULL, 0x3039, 2,
+       "12345"},
+      {"bid -0.001", DEC128_IEEE_BID, 0xb03a000000000000ULL, 1, 3, "-1"},
+      {"dpd 1", DEC128_IEEE_DPD, 0x2208000000000000ULL, 1, 0, "1"},
+      {"dpd 123.45", DEC128_IEEE_DPD, 0x2207800000000000ULL, 0x49c5, 2,
+       "12345"},
+      {"dpd 34 digits", DEC128_IEEE_DPD, 0x6e0337cb0d10e3f5ULL,
+       0x46845ef96322277cULL, 20, "9876543210987654321098765432109876"},
+  };
+  for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+    decimal128_t expected, v;
+    ieee_decimal128_t x;
+    dec128_from_string(cases[c].value, &expected, NULL, NULL);
+    if (dec128_from_ieee(ieee(cases[c].high, cases[c].low), cases[c].encoding,
+                         38, cases[c].scale, &v) != DEC128_STATUS_SUCCESS ||
+        dec128_cmpne(v, expected) ||
+        dec128_to_ieee(expected, cases[c].scale, cases[c].encoding, &x) !=
+            DEC128_STATUS_SUCCESS ||
+        !ieee_equal(x, ieee(cases[c].high, cases[c].low))) {
+      fprintf(stderr, "%s\n", cases[c].name);
+      failed = 1;
+    }
+  }
+
+  // rescaling, overflow, NaN, infinity, largest finite value, BID
+  // coefficient above 10^34 - 1
+  const ieee_decimal128_t x = ieee(0x303c000000000000ULL, 0x3039);
+  decimal128_t v;
+  if (dec128_from_ieee(x, DEC128_IEEE_BID, 38, 5, &v) !=
+          DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(v, dec128_from_int64(12345000)) ||
+      dec128_from_ieee(x, DEC128_IEEE_BID, 38, 1, &v) !=
+          DEC128_STATUS_RESCALEDATALOSS ||
+      dec128_from_ieee(x, DEC128_IEEE_BID, 4, 2, &v) !=
+          DEC128_STATUS_OVERFLOW ||
+      dec128_from_ieee(ieee(0x7c00000000000000ULL, 0), DEC128_IEEE_BID, 38, 0,
+                       &v) != DEC128_STATUS_ERROR ||
+      dec128_from_ieee(ieee(0x7800000000000000ULL, 0), DEC128_IEEE_DPD, 38, 0,
+                       &v) != DEC128_STATUS_ERROR ||
+      dec128_from_ieee(ieee(0x77ffcff3fcff3fcfULL, 0xf3fcff3fcff3fcffULL),
+                       DEC128_IEEE_DPD, 38, 0,
+                       &v) != DEC128_STATUS_OVERFLOW ||
+      dec128_from_ieee(ieee(0x3041ed09bead87c0ULL, 0x378d8e6400000000ULL),
+                       DEC128_IEEE_BID, 38, 0, &v) != DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(v, dec128_from_int64(0))) {
+    fprintf(stderr, "ieee special values\n");
+    failed = 1;
+  }
+
+  // 38 digits only fit with trailing zeros
+  decimal128_t big;
+  ieee_decimal128_t y;
+  dec128_from_string("12345678901234567890123456789012340000", &big, NULL,
+                     NULL);
+  if (dec128_to_ieee(big, 2, DEC128_IEEE_DPD, &y) != DEC128_STATUS_SUCCESS ||
+      dec128_from_ieee(y, DEC128_IEEE_DPD, 38, 2, &v) !=
+          DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(v, big) ||
+      dec128_to_ieee(dec128_sum(big, dec128_from_int64(1)), 2, DEC128_IEEE_BID,
+                     &y) != DEC128_STATUS_OVERFLOW) {
+    fprintf(stderr, "ieee over 34 digits\n");
+    failed = 1;
+  }
+
+  static decimal128_t values[N], out[N];
+  static ieee_decimal128_t encoded[N];
+  for (int e = 0; e < 2; e++) {
+    const dec128_ieee_encoding_t encoding = e ? DEC128_IEEE_DPD
+                                              : DEC128_IEEE_BID;
+    for (int32_t s = 0; s <= 38; s += 2) {
+      for (int i = 0; i < N; i++) {
+        values[i] = random_decimal(i % 34 + 1);
+      }
+      if (dec128_to_ieee_batch(values, N, s, encoding, encoded) !=
+              DEC128_STATUS_SUCCESS ||
+          dec128_from_ieee_batch(encoded, N, encoding, 38, s, out, NULL) != 0 ||
+          check_decimals(NULL, out, values, N)) {
+        fprintf(stderr, "ieee batch round trip encoding %d scale %d\n", e, s);
+        failed = 1;
+      }
+    }
+  }
+
+#if defined(__DEC128_MANT_DIG__) && defined(__DECIMAL_BID_FORMAT__)
+  // against the compiler's own BID arithmetic
+  for (int i = 0; i < N; i++) {
+    const int64_t n = (int64_t)next_random();
+    const int32_t s = (int32_t)(next_random() % 19);
+    _Decimal128 divisor = 1;
+    for (int32_t k = 0; k < s; k++) {
+      divisor *= 10;
+    }
+    const _Decimal128 expected = (_Decimal128)n / divisor;
+    ieee_decimal128_t bits;
+    memcpy(&bits, &expected, sizeof(bits));
+    _Decimal128 encoded_value;
+    if (dec128_from_ieee(bits, DEC128_IEEE_BID, 38, s, &v) !=
+            DEC128_STATUS_SUCCESS ||
+        dec128_cmpne(v, dec128_from_int64(n)) ||
+        dec128_to_ieee(v, s, DEC128_IEEE_BID, &bits) !=
+            DEC128_STATUS_SUCCESS ||
+        (memcpy(&encoded_value, &bits, sizeof(bits)),
+         encoded_value != expected)) {
+      fprintf(stderr, "ieee against _Decimal128 %lld scale %d\n",
+              (long long)n, s);
+      failed = 1;
+      break;
+    }
+  }
+#endif
+  if (!failed) {
+    printf("ieee OK\n");
+  }
+  return failed;
+}
+
+/* ORC zigzag varints */
+// byte at a time reference encoding
+static size_t reference_varint(decimal128_t v, uint8_t *out) {
+  const int64_t high = dec128_high_bits(v);
+  const uint64_t sign = (uint64_t)(high >> 63);
+  uint64_t zh = (((uint64_t)high << 1) | (dec128_low_bits(v) >> 63)) ^ sign;
+  uint64_t zl = (dec128_low_bits(v) << 1) ^ sign;
+  size_t length = 0;
+  while (zh != 0 || zl >= 0x80) {
+    out[length++] = (uint8_t)(zl | 0x80);
+    zl = (zl >> 7) | (zh << 57);
+    zh >>= 7;
+  }
+  out[length++] = (uint8_t)zl;
+  return length;
+}
+
+static int test_varint() {
+  int failed = 0;
+  static const int64_t small[] = {0, -1, 1, 63, -64, 64, 12345};
+  static const uint8_t small_bytes[] = {0x00, 0x01, 0x02, 0x7e, 0x7f,
+                                        0x80, 0x01, 0xf2, 0xc0, 0x01};
+  decimal128_t values[7], out[7];
+  uint8_t buf[DEC128_VARINT_MAX_SIZE * 7];
+  size_t consumed;
+  for (int i = 0; i < 7; i++) {
+    values[i] = dec128_from_int64(small[i]);
+  }
+  size_t size = dec128_to_varint_batch(values, NULL, 7, buf);
+  failed |= check_bytes("varint small", buf, (int32_t)size, small_bytes,
+                        sizeof(small_bytes));
+  if (dec128_from_varint_batch(small_bytes, sizeof(small_bytes), NULL, 7, out,
+                               &consumed) != DEC128_STATUS_SUCCESS ||
+      consumed != sizeof(small_bytes) || check_decimals(NULL, out, values, 7)) {
+    fprintf(stderr, "varint small decode\n");
+    failed = 1;
+  }
+
+  // the smallest 128-bit value takes all 19 bytes
+  static const uint8_t min_bytes[DEC128_VARINT_MAX_SIZE] = {
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x03};
+  values[0] = dec128_from_hilo(INT64_MIN, 0);
+  size = dec128_to_varint_batch(values, NULL, 1, buf);
+  failed |= check_bytes("varint min", buf, (int32_t)size, min_bytes,
+                        sizeof(min_bytes));
+  if (dec128_from_varint_batch(min_bytes, sizeof(min_bytes), NULL, 1, out,
+                               NULL) != DEC128_STATUS_SUCCESS ||
+      dec128_cmpne(out[0], values[0])) {
+    fprintf(stderr, "varint min decode\n");
+    failed = 1;
+  }
+
+  // truncated, over 128 bits, over 19 bytes, with and without padding
+  uint8_t bad[2 * DEC128_VARINT_MAX_SIZE] = {0};
+  memcpy(bad, min_bytes, sizeof(min_bytes));
+  bad[DEC128_VARINT_MAX_SIZE - 1] = 0x04;
+  uint8_t long_bytes[2 * DEC128_VARINT_MAX_SIZE] = {0};
+  memset(long_bytes, 0x80, DEC128_VARINT_MAX_SIZE);
+  if (dec128_from_varint_batch(small_bytes, 6, NULL, 7, out, &consumed) !=
+          DEC128_STATUS_ERROR ||
+      consumed != 5 ||
+      dec128_from_varint_batch(bad, sizeof(min_bytes), NULL, 1, out, NULL) !=
+          DEC128_STATUS_ERROR ||
+      dec128_from_varint_batch(bad, sizeof(bad), NULL, 1, out, NULL) !=
+          DEC128_STATUS_ERROR ||
+      dec128_from_varint_batch(long_bytes, sizeof(min_bytes), NULL, 1, out,
+                               NULL) != DEC128_STATUS_ERROR ||
+      dec128_from_varint_batch(long_bytes, sizeof(long_bytes), NULL, 1, out,
+                               NULL) != DEC128_STATUS_ERROR) {
+    fprintf(stderr, "varint invalid input\n");
+    failed = 1;
+  }
+
+  // a mix of widths against the reference, with nulls
+  static decimal128_t mixed[N], decoded[N];
+  static uint8_t data[DEC128_VARINT_MAX_SIZE * N];
+  static uint8_t expected[DEC128_VARINT_MAX_SIZE * N];
+  static uint8_t validity[(N + 7) / 8];
+  for (int i = 0; i < N; i++) {
+    mixed[i] = random_decimal(next_random() % 38 + 1);
+    if (i % 3 == 0) {
+      mixed[i] = dec128_from_int64((int64_t)next_random() >> (i % 64));
+    }
+  }
+  memset(validity, 0xff, sizeof(validity));
+  validity[5] = 0x5a;
+  size_t expected_size = 0;
+  for (int i = 0; i < N; i++) {
+    if ((validity[i / 8] >> (i % 8)) & 1) {
+      expected_size += reference_varint(mixed[i], expected + expected_size);
+    }
+  }
+  size = dec128_to_varint_batch(mixed, validity, N, data);
+  failed |= check_bytes("varint mixed", data, (int32_t)size, expected,
+                        (int32_t)expected_size);
+  if (dec128_from_varint_batch(data, size, validity, N, decoded, &consumed) !=
+          DEC128_STATUS_SUCCESS ||
+      consumed != size) {
+    fprintf(stderr, "varint mixed decode\n");
+    failed = 1;
+  }
+  for (int i = 0; i < N; i++) {
+    const bool valid = (validity[i / 8] >> (i % 8)) & 1;
+    if (dec128_cmpne(decoded[i], valid ? mixed[i] : dec128_from_int64(0))) {
+      fprintf(stderr, "varint mixed mismatch at row %d\n", i);
+      failed = 1;
+      break;
+    }
+  }
+  if (!failed) {
+    printf("varint OK\n");
+  }
+  return failed;
+}
+
+int main() {
+  int failed = 0;
+  failed |= test_pg_numeric();
+  failed |= test_mysql_bin();
+  failed |= test_packed_zoned();
+  failed |= test_ieee();
+  failed |= test_varint();
+  return failed;
+}